@@ -0,0 +1,183 @@
+#include "asset_registry.h"
+#include "gl_state.h"
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+// ---------------- Asset paths ----------------
+namespace {
+std::vector<std::string> roots = { "", "../", "../../", "../../../" };
+std::unordered_map<std::string, std::string> resolved; // relative path -> resolved ("" if missing)
+}
+
+void setAssetRoots(const std::vector<std::string>& newRoots) {
+    roots = newRoots;
+    resolved.clear();
+}
+
+const std::vector<std::string>& assetRoots() {
+    return roots;
+}
+
+const std::string& resolveAssetPath(const std::string& relativePath) {
+    auto it = resolved.find(relativePath);
+    if (it != resolved.end()) return it->second;
+    std::string found;
+    for (const std::string& root : roots) {
+        std::string candidate = root + relativePath;
+        if (std::ifstream(candidate, std::ios::binary).is_open()) { found = candidate; break; }
+    }
+    return resolved.emplace(relativePath, found).first->second;
+}
+
+// ---------------- Asset registry ----------------
+namespace {
+struct TextureEntry { GLuint id; GLenum target; int refs; };
+struct ModelEntry { Model model; int refs; };
+std::unordered_map<std::string, TextureEntry> textures; // key: resolved path (requested path if missing)
+std::unordered_map<GLuint, std::string> textureKeys;
+std::unordered_map<std::string, ModelEntry> models;
+
+std::string keyFor(const std::string& path) {
+    const std::string& r = resolveAssetPath(path);
+    return r.empty() ? path : r;
+}
+
+size_t textureBytes(GLuint id, GLenum target) {
+    GLenum binding = (target == GL_TEXTURE_2D_ARRAY) ? GL_TEXTURE_BINDING_2D_ARRAY : GL_TEXTURE_BINDING_2D;
+    GLint prev = 0;
+    glGetIntegerv(binding, &prev);
+    glBindTexture(target, id);
+    size_t total = 0;
+    for (int level = 0; level < 16; ++level) {
+        GLint w = 0, h = 0, d = 1, compressed = 0;
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &h);
+        if (w == 0 || h == 0) break;
+        if (target == GL_TEXTURE_2D_ARRAY) glGetTexLevelParameteriv(target, level, GL_TEXTURE_DEPTH, &d); // layers
+        glGetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED, &compressed);
+        if (compressed) {
+            GLint bytes = 0;
+            glGetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &bytes);
+            total += (size_t)bytes;
+        } else {
+            total += (size_t)w * (size_t)h * (size_t)d * 4; // drivers store RGB8 padded to 4 bytes
+        }
+    }
+    glBindTexture(target, (GLuint)prev);
+    return total;
+}
+
+size_t bufferBytes(GLuint buffer) {
+    if (!buffer) return 0;
+    // GL_COPY_READ_BUFFER leaves the array/element bindings (and the bound VAO) untouched
+    GLint size = 0;
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    return (size_t)size;
+}
+
+void destroyModelMeshes(Model& model) {
+    for (Mesh& m : model.meshes) {
+        deleteVertexArrays(1, &m.VAO);
+        glDeleteBuffers(1, &m.VBO);
+        glDeleteBuffers(1, &m.EBO);
+        releaseTexture(m.textureID);
+    }
+    model.meshes.clear();
+}
+} // namespace
+
+GLuint acquireTexture(const std::string& path) {
+    std::string key = keyFor(path);
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        it->second.refs++;
+        return it->second.id;
+    }
+    GLuint id = loadTexture(path.c_str());
+    textures[key] = TextureEntry{ id, GL_TEXTURE_2D, 1 };
+    textureKeys[id] = key;
+    return id;
+}
+
+GLuint acquireTextureArray(const std::vector<std::string>& layerPaths, int layerSize) {
+    // Keyed by the resolved layer list and size, e.g. "array64[Models/grass.png|...]"
+    std::string key = "array" + std::to_string(layerSize) + "[";
+    for (size_t i = 0; i < layerPaths.size(); ++i) key += (i ? "|" : "") + keyFor(layerPaths[i]);
+    key += "]";
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        it->second.refs++;
+        return it->second.id;
+    }
+    GLuint id = loadTextureArray(layerPaths, layerSize);
+    textures[key] = TextureEntry{ id, GL_TEXTURE_2D_ARRAY, 1 };
+    textureKeys[id] = key;
+    return id;
+}
+
+void releaseTexture(GLuint texture) {
+    auto k = textureKeys.find(texture);
+    if (k == textureKeys.end()) return; // not registry-owned
+    auto it = textures.find(k->second);
+    if (--it->second.refs > 0) return;
+    glDeleteTextures(1, &texture);
+    textures.erase(it);
+    textureKeys.erase(k);
+}
+
+Model acquireModel(const std::string& objPath, const std::string& texturePath) {
+    std::string key = keyFor(objPath);
+    auto it = models.find(key);
+    if (it == models.end()) {
+        // loadModel acquires the texture, so textures shared with other users stay deduplicated
+        it = models.emplace(key, ModelEntry{ loadModel(objPath.c_str(), texturePath.c_str()), 0 }).first;
+    }
+    it->second.refs++;
+    return it->second.model;
+}
+
+void releaseModel(const std::string& objPath) {
+    auto it = models.find(keyFor(objPath));
+    if (it == models.end()) return;
+    if (--it->second.refs > 0) return;
+    destroyModelMeshes(it->second.model);
+    models.erase(it);
+}
+
+std::vector<AssetUsage> assetUsage() {
+    std::vector<AssetUsage> out;
+    for (const auto& t : textures) out.push_back(AssetUsage{ t.first, "texture", t.second.refs, textureBytes(t.second.id, t.second.target) });
+    for (const auto& m : models) {
+        size_t bytes = 0;
+        for (const Mesh& mesh : m.second.model.meshes) bytes += bufferBytes(mesh.VBO) + bufferBytes(mesh.EBO);
+        out.push_back(AssetUsage{ m.first, "model", m.second.refs, bytes });
+    }
+    return out;
+}
+
+size_t totalAssetVram() {
+    size_t total = 0;
+    for (const AssetUsage& a : assetUsage()) total += a.vramBytes;
+    return total;
+}
+
+void logAssetUsage() {
+    size_t total = 0;
+    for (const AssetUsage& a : assetUsage()) {
+        std::cout << "[Info] Asset " << a.kind << " " << a.path << ": " << a.refs << " ref(s), "
+                  << (a.vramBytes + 1023) / 1024 << " KiB\n";
+        total += a.vramBytes;
+    }
+    std::cout << "[Info] Asset VRAM total: " << (total + 1023) / 1024 << " KiB\n";
+}
+
+void releaseAllAssets() {
+    for (auto& m : models) destroyModelMeshes(m.second.model);
+    models.clear();
+    for (auto& t : textures) glDeleteTextures(1, &t.second.id);
+    textures.clear();
+    textureKeys.clear();
+}
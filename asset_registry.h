@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "model.h"
+
+// ---------------- Asset paths ----------------
+// Relative asset paths are resolved once against the root list (first root containing the file
+// wins) and the answer, including "not found", is cached, so repeated loads never re-probe.
+// Default roots: "", "../", "../../", "../../../" (running from bin/Debug and similar).
+void setAssetRoots(const std::vector<std::string>& roots); // drops cached resolutions
+const std::vector<std::string>& assetRoots();
+// Resolved path, or "" when no root has the file
+const std::string& resolveAssetPath(const std::string& relativePath);
+
+// ---------------- Asset registry ----------------
+// Shared, ref-counted GL assets keyed by resolved path. Every acquire must be paired with a
+// release of the same handle/path; the GL objects are deleted when the count reaches zero.
+GLuint acquireTexture(const std::string& path);
+// Texture array built by loadTextureArray; shared when the same layer list and size is requested
+GLuint acquireTextureArray(const std::vector<std::string>& layerPaths, int layerSize);
+void releaseTexture(GLuint texture);
+
+// Returns a copy of the shared Model: meshes (GL handles) and bounds are shared, while
+// position/rotation/scale belong to the caller's copy.
+Model acquireModel(const std::string& objPath, const std::string& texturePath);
+void releaseModel(const std::string& objPath);
+
+// Per-asset VRAM estimate, read back from GL (texture levels, buffer sizes)
+struct AssetUsage {
+    std::string path;
+    const char* kind; // "texture" or "model"
+    int refs;
+    size_t vramBytes;
+};
+std::vector<AssetUsage> assetUsage();
+size_t totalAssetVram();
+void logAssetUsage();
+// Deletes every registered asset regardless of ref counts (shutdown)
+void releaseAllAssets();
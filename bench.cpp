@@ -0,0 +1,236 @@
+#include "bench.h"
+#include "vertex_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// ---------------- Options ----------------
+namespace {
+bool parseInt(const std::string& s, int& out, int minV, int maxV) {
+    try {
+        size_t used = 0;
+        int v = std::stoi(s, &used);
+        if (used != s.size() || v < minV || v > maxV) return false;
+        out = v;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// One option by name (no leading dashes). value is the following argument or the right-hand
+// side of a config line (null if none); consumed reports whether it was used.
+bool applyOption(const std::string& key, const std::string* value, bool& consumed, BenchConfig& cfg) {
+    consumed = false;
+    struct IntOption { const char* name; int* target; int minV, maxV; };
+    const IntOption ints[] = {
+        {"frames", &cfg.frames, 1, 1000000},
+        {"warmup", &cfg.warmup, 0, 100000},
+        {"seed", &cfg.seed, 0, 999999},
+        {"small", &cfg.smallTrees, 0, 50},
+        {"medium", &cfg.mediumTrees, 0, 50},
+        {"tall", &cfg.tallTrees, 0, 50},
+        {"paths", &cfg.paths, 1, 12},
+        {"fountain-radius", &cfg.fountainRadius, 20, 200},
+        {"fireflies", &cfg.fireflies, 0, 10000},
+        {"chunk-budget", &cfg.chunkBudgetKB, 64, 1048576},
+        {"fps-cap", &cfg.fpsCap, 0, 1000},
+        {"shadow-size", &cfg.shadowSize, 256, 4096},
+    };
+    for (const IntOption& o : ints) {
+        if (key != o.name) continue;
+        if (!value || !parseInt(*value, *o.target, o.minV, o.maxV)) {
+            std::cout << "[Guard] Bench option " << key << " needs an integer in " << o.minV << "-" << o.maxV << "\n";
+            return false;
+        }
+        consumed = true;
+        return true;
+    }
+    if (key == "bench")     { cfg.enabled = true; return true; }
+    if (key == "vsync")     { cfg.vsync = true; return true; }
+    if (key == "adaptive-vsync") { cfg.adaptiveVsync = true; return true; }
+    if (key == "offscreen") { cfg.offscreen = true; return true; }
+    if (key == "no-batch")  { cfg.noBatch = true; return true; }
+    if (key == "depth-prepass") { cfg.depthPrepass = true; return true; }
+    if (key == "unsorted")  { cfg.unsorted = true; return true; }
+    if (key == "world-chunks") { cfg.worldChunks = true; return true; }
+    if (key == "no-lod")    { cfg.noLod = true; return true; }
+    if (key == "no-shadows") { cfg.noShadows = true; return true; }
+    if (key == "shadow-every-frame") { cfg.shadowEveryFrame = true; return true; }
+    if (key == "vertex-format") {
+        VertexFormat fmt;
+        if (!value || !parseVertexFormat(*value, fmt)) {
+            std::cout << "[Guard] Bench option vertex-format needs full, compact or half\n";
+            return false;
+        }
+        consumed = true;
+        cfg.vertexFormat = *value;
+        return true;
+    }
+    if (key == "csv" || key == "config" || key == "scene") {
+        if (!value || value->empty()) { std::cout << "[Guard] Bench option " << key << " needs a path\n"; return false; }
+        consumed = true;
+        if (key == "csv") { cfg.csvPath = *value; return true; }
+        if (key == "scene") { cfg.scenePath = *value; return true; }
+        return loadBenchConfigFile(*value, cfg);
+    }
+    std::cout << "[Guard] Unknown bench option: " << key << "\n";
+    return false;
+}
+} // namespace
+
+bool parseBenchArgs(int argc, char** argv, BenchConfig& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) != 0) {
+            std::cout << "[Guard] Unexpected argument: " << argv[i] << "\n";
+            return false;
+        }
+        std::string key = argv[i] + 2;
+        std::string next = (i + 1 < argc) ? argv[i + 1] : "";
+        bool consumed = false;
+        if (!applyOption(key, (i + 1 < argc) ? &next : nullptr, consumed, cfg)) return false;
+        if (consumed) ++i;
+    }
+    return true;
+}
+
+bool loadBenchConfigFile(const std::string& path, BenchConfig& cfg) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "[Guard] Could not open bench config " << path << "\n";
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+        size_t eq = line.find('=');
+        std::string key = line.substr(start, eq == std::string::npos ? std::string::npos : eq - start);
+        key.erase(key.find_last_not_of(" \t") + 1);
+        std::string value;
+        if (eq != std::string::npos) {
+            value = line.substr(eq + 1);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t") + 1);
+        }
+        // "vsync=1" style flags: a false-ish value leaves the flag unset
+        if (key == "bench" || key == "vsync" || key == "adaptive-vsync" || key == "offscreen" || key == "no-batch" ||
+            key == "depth-prepass" || key == "unsorted" || key == "world-chunks" || key == "no-lod" ||
+            key == "no-shadows" || key == "shadow-every-frame") {
+            if (value == "0" || value == "false") continue;
+            value.clear();
+        }
+        bool consumed = false;
+        if (!applyOption(key, value.empty() ? nullptr : &value, consumed, cfg)) return false;
+    }
+    return true;
+}
+
+FramePacing benchPacing(const BenchConfig& cfg) {
+    if (cfg.adaptiveVsync) return PACING_ADAPTIVE_VSYNC;
+    if (cfg.vsync) return PACING_VSYNC;
+    return cfg.fpsCap > 0 ? PACING_CAPPED : PACING_UNCAPPED;
+}
+
+// ---------------- Camera spline ----------------
+namespace {
+// Closed loop around the fountain: weaves between the hedge ring and the outer forest, dipping
+// low and rising for an overview, so every scope gets both near and far views.
+const glm::vec3 kSplinePoints[] = {
+    { 0.0f, 2.0f, 10.0f}, { 6.5f, 1.4f, 6.5f}, { 9.0f, 3.5f, 0.0f}, { 5.0f, 1.2f, -5.0f},
+    { 0.0f, 5.0f, -8.5f}, {-6.0f, 1.6f, -6.0f}, {-9.0f, 2.5f, 0.0f}, {-4.5f, 1.3f, 4.5f},
+};
+const int kSplineCount = (int)(sizeof(kSplinePoints) / sizeof(kSplinePoints[0]));
+
+glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float u) {
+    float u2 = u * u, u3 = u2 * u;
+    return 0.5f * ((2.0f * p1) + (-p0 + p2) * u + (2.0f*p0 - 5.0f*p1 + 4.0f*p2 - p3) * u2 + (-p0 + 3.0f*p1 - 3.0f*p2 + p3) * u3);
+}
+
+glm::vec3 splinePoint(float t) {
+    float s = (t - std::floor(t)) * kSplineCount;
+    int i = (int)s;
+    float u = s - i;
+    auto at = [](int k){ return kSplinePoints[((k % kSplineCount) + kSplineCount) % kSplineCount]; };
+    return catmullRom(at(i - 1), at(i), at(i + 1), at(i + 2), u);
+}
+} // namespace
+
+CameraPose benchCameraAt(float t) {
+    CameraPose pose;
+    pose.position = splinePoint(t);
+    // Look half-way between a point further along the loop and the fountain
+    glm::vec3 ahead = splinePoint(t + 0.03f);
+    glm::vec3 target = 0.5f * (ahead + glm::vec3(0.0f, 0.8f, 0.0f));
+    pose.front = glm::normalize(target - pose.position);
+    return pose;
+}
+
+// ---------------- Run statistics ----------------
+float BenchRun::splineParam() const {
+    int measured = std::max(0, frame - cfg.warmup);
+    return (float)measured / (float)std::max(1, cfg.frames);
+}
+
+void BenchRun::recordFrame(double ms) {
+    if (measuring()) {
+        frameMs.push_back(ms);
+        // The profiler resolves GPU times a couple of frames late; take each resolved frame once
+        const ProfileFrame& p = profilerLatestFrame();
+        if (p.index != lastProfileIndex && p.index >= (unsigned long long)cfg.warmup) {
+            lastProfileIndex = p.index;
+            resolvedFrames++;
+            for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+                const ProfileSample& sm = p.scopes[s];
+                if (!sm.ran) continue;
+                scopeCpuMs[s] += sm.cpuMs;
+                scopeGpuMs[s] += sm.gpuMs;
+                scopeDraws[s] += sm.drawCalls;
+                scopeUniforms[s] += sm.uniformUploads;
+                scopeStates[s] += sm.stateChanges;
+                scopeFrames[s]++;
+            }
+        }
+    }
+    frame++;
+}
+
+void BenchRun::report() const {
+    if (frameMs.empty()) { std::cout << "[Bench] No frames measured\n"; return; }
+    std::vector<double> sorted(frameMs);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) sum += v;
+    double avg = sum / sorted.size();
+    size_t p99Index = (size_t)std::ceil(0.99 * sorted.size()) - 1;
+    std::string pacingName = pacing == PACING_CAPPED ? "capped " + std::to_string(cfg.fpsCap) + " fps" : framePacingName(pacing);
+    std::cout << "[Bench] " << sorted.size() << " frames (seed " << cfg.seed << ", " << pacingName
+              << (cfg.offscreen ? ", offscreen" : "") << (cfg.noBatch ? ", unbatched" : "")
+              << (cfg.unsorted ? ", unsorted" : "") << (cfg.depthPrepass ? ", depth pre-pass" : "")
+              << (cfg.worldChunks ? ", world chunks " + std::to_string(cfg.chunkBudgetKB) + " KB" : std::string())
+              << (cfg.noLod ? ", no LOD" : "")
+              << (cfg.noShadows ? ", no shadows" : ", shadows " + std::to_string(cfg.shadowSize) +
+                                  (cfg.shadowEveryFrame ? " every frame" : " throttled"))
+              << ", " << cfg.vertexFormat << " vertices)\n";
+    std::cout << "[Bench] frame ms: min " << sorted.front() << "  avg " << avg << "  p99 " << sorted[p99Index]
+              << "  max " << sorted.back() << "  (" << (avg > 0.0 ? 1000.0 / avg : 0.0) << " fps avg)\n";
+    for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+        if (scopeFrames[s] == 0) continue;
+        double n = scopeFrames[s];
+        std::cout << "[Bench]   " << profileScopeName((ProfileScope)s) << ": cpu " << scopeCpuMs[s] / n << " ms, gpu "
+                  << scopeGpuMs[s] / n << " ms, draws " << scopeDraws[s] / n << ", uniforms " << scopeUniforms[s] / n
+                  << ", state changes " << scopeStates[s] / n;
+        // Throttled scopes (far shadow cascades): averaged over the frames they ran in
+        if (scopeFrames[s] < resolvedFrames) std::cout << " (" << scopeFrames[s] << " of " << resolvedFrames << " frames)";
+        std::cout << "\n";
+    }
+    if (!cfg.csvPath.empty()) {
+        if (profilerDumpCSV(cfg.csvPath.c_str()))
+            std::cout << "[Bench] Profiler history (" << profilerHistorySize() << " frames) -> " << cfg.csvPath << "\n";
+        else
+            std::cout << "[Guard] Could not write " << cfg.csvPath << "\n";
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "frame_clock.h"
+#include "profiler.h"
+
+// ---------------- Benchmark mode ----------------
+// `EnchantedForest --bench [options]` builds a fixed, seeded scene without the console prompts,
+// flies the camera along a closed spline for a fixed number of frames and reports frame-time
+// statistics plus per-scope profiler costs. Options (also accepted as key=value lines, without
+// the leading dashes, in a --config file; later arguments override earlier ones):
+//   --frames N  --warmup N  --seed N  --small N  --medium N  --tall N  --paths N
+//   --fountain-radius N  --fireflies N  --vsync  --adaptive-vsync  --fps-cap N  --offscreen  --no-batch  --vertex-format NAME
+//   --depth-prepass  --unsorted  --world-chunks  --chunk-budget KB  --no-lod  --no-shadows
+//   --shadow-size N  --shadow-every-frame  --csv PATH
+//   --config PATH  --scene PATH
+// --scene (a saved scene_snapshot.h file in place of the generated layout) also works without --bench.
+struct BenchConfig {
+    bool enabled = false;
+    int frames = 600;        // measured frames (one full camera loop)
+    int warmup = 30;         // unmeasured frames first (shader/driver warm-up)
+    int seed = 1337;         // layout and firefly RNG seed
+    int smallTrees = 5, mediumTrees = 10, tallTrees = 5;
+    int paths = 5;
+    int fountainRadius = 60;
+    int fireflies = 30;
+    bool vsync = false;      // off by default so results measure the renderer, not the display
+    bool adaptiveVsync = false; // vsync that lets late frames tear (frame_clock.h); implies vsync
+    int fpsCap = 0;          // frame limiter without vsync; 0 = uncapped
+    bool offscreen = false;  // hidden window + FBO, for machines without a display
+    bool noBatch = false;    // per-object static draws instead of the static scene batch
+    std::string vertexFormat = "half"; // mesh vertex layout: full, compact or half (vertex_format.h)
+    bool depthPrepass = false; // render queue depth pre-pass (render_queue.h)
+    bool unsorted = false;     // opaque draws in submission order instead of front-to-back
+    bool worldChunks = false;  // stream the procedural chunked forest (world_chunks.h)
+    int chunkBudgetKB = 8192;  // resident chunk memory budget
+    bool noLod = false;        // full-detail fountain and trees at every distance (lod.h)
+    bool noShadows = false;    // no shadow maps (shadow_map.h)
+    int shadowSize = 1024;     // texels per side of each shadow cascade
+    bool shadowEveryFrame = false; // render every cascade every frame instead of throttling the far ones
+    std::string csvPath;     // optional profiler history dump at the end
+    std::string scenePath;   // saved scene to load; overrides the tree/path/fountain/seed options
+};
+
+// Parses argv into cfg; returns false (after printing why) on an unknown option or bad value
+bool parseBenchArgs(int argc, char** argv, BenchConfig& cfg);
+bool loadBenchConfigFile(const std::string& path, BenchConfig& cfg);
+
+// Presentation mode the options ask for (adaptive vsync > vsync > fps cap > uncapped)
+FramePacing benchPacing(const BenchConfig& cfg);
+
+// Deterministic flythrough: closed Catmull-Rom loop around the fountain, t in [0, 1)
+struct CameraPose { glm::vec3 position; glm::vec3 front; };
+CameraPose benchCameraAt(float t);
+
+// Frame-time and per-scope accumulation over one benchmark run
+struct BenchRun {
+    BenchConfig cfg;
+    FramePacing pacing = PACING_UNCAPPED; // in effect (adaptive vsync may fall back); set by main
+    int frame = 0;                 // frames rendered so far, warm-up included
+    std::vector<double> frameMs;   // measured frames only
+    double scopeCpuMs[PROF_SCOPE_COUNT] = {};
+    double scopeGpuMs[PROF_SCOPE_COUNT] = {};
+    long long scopeDraws[PROF_SCOPE_COUNT] = {};
+    long long scopeUniforms[PROF_SCOPE_COUNT] = {};
+    long long scopeStates[PROF_SCOPE_COUNT] = {};
+    int scopeFrames[PROF_SCOPE_COUNT] = {};
+    int resolvedFrames = 0;        // measured frames whose profile was read back
+    unsigned long long lastProfileIndex = ~0ull;
+
+    bool measuring() const { return frame >= cfg.warmup; }
+    bool finished() const { return frame >= cfg.warmup + cfg.frames; }
+    float splineParam() const; // camera loop parameter for the current frame
+    // Call once per frame after profilerEndFrame with that frame's wall time
+    void recordFrame(double ms);
+    void report() const;
+};
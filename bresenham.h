@@ -1,19 +1,26 @@
 #pragma once
-#include <GL/gl.h>
+#include <GL/glew.h>
+#include <cstdlib>
 
-void drawLine(int x1, int y1, int x2, int y2) {
-    glBegin(GL_POINTS);
+// Bresenham's line: calls plot(x, y) for every cell from (x1, y1) to (x2, y2), both inclusive
+template <typename Plot>
+inline void rasterLine(int x1, int y1, int x2, int y2, Plot&& plot) {
     int dx = abs(x2 - x1), dy = abs(y2 - y1);
     int sx = (x1 < x2) ? 1 : -1;
     int sy = (y1 < y2) ? 1 : -1;
     int err = dx - dy;
 
     while (true) {
-        glVertex2i(x1, y1);
+        plot(x1, y1);
         if (x1 == x2 && y1 == y2) break;
         int e2 = 2 * err;
         if (e2 > -dy) { err -= dy; x1 += sx; }
         if (e2 < dx) { err += dx; y1 += sy; }
     }
+}
+
+inline void drawLine(int x1, int y1, int x2, int y2) {
+    glBegin(GL_POINTS);
+    rasterLine(x1, y1, x2, y2, [](int x, int y) { glVertex2i(x, y); });
     glEnd();
 }
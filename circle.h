@@ -1,24 +1,31 @@
 #pragma once
-#include <GL/gl.h>
+#include <GL/glew.h>
 
-void drawCircle(int xc, int yc, int r) {
-    glBegin(GL_POINTS);
+// Midpoint circle: calls plot(x, y) for the 8 symmetric points of every step around (xc, yc).
+// Points on the octant boundaries are reported more than once.
+template <typename Plot>
+inline void rasterCircle(int xc, int yc, int r, Plot&& plot) {
     int x = 0, y = r;
     int d = 1 - r;
 
     while (x <= y) {
-        glVertex2i(xc + x, yc + y);
-        glVertex2i(xc - x, yc + y);
-        glVertex2i(xc + x, yc - y);
-        glVertex2i(xc - x, yc - y);
-        glVertex2i(xc + y, yc + x);
-        glVertex2i(xc - y, yc + x);
-        glVertex2i(xc + y, yc - x);
-        glVertex2i(xc - y, yc - x);
+        plot(xc + x, yc + y);
+        plot(xc - x, yc + y);
+        plot(xc + x, yc - y);
+        plot(xc - x, yc - y);
+        plot(xc + y, yc + x);
+        plot(xc - y, yc + x);
+        plot(xc + y, yc - x);
+        plot(xc - y, yc - x);
 
         if (d < 0) d += 2 * x + 3;
         else { d += 2 * (x - y) + 5; y--; }
         x++;
     }
+}
+
+inline void drawCircle(int xc, int yc, int r) {
+    glBegin(GL_POINTS);
+    rasterCircle(xc, yc, r, [](int x, int y) { glVertex2i(x, y); });
     glEnd();
 }
@@ -0,0 +1,11 @@
+#version 330 core
+
+in vec3 GlowColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    // Additive blend (GL_SRC_ALPHA, GL_ONE) is set by drawFireflies
+    FragColor = vec4(GlowColor, 1.0);
+}
@@ -0,0 +1,40 @@
+#version 330 core
+
+// Fireflies: one instanced draw of the cube VAO. Drift, blink and distance fade are evaluated
+// here from the static per-firefly data, so the CPU only uploads `time` each frame.
+layout(location = 0) in vec3 aPos;
+layout(location = 3) in vec4 aPosPhase; // rest position xyz, bob phase
+layout(location = 4) in vec4 aMotion;   // drift phase X, drift phase Z, blink phase, blink speed
+
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
+
+out vec3 GlowColor;
+
+void main()
+{
+    vec3 pos = aPosPhase.xyz;
+    pos.y += sin(time + aPosPhase.w) * 0.3;
+    pos.x += sin(time + aMotion.x) * 0.1;
+    pos.z += cos(time + aMotion.y) * 0.1;
+
+    float intensity = 0.5 + 0.5 * sin(time * aMotion.w + aMotion.z * 6.2831);
+    float fade = clamp(1.0 - length(viewPos - pos) / 20.0, 0.0, 1.0);
+    intensity *= fade;
+    GlowColor = vec3(1.0, 1.0, 0.5) * intensity;
+
+    gl_Position = projection * view * vec4(pos + aPos * 0.05, 1.0);
+}
@@ -1,22 +1,94 @@
 #version 330 core
 
+// Mesh shader for the forest scene. Permutations are selected by #defines that
+// compileShaderFromFile injects after the #version line:
+//   (none)         per-object model matrix; normals use the CPU-computed normalMatrix
+//   UNIFORM_SCALE  model is rotation/translation/uniform scale only, so its 3x3 transforms normals
+//                  directly (fragment_shader.glsl renormalizes) and normalMatrix is not needed
+//   INSTANCED      procedural trees, one draw per tree part: the model matrix is rebuilt per
+//                  instance as translate(x, lift, z) * rotateY(yaw) * scale
+//   LOD_FADE       (with INSTANCED) trees crossfading into their impostors: LodFade is the share of
+//                  pixels fragment_shader.glsl dissolves, 0 before the fade band, 1 past it
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoord;
+#ifdef INSTANCED
+layout(location = 3) in vec4 aInstance; // world x, world z, size base, yaw offset (radians)
+#endif
 
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
+// Bound per material (uniform_blocks.h MaterialUniforms)
+layout(std140) uniform MaterialBlock {
+    vec3 objectColor;
+    int solidMode;    // 0 = textured, 1 = solid objectColor
+    int textureLayer; // scene texture array layer, -1 = texture_diffuse1
+};
+
+#ifdef INSTANCED
+uniform vec3 partScale; // local scale of this part per unit of size base (x, y, z)
+uniform float partLift; // Y offset of this part per unit of size base (cone sits on the trunk)
+uniform float treeYaw;  // global tree yaw (radians), added to the per-instance offset
+#ifdef LOD_FADE
+out float LodFade;
+#endif
+#else
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#ifndef UNIFORM_SCALE
+uniform mat3 normalMatrix; // transpose(inverse(mat3(model))), once per object (ShaderProgram::setModel)
+#endif
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+flat out int MaterialLayer;
 
 void main()
 {
+#ifdef INSTANCED
+    float base = aInstance.z;
+    float yaw = treeYaw + aInstance.w;
+    float c = cos(yaw);
+    float s = sin(yaw);
+    vec3 scale = partScale * base;
+
+    // Same rotation as glm::rotate(angle, +Y)
+    vec3 p = aPos * scale;
+    FragPos = vec3(c * p.x + s * p.z, p.y + partLift * base, -s * p.x + c * p.z)
+            + vec3(aInstance.x, 0.0, aInstance.y);
+
+    // Inverse-transpose of rotate * scale is rotate * inverse(scale)
+    vec3 n = aNormal / scale;
+    Normal = vec3(c * n.x + s * n.z, n.y, -s * n.x + c * n.z);
+#ifdef LOD_FADE
+    // Same measure as impostor.vert, so the two dissolve patterns stay complementary
+    LodFade = clamp((length(vec3(aInstance.x, 0.0, aInstance.y) - viewPos) / base - lodFade.x) * lodFade.y, 0.0, 1.0);
+#endif
+#else
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+#ifdef UNIFORM_SCALE
+    Normal = mat3(model) * aNormal;
+#else
+    Normal = normalMatrix * aNormal;
+#endif
+#endif
     TexCoord = aTexCoord;
 
+    MaterialLayer = textureLayer;
+
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
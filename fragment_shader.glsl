@@ -1,21 +1,90 @@
 #version 330 core
 
+// Permutations (compileShaderFromFile defines):
+//   ALPHA_TEST  discard texels with alpha < 0.1 (leaves). Off everywhere else so those draws keep
+//               early-Z; a discard anywhere in the shader defers depth writes to after shading.
+//   LOD_FADE    also discard LodFade of the pixels in an ordered 4x4 dither (geometry <-> impostor
+//               crossfade). The impostor side mirrors the pattern, so exactly one of the two
+//               covers each pixel and nothing is blended or sorted.
+//   IMPOSTOR    impostor.vert quads: the normal comes from the impostor_normals atlas
+//   IMPOSTOR_BAKE  impostor capture (ImpostorAtlas::bake): unlit albedo to attachment 0 and the
+//               normal in the capture camera's basis to attachment 1
+//   SHADOW_CASTER  shadow map pass (shadow_map.h): depth only, so nothing past the alpha test runs
+
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+flat in int MaterialLayer; // texture layer (MaterialBlock, or per draw in scene_batch.vert)
+#ifdef LOD_FADE
+in float LodFade;
+#endif
+#ifdef IMPOSTOR
+in vec3 ImpostorRight;
+in vec3 ImpostorUp;
+uniform sampler2D impostor_normals; // frame-basis normals, * 0.5 + 0.5 (impostor_atlas.h)
+#endif
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+#ifdef IMPOSTOR_BAKE
+layout(location = 1) out vec4 FragNormal; // in the basis of FrameBlock view (the capture camera)
+#endif
 
 uniform sampler2D texture_diffuse1;
+// Small tiling textures (ground, path, trunk, leaves) share one array; MaterialLayer picks the
+// layer, or -1 to sample texture_diffuse1 (fountain OBJ)
+uniform sampler2DArray texture_layers;
+#ifndef SHADOW_CASTER
+// Cascade depth layers with compare mode on: each lookup is a 2x2 PCF tap (shadow_map.h)
+uniform sampler2DArrayShadow shadow_map;
+#endif
+
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
 
-uniform vec3 lightDir;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
-uniform vec3 fogColor;
-uniform float fogDensity;
+// Bound per material (uniform_blocks.h MaterialUniforms)
+layout(std140) uniform MaterialBlock {
+    vec3 objectColor;
+    int solidMode;    // 0 = textured, 1 = solid objectColor
+    int textureLayer; // scene texture array layer, -1 = texture_diffuse1
+};
 
-uniform vec3 objectColor; // for fireflies
-uniform int solidMode;    // 0 = textured, 1 = solid objectColor
+#ifdef SHADOW_CASTER
+float shadowFactor(vec3 norm) { return 1.0; } // never reached: casters return after the alpha test
+#else
+// 1 = lit. The first cascade whose map covers the fragment (a kernel's width inside the edge) is
+// filtered with 3x3 hardware PCF taps; shadows fade out toward the shadow distance.
+float shadowFactor(vec3 norm)
+{
+    int count = int(shadowParams.x);
+    float dist = length(viewPos - FragPos);
+    if (count == 0 || dist >= shadowParams.z) return 1.0;
+    float texel = shadowParams.w;
+    for (int c = 0; c < count; ++c) {
+        vec4 s = shadowMatrix[c] * vec4(FragPos + norm * shadowOffsets[c], 1.0);
+        if (any(lessThan(s.xy, vec2(2.0 * texel))) || any(greaterThan(s.xy, vec2(1.0 - 2.0 * texel))) || s.z > 1.0)
+            continue;
+        float lit = 0.0;
+        for (int y = -1; y <= 1; ++y)
+            for (int x = -1; x <= 1; ++x)
+                lit += texture(shadow_map, vec4(s.xy + vec2(x, y) * texel, float(c), s.z));
+        return mix(lit / 9.0, 1.0, smoothstep(shadowParams.y, shadowParams.z, dist));
+    }
+    return 1.0;
+}
+#endif
 
 void main()
 {
@@ -26,12 +95,36 @@ void main()
     }
 
     // --- Texture ---
-    vec4 texColor = texture(texture_diffuse1, TexCoord);
+    vec4 texColor = (MaterialLayer >= 0) ? texture(texture_layers, vec3(TexCoord, float(MaterialLayer)))
+                                         : texture(texture_diffuse1, TexCoord);
+#ifdef ALPHA_TEST
     // Discard fully transparent fragments to avoid unintended glow color leaking
     if (texColor.a < 0.1) discard;
+#endif
+#ifdef SHADOW_CASTER
+    return;
+#endif
+#ifdef LOD_FADE
+    int bayer[16] = int[16](0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5);
+    ivec2 cell = ivec2(gl_FragCoord.xy) & 3;
+    float dither = (float(bayer[cell.y * 4 + cell.x]) + 0.5) / 16.0;
+#ifdef IMPOSTOR
+    dither = 1.0 - dither;
+#endif
+    if (dither < LodFade) discard;
+#endif
+#ifdef IMPOSTOR_BAKE
+    FragColor = vec4(texColor.rgb, 1.0);
+    FragNormal = vec4(normalize(mat3(view) * normalize(Normal)) * 0.5 + 0.5, 1.0);
+    return;
+#endif
 
     // --- Lighting (simple directional) ---
     vec3 norm = normalize(Normal);
+#ifdef IMPOSTOR
+    vec3 n = texture(impostor_normals, TexCoord).xyz * 2.0 - 1.0;
+    norm = normalize(ImpostorRight * n.x + ImpostorUp * n.y + Normal * n.z);
+#endif
     vec3 lightDirNorm = normalize(-lightDir);
     // Slightly soften diffuse contribution a bit more
     float diff = max(dot(norm, lightDirNorm), 0.0) * 0.80;
@@ -40,9 +133,9 @@ void main()
     vec3 reflectDir = reflect(lightDirNorm, norm);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 16.0) * 0.06; // slightly softer specular
 
-    // A touch more ambient to make scene a bit gentler
+    // A touch more ambient to make scene a bit gentler; shadows keep only the ambient term
     float ambient = 0.24;
-    vec3 lighting = (ambient + diff + spec) * lightColor;
+    vec3 lighting = (ambient + (diff + spec) * shadowFactor(norm)) * lightColor;
 
     vec3 color = texColor.rgb * lighting;
 
@@ -0,0 +1,62 @@
+#include "frame_clock.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+int FrameClock::advance(double now) {
+    if (lockstep) return 1;
+    if (last < 0.0) last = now;
+    accumulator += now - last;
+    last = now;
+    int steps = (int)(accumulator / kSimStep);
+    if (steps > kMaxSimSteps) {
+        // Catching up would make the next frame slower still; keep only the fraction
+        std::cout << "[Guard] Simulation fell " << steps << " ticks behind; dropped " << steps - kMaxSimSteps << "\n";
+        steps = kMaxSimSteps;
+        accumulator = std::fmod(accumulator, kSimStep);
+    } else {
+        accumulator -= steps * kSimStep;
+    }
+    return steps;
+}
+
+float FrameClock::alpha() const {
+    return lockstep ? 1.0f : (float)(accumulator / kSimStep);
+}
+
+const char* framePacingName(FramePacing pacing) {
+    switch (pacing) {
+    case PACING_VSYNC: return "vsync";
+    case PACING_ADAPTIVE_VSYNC: return "adaptive vsync";
+    case PACING_UNCAPPED: return "uncapped";
+    case PACING_CAPPED: return "capped";
+    default: return "?";
+    }
+}
+
+FramePacing applyFramePacing(FramePacing pacing) {
+    if (pacing == PACING_ADAPTIVE_VSYNC &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        std::cout << "[Guard] Adaptive vsync unsupported (no swap_control_tear); using vsync\n";
+        pacing = PACING_VSYNC;
+    }
+    int interval = pacing == PACING_VSYNC ? 1 : (pacing == PACING_ADAPTIVE_VSYNC ? -1 : 0);
+    glfwSwapInterval(interval);
+    return pacing;
+}
+
+void FrameLimiter::wait() {
+    double period = 1.0 / std::max(fps, 1.0);
+    double now = glfwGetTime();
+    if (next < 0.0 || now > next + period) next = now; // first frame, or fell a whole frame behind
+    // Sleep through most of the gap; the scheduler overshoots, so spin the last millisecond
+    double remaining = next - now;
+    if (remaining > 0.002)
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.001));
+    while (glfwGetTime() < next) std::this_thread::yield();
+    next += period;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// ---------------- Frame clock ----------------
+// The simulation (held-key camera movement and model controls, the firefly clock, the debug
+// flash fade) runs in fixed kSimStep ticks driven by glfwGetTime, so it behaves the same at any
+// refresh rate. Each frame runs as many ticks as the wall time since the last frame covers and
+// renders alpha() of the way from the state before the last tick to the state after it.
+// Presentation is separate (FramePacing): vsync, adaptive vsync, uncapped, or uncapped with a
+// FrameLimiter, none of which changes what the simulation does.
+const double kSimStep = 1.0 / 60.0; // the per-tick amounts in main.cpp were tuned at 60 Hz
+const int kMaxSimSteps = 8;         // ticks per frame; after a longer stall the backlog is dropped
+
+struct FrameClock {
+    // One tick per frame whatever the wall time (bench: the same scene sequence at any frame rate)
+    bool lockstep = false;
+    // Ticks to run for a frame starting at now (seconds, glfwGetTime)
+    int advance(double now);
+    // Render position between the last two ticks, in [0, 1); 1 in lockstep
+    float alpha() const;
+
+private:
+    double last = -1.0;
+    double accumulator = 0.0;
+};
+
+enum FramePacing { PACING_VSYNC, PACING_ADAPTIVE_VSYNC, PACING_UNCAPPED, PACING_CAPPED, PACING_COUNT };
+const char* framePacingName(FramePacing pacing);
+// Sets the swap interval on the current context and returns the mode in effect: adaptive vsync
+// (late frames swap immediately instead of waiting for the next refresh) needs
+// *_EXT_swap_control_tear and falls back to plain vsync without it
+FramePacing applyFramePacing(FramePacing pacing);
+
+// PACING_CAPPED: call right before swapping; holds swaps to fps per second. A frame more than a
+// period late restarts the schedule instead of letting the next ones run back-to-back.
+struct FrameLimiter {
+    double fps = 120.0;
+    void wait();
+
+private:
+    double next = -1.0;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <glm/glm.hpp>
+
+// ---------------- Bounding sphere ----------------
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+};
+
+// ---------------- View frustum ----------------
+// Six planes (dot(n, p) + d >= 0 inside) extracted from a combined projection * view matrix
+// (Gribb/Hartmann). Normals are normalised so sphere tests compare true distances.
+struct Frustum {
+    glm::vec4 planes[6]; // left, right, bottom, top, near, far
+
+    void extract(const glm::mat4& viewProj) {
+        // glm is column-major: row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::vec4 row[4];
+        for (int i = 0; i < 4; ++i) row[i] = glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        planes[0] = row[3] + row[0];
+        planes[1] = row[3] - row[0];
+        planes[2] = row[3] + row[1];
+        planes[3] = row[3] - row[1];
+        planes[4] = row[3] + row[2];
+        planes[5] = row[3] - row[2];
+        for (glm::vec4& p : planes) p /= glm::length(glm::vec3(p));
+    }
+
+    // Conservative: spheres straddling a corner outside two planes still count as visible
+    bool intersectsSphere(const BoundingSphere& s) const {
+        for (const glm::vec4& p : planes) {
+            if (glm::dot(glm::vec3(p), s.center) + p.w < -s.radius) return false;
+        }
+        return true;
+    }
+};
+
+// Distance beyond which the exp2 fog in fragment_shader.glsl (1 - exp(-(d * density)^2)) leaves
+// less than half an 8-bit step of the surface colour, so the object is indistinguishable from fog.
+inline float fogCullDistance(float density) {
+    if (density <= 0.0f) return std::numeric_limits<float>::max();
+    return std::sqrt(std::log(512.0f)) / density;
+}
@@ -0,0 +1,92 @@
+#include "gl_state.h"
+#include "profiler.h"
+
+namespace {
+// Last value issued per piece of state; valid = false until the first set after a reset
+template <typename T> struct Cached {
+    T value = T();
+    bool valid = false;
+    // True (and records v) when v has to be issued
+    bool update(T v) {
+        if (valid && value == v) return false;
+        value = v;
+        valid = true;
+        profileStateChanges++;
+        return true;
+    }
+};
+
+Cached<GLuint> program, vertexArray;
+Cached<int> activeUnit;
+Cached<GLuint> textures[kCachedTextureUnits][2]; // [unit][0: GL_TEXTURE_2D, 1: GL_TEXTURE_2D_ARRAY]
+Cached<bool> depthTest, depthWrite, colorWrite, blend;
+Cached<GLenum> depthFunc, blendSrc, blendDst;
+
+void enable(GLenum cap, bool on) {
+    if (on) glEnable(cap);
+    else glDisable(cap);
+}
+} // namespace
+
+void resetStateCache() {
+    program.valid = vertexArray.valid = activeUnit.valid = false;
+    for (auto& unit : textures) unit[0].valid = unit[1].valid = false;
+    depthTest.valid = depthWrite.valid = colorWrite.valid = blend.valid = false;
+    depthFunc.valid = blendSrc.valid = blendDst.valid = false;
+}
+
+void useProgram(GLuint id) {
+    if (program.update(id)) glUseProgram(id);
+}
+
+void bindVertexArray(GLuint vao) {
+    if (vertexArray.update(vao)) glBindVertexArray(vao);
+}
+
+void deleteVertexArrays(GLsizei n, const GLuint* vaos) {
+    for (GLsizei i = 0; i < n; ++i) {
+        if (vertexArray.valid && vaos[i] != 0 && vertexArray.value == vaos[i]) vertexArray.value = 0;
+    }
+    glDeleteVertexArrays(n, vaos);
+}
+
+void bindTexture(int unit, GLenum target, GLuint texture) {
+    int slot = target == GL_TEXTURE_2D ? 0 : (target == GL_TEXTURE_2D_ARRAY ? 1 : -1);
+    bool cached = slot >= 0 && unit >= 0 && unit < kCachedTextureUnits;
+    if (cached && textures[unit][slot].valid && textures[unit][slot].value == texture) return;
+    if (activeUnit.update(unit)) glActiveTexture(GL_TEXTURE0 + unit);
+    if (cached) textures[unit][slot].update(texture);
+    else profileStateChanges++;
+    glBindTexture(target, texture);
+}
+
+void setDepthTest(bool enabled) {
+    if (depthTest.update(enabled)) enable(GL_DEPTH_TEST, enabled);
+}
+
+void setDepthWrite(bool enabled) {
+    if (depthWrite.update(enabled)) glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void setDepthFunc(GLenum func) {
+    if (depthFunc.update(func)) glDepthFunc(func);
+}
+
+void setColorWrite(bool enabled) {
+    GLboolean b = enabled ? GL_TRUE : GL_FALSE;
+    if (colorWrite.update(enabled)) glColorMask(b, b, b, b);
+}
+
+void setBlend(bool enabled) {
+    if (blend.update(enabled)) enable(GL_BLEND, enabled);
+}
+
+void setBlendFunc(GLenum src, GLenum dst) {
+    // One glBlendFunc for both factors; counted once
+    bool changed = !(blendSrc.valid && blendDst.valid && blendSrc.value == src && blendDst.value == dst);
+    if (!changed) return;
+    blendSrc.value = src; blendDst.value = dst;
+    blendSrc.valid = blendDst.valid = true;
+    profileStateChanges++;
+    glBlendFunc(src, dst);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <GL/glew.h>
+
+// ---------------- GL state cache ----------------
+// Draw helpers change program, VAO, texture, depth, colour-mask and blend state through these
+// instead of calling GL directly. Each setter compares against the last value it issued and drops
+// no-op changes; the ones that reach GL are counted in profileStateChanges (profiler.h).
+// Only changes made through the cache are known to it. Code that binds state behind its back
+// (texture uploads, the impostor capture) runs before resetStateCache(), which marks everything
+// unknown so the next setter of each kind always issues. Mesh setup binds its VAO through here too,
+// so a draw VAO left bound is never mistaken for the current one.
+const int kCachedTextureUnits = 8; // units past this are bound directly, uncached
+
+void resetStateCache();
+
+void useProgram(GLuint program);
+void bindVertexArray(GLuint vao);
+// Deleting a bound VAO reverts GL's binding to 0 and frees the name for reuse; delete through here
+void deleteVertexArrays(GLsizei n, const GLuint* vaos);
+// Makes unit active only when the binding actually changes. GL_TEXTURE_2D and
+// GL_TEXTURE_2D_ARRAY are cached per unit; other targets always issue.
+void bindTexture(int unit, GLenum target, GLuint texture);
+
+void setDepthTest(bool enabled);
+void setDepthWrite(bool enabled);
+void setDepthFunc(GLenum func);
+void setColorWrite(bool enabled);
+void setBlend(bool enabled);
+void setBlendFunc(GLenum src, GLenum dst);
@@ -0,0 +1,82 @@
+#version 330 core
+
+// Camera-facing impostor quads for the instanced trees (paired with fragment_shader.glsl
+// +IMPOSTOR +ALPHA_TEST +LOD_FADE). The atlas layout comes in as defines:
+//   IMPOSTOR_FRAMES_X  azimuth frames around +Y
+//   IMPOSTOR_FRAMES_Y  elevation frames, 90 / IMPOSTOR_FRAMES_Y degrees apart from the horizon
+// The quad always faces the camera; the texels come from the frame captured nearest to the
+// camera direction in the tree's own (unrotated) frame, see impostor_atlas.h.
+layout(location = 0) in vec2 aCorner;   // quad corner in [-1, 1]^2
+layout(location = 3) in vec4 aInstance; // world x, world z, size base, yaw offset (radians)
+
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
+
+uniform float treeYaw;     // global tree yaw (radians), added to the per-instance offset
+uniform vec2 impostorSize; // captured bounding radius and centre height per unit of size base
+
+out vec3 FragPos;
+out vec3 Normal;        // frame's toward-camera axis; with the two below, the normal atlas basis
+out vec3 ImpostorRight;
+out vec3 ImpostorUp;
+out vec2 TexCoord;
+flat out int MaterialLayer;
+out float LodFade;
+
+const float kTwoPi = 6.2831853;
+const float kHalfPi = 1.5707963;
+
+void main()
+{
+    float base = aInstance.z;
+    vec3 root = vec3(aInstance.x, 0.0, aInstance.y);
+    vec3 center = root + vec3(0.0, impostorSize.y * base, 0.0);
+    vec3 toCamera = normalize(viewPos - center);
+
+    // Quad basis; straight overhead any horizontal right axis will do
+    vec3 r = vec3(toCamera.z, 0.0, -toCamera.x);
+    vec3 right = dot(r, r) > 1e-6 ? normalize(r) : vec3(1.0, 0.0, 0.0);
+    vec3 up = cross(toCamera, right);
+    FragPos = center + (aCorner.x * right + aCorner.y * up) * (impostorSize.x * base);
+
+    // Camera direction in the tree's frame: inverse of forest.vert's rotation about +Y
+    float yaw = treeYaw + aInstance.w;
+    float c = cos(yaw);
+    float s = sin(yaw);
+    vec3 local = vec3(c * toCamera.x - s * toCamera.z, toCamera.y, s * toCamera.x + c * toCamera.z);
+    float azStep = kTwoPi / float(IMPOSTOR_FRAMES_X);
+    float elStep = kHalfPi / float(IMPOSTOR_FRAMES_Y);
+    float fx = mod(floor(atan(local.x, local.z) / azStep + 0.5), float(IMPOSTOR_FRAMES_X));
+    float fy = clamp(floor(asin(clamp(local.y, 0.0, 1.0)) / elStep + 0.5), 0.0, float(IMPOSTOR_FRAMES_Y - 1));
+
+    // That frame's capture basis (ImpostorAtlas::frameDirection), rotated into the world
+    float az = fx * azStep;
+    float el = fy * elStep;
+    vec3 frameDir = vec3(sin(az) * cos(el), sin(el), cos(az) * cos(el));
+    vec3 frameRight = vec3(cos(az), 0.0, -sin(az));
+    vec3 frameUp = cross(frameDir, frameRight);
+    Normal = vec3(c * frameDir.x + s * frameDir.z, frameDir.y, -s * frameDir.x + c * frameDir.z);
+    ImpostorRight = vec3(c * frameRight.x + s * frameRight.z, frameRight.y, -s * frameRight.x + c * frameRight.z);
+    ImpostorUp = vec3(c * frameUp.x + s * frameUp.z, frameUp.y, -s * frameUp.x + c * frameUp.z);
+
+    TexCoord = (vec2(fx, fy) + 0.5 + 0.5 * aCorner) / vec2(float(IMPOSTOR_FRAMES_X), float(IMPOSTOR_FRAMES_Y));
+    MaterialLayer = -1; // albedo atlas on texture_diffuse1
+
+    // Complement of the geometry's fade (forest.vert +LOD_FADE): dissolved in where it dissolves out
+    LodFade = 1.0 - clamp((length(root - viewPos) / base - lodFade.x) * lodFade.y, 0.0, 1.0);
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,98 @@
+#include "impostor_atlas.h"
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+GLuint createAtlasTexture(int width, int height) {
+    GLuint tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return tex;
+}
+} // namespace
+
+glm::vec3 ImpostorAtlas::frameDirection(int x, int y) const {
+    float az = (float)x * 6.2831853f / (float)framesX;
+    float el = (float)y * 1.5707963f / (float)framesY;
+    return glm::vec3(std::sin(az) * std::cos(el), std::sin(el), std::cos(az) * std::cos(el));
+}
+
+bool ImpostorAtlas::bake(const glm::vec3& sphereCenter, float sphereRadius,
+                         const std::function<void(const glm::mat4&, const glm::mat4&)>& drawObject) {
+    destroy();
+    center = sphereCenter;
+    radius = sphereRadius;
+
+    GLint prevFBO = 0, prevViewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFBO);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+
+    albedo = createAtlasTexture(width(), height());
+    normals = createAtlasTexture(width(), height());
+    GLuint fbo = 0, depth = 0;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &depth);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normals, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width(), height());
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, drawBuffers);
+
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (complete) {
+        // Uncovered texels take a dark foliage tint (alpha 0), so filtered edges fade toward the
+        // leaves' colour instead of black; flat normals face the camera
+        const GLfloat albedoClear[4] = { 0.16f, 0.22f, 0.10f, 0.0f };
+        const GLfloat normalClear[4] = { 0.5f, 0.5f, 1.0f, 0.0f };
+        const GLfloat depthClear = 1.0f;
+        glClearBufferfv(GL_COLOR, 0, albedoClear);
+        glClearBufferfv(GL_COLOR, 1, normalClear);
+        glClearBufferfv(GL_DEPTH, 0, &depthClear);
+
+        glm::mat4 projection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 4.0f * radius);
+        for (int y = 0; y < framesY; ++y) {
+            for (int x = 0; x < framesX; ++x) {
+                glm::vec3 eye = center + frameDirection(x, y) * (2.0f * radius);
+                glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+                glViewport(x * framePx, y * framePx, framePx, framePx);
+                drawObject(view, projection);
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D, albedo);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, normals);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFBO);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glDeleteRenderbuffers(1, &depth);
+    glDeleteFramebuffers(1, &fbo);
+    if (!complete) {
+        std::cout << "[Guard] Impostor capture framebuffer incomplete; impostors disabled\n";
+        destroy();
+        return false;
+    }
+    baked = true;
+    std::cout << "[Info] Impostor atlas: " << framesX << "x" << framesY << " frames of " << framePx << " px ("
+              << width() << "x" << height() << ", albedo + normals)\n";
+    return true;
+}
+
+void ImpostorAtlas::destroy() {
+    GLuint textures[2] = { albedo, normals };
+    glDeleteTextures(2, textures);
+    albedo = normals = 0;
+    baked = false;
+}
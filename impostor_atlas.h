@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// ---------------- Impostor atlas ----------------
+// Multi-angle impostor of one object, captured once through an FBO: framesX azimuths around +Y times
+// framesY elevations (0, 90/framesY, ... degrees above the horizon), each an orthographic
+// framePx^2 view of the object's bounding sphere. Two atlases share the layout:
+// - albedo:  unlit texture colour, alpha = coverage (0 where nothing was drawn)
+// - normals: the surface normal in the frame's basis (right, up, toward the camera), * 0.5 + 0.5
+// impostor.vert picks the frame nearest to the camera direction and fragment_shader.glsl
+// (+IMPOSTOR) lights and fogs the texels like the geometry. Frame (x, y) looks from
+// frameDirection(x, y) toward the centre with +Y up; its right axis is (cos az, 0, -sin az).
+struct ImpostorAtlas {
+    int framesX = 8, framesY = 3, framePx = 128;
+    GLuint albedo = 0, normals = 0;
+    glm::vec3 center = glm::vec3(0.0f); // captured bounding sphere, object space
+    float radius = 1.0f;
+    bool baked = false;
+
+    int width() const { return framesX * framePx; }
+    int height() const { return framesY * framePx; }
+    // Unit vector from the centre toward the frame's camera
+    glm::vec3 frameDirection(int x, int y) const;
+
+    // Calls drawObject(view, projection) once per frame with the capture FBO bound (two colour
+    // attachments: albedo, normal) and the frame's viewport set. Restores the framebuffer and
+    // viewport bound before; false if the FBO is incomplete.
+    bool bake(const glm::vec3& sphereCenter, float sphereRadius,
+              const std::function<void(const glm::mat4& view, const glm::mat4& projection)>& drawObject);
+    void destroy();
+};
@@ -0,0 +1,97 @@
+#include "job_system.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Job { std::function<void()> work, complete; };
+
+std::mutex queueMutex;
+std::condition_variable queueCv;   // workers wait for jobs
+std::condition_variable doneCv;    // finishJobs waits for completions
+std::deque<Job> jobs;
+std::deque<std::function<void()>> completions;
+std::vector<std::thread> workers;
+int outstanding = 0; // submitted, complete() not run yet
+bool stopping = false;
+
+void jobWorker() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, []{ return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job.work();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            completions.push_back(std::move(job.complete));
+        }
+        doneCv.notify_all();
+    }
+}
+
+void startWorkers() {
+    if (!workers.empty()) return;
+    // The texture decoders have their own threads; leave the render thread a core as well
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned count = std::max(1u, std::min(3u, hw > 2 ? hw - 2 : 1u));
+    for (unsigned i = 0; i < count; ++i) workers.emplace_back(jobWorker);
+}
+} // namespace
+
+void submitJob(std::function<void()> work, std::function<void()> complete) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        startWorkers();
+        jobs.push_back(Job{ std::move(work), std::move(complete) });
+        outstanding++;
+    }
+    queueCv.notify_one();
+}
+
+int pumpJobs() {
+    std::deque<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (completions.empty()) return 0;
+        ready.swap(completions);
+    }
+    // Outside the lock: complete() may submit follow-up jobs
+    for (std::function<void()>& complete : ready) complete();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        outstanding -= (int)ready.size();
+    }
+    return (int)ready.size();
+}
+
+void finishJobs() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (outstanding == 0) return;
+            doneCv.wait(lock, []{ return !completions.empty(); });
+        }
+        pumpJobs();
+    }
+}
+
+void shutdownJobs() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    queueCv.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+    completions.clear();
+    outstanding = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <functional>
+
+// ---------------- Job system ----------------
+// Worker threads for CPU-side generation (layout, mesh vertices and indices). A job is a pair of
+// callables: work() runs on a worker and fills staging data owned by the job (captured by value
+// or shared_ptr, never globals the main thread writes); complete() runs on the main thread from
+// pumpJobs() once work() has returned and does the GL upload. Until then the last good mesh keeps
+// rendering.
+void submitJob(std::function<void()> work, std::function<void()> complete);
+// Main thread, once per frame: runs complete() for the finished jobs. Returns how many.
+int pumpJobs();
+// Blocks until every submitted job has completed, running complete() as they arrive
+void finishJobs();
+// Joins the workers; queued jobs and unapplied results are dropped
+void shutdownJobs();
+
+// Latest-wins counter for one kind of result. Take a ticket when submitting; complete() applies
+// its result only if accept(ticket), i.e. no newer result was applied first. Jobs of one kind can
+// finish out of order on different workers: the older result is stale and dropped.
+struct JobGeneration {
+    unsigned int issued = 0, applied = 0;
+    int dropped = 0; // stale results seen so far
+    unsigned int next() { return ++issued; }
+    bool accept(unsigned int ticket) {
+        if (ticket <= applied) { dropped++; return false; }
+        applied = ticket;
+        return true;
+    }
+    // A result is still in flight. Every complete() must call accept(), even for an empty result,
+    // or this stays true.
+    bool pending() const { return applied < issued; }
+};
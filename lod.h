@@ -0,0 +1,30 @@
+#pragma once
+#include <algorithm>
+
+// ---------------- Level of detail ----------------
+// Detail levels are picked from the projected size of an object's bounding sphere: level 0 while
+// it covers at least minPx[0] pixels, level 1 down to minPx[1], and so on (minPx descending,
+// levels - 1 entries). Near a threshold the previous choice is kept inside a +-hysteresis band so
+// objects hovering at one distance do not flip between levels every frame.
+
+// Screen-space diameter in pixels of a sphere of the given radius at distance; projScaleY is
+// projection[1][1] (1 / tan(fovY / 2)), viewportH the framebuffer height
+inline float projectedDiameterPx(float radius, float distance, float projScaleY, float viewportH) {
+    return radius * projScaleY / std::max(distance, 1e-3f) * viewportH;
+}
+
+inline int lodForSize(float px, const float* minPx, int levels) {
+    int lod = 0;
+    while (lod < levels - 1 && px < minPx[lod]) ++lod;
+    return lod;
+}
+
+// current < 0: no previous choice (first frame, new object)
+inline int selectLod(float px, int current, const float* minPx, int levels, float hysteresis = 0.15f) {
+    if (levels <= 1) return 0;
+    if (current < 0 || current >= levels) return lodForSize(px, minPx, levels);
+    // Keep current anywhere between the levels of a slightly larger and a slightly smaller object
+    int finest = lodForSize(px * (1.0f + hysteresis), minPx, levels);
+    int coarsest = lodForSize(px * (1.0f - hysteresis), minPx, levels);
+    return std::min(std::max(current, finest), coarsest);
+}
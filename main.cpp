@@ -21,10 +21,20 @@
 // - P: Cycle stylized path mesh (visual only). Accurate user paths always render when available.
 // - [/]: Adjust fountain pixel radius (affects ring and overlays)
 // - T/M: Cycle ground textures (grass/moss/purple)
+// - N: Toggle instanced / per-tree rendering of the procedural trees
+// - B: Toggle the static scene batch (ground/paths/fountain/hedges/ring from one arena)
+// - C: Toggle frustum/fog culling (logs the last frame's visible/culled counts)
+// - H: Toggle level of detail for the fountain and trees (full detail everywhere when off)
+// - Y: Toggle cascaded shadow maps
+// - F1: Toggle the frame profiler bar | F2: Dump profiler history to profile.csv
+// - F3: Log loaded textures/models with ref counts and VRAM usage
+// - F4: Cycle frame pacing (vsync / adaptive vsync / uncapped / capped); simulation runs at a fixed rate
+// - F5: Save the scene to scene.efs (+ scene.json); --scene PATH loads one instead of the prompts
 // - I/O: Tree scale +/-   |  J: Trees yaw-left
 // - K/L: Fountain scale +/-| U: Fountain yaw-right (yaw-only)
 // - Mouse L: Plant a tree at cursor if not forbidden
 // - R: Reset camera and transforms | ESC: Exit
+// - --bench [options]: scripted, seeded flythrough with frame-time report (see bench.h)
 //
 // Notes on constraints
 // - Paths and trees are excluded inside the full annulus (fountain to outer hedges) and
@@ -43,28 +53,60 @@
 #include <cstdlib>
 #include <algorithm> // for std::sort
 #include <cmath>      // for std::llround, std::atan2
+#include <chrono>     // bench frame timing
 #include "model.h"
+#include "asset_registry.h"
 #include "shader_utils.h"
 #include "cube_utils.h"
 #include "bresenham.h"
 #include "circle.h"
+#include "occupancy_grid.h"
+#include "spatial_hash.h"
+#include "frustum.h"
+#include "profiler.h"
+#include "bench.h"
+#include "scene_batch.h"
+#include "vertex_format.h"
+#include "render_queue.h"
+#include "world_chunks.h"
+#include "job_system.h"
+#include "lod.h"
+#include "impostor_atlas.h"
+#include "uniform_blocks.h"
+#include "frame_clock.h"
+#include "scene_snapshot.h"
+#include "tree_store.h"
+#include "shadow_map.h"
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
 // ----------------- Globals -----------------
 enum TreeSize { Small=0, Medium=1, Tall=2 };
 struct TreeInst { glm::vec2 pos; TreeSize size; };
-std::vector<TreeInst> treeInstances;
+// Authored trees, structure of arrays (tree_store.h). Each keeps its radial margin to the outer
+// hedge disk (r - wedgeROuter2 * hedgeGlobalScale) and its gap to the fountain footprint
+// (r - fountainScale * fountainGlobalScale * 1.1f) so both distances survive scaling.
+TreeStore treeStore;
+static TreeInst treeAt(size_t i) { return TreeInst{ treeStore.pos(i), (TreeSize)treeStore.size[i] }; }
+// Bumped whenever a tree is added or moved; the instanced path re-uploads its buffer on change
+unsigned int treeRevision = 0;
 struct Glade { int gx; int gy; int radius; }; // design grid coordinates
 struct LayoutPath { glm::ivec2 a; glm::ivec2 b; bool clear; };
 std::vector<Glade> glades;
 std::vector<LayoutPath> layoutPaths;
 bool layoutGenerated = false;
+// Rendered eye: interpolated each frame between the last two simulation ticks of simCamera
 glm::vec3 cameraPos   = glm::vec3(0.0f, 2.0f, 10.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp    = glm::vec3(0.0f, 1.0f, 0.0f);
-float yawDeg = -90.0f; // facing -Z initially
-float pitchDeg = 0.0f; // level pitch
+// Camera as the fixed-step simulation moves it (frame_clock.h), and as it was one tick earlier
+struct CameraState { glm::vec3 position; float yawDeg, pitchDeg; };
+const CameraState kStartCamera = { glm::vec3(0.0f, 2.0f, 10.0f), -90.0f, 0.0f }; // facing -Z, level
+CameraState simCamera = kStartCamera, prevSimCamera = kStartCamera;
+FrameClock frameClock;
+FramePacing framePacing = PACING_VSYNC;
+FrameLimiter frameLimiter;
 
 Model treeModel;
 Model fountainModel; // OBJ-based fountain
@@ -72,36 +114,193 @@ bool useProceduralFountain = false; // fallback if OBJ not found
 // Procedural fountain replaces OBJ fountain
 // Ground is procedural (quad), not a Model
 
-GLuint shaderProgram;
+ShaderProgram shaderProgram; // forest.vert + fragment_shader.glsl, uniform locations cached at link time
+ShaderProgram rigidShaderProgram; // forest.vert +UNIFORM_SCALE: hedges and batched meshes, no normal matrix
+ShaderProgram treeShaderProgram; // forest.vert +INSTANCED (instanced trees)
+// Alpha-tested leaves (fragment_shader.glsl +ALPHA_TEST); every other program keeps early-Z
+ShaderProgram leafShaderProgram;     // forest.vert +ALPHA_TEST (per-tree cones)
+ShaderProgram treeLeafShaderProgram; // forest.vert +INSTANCED +ALPHA_TEST (instanced cones)
+// Opaque 3D pass ordering (render_queue.h): X toggles front-to-back sorting, Z the depth pre-pass
+RenderQueue renderQueue;
+glm::mat4 frameView(1.0f), frameProjection(1.0f); // this frame's 3D camera, for queue callbacks
+// Procedural forest streamed in chunks around the design square (world_chunks.h); G toggles it
+ChunkedWorld chunkedWorld;
+bool worldChunksEnabled = false;
+ShaderProgram fireflyShaderProgram; // firefly.vert + firefly.frag (GPU-animated fireflies)
 GLuint fireflyVAO;
+GLuint fireflyInstanceVBO = 0; // per-firefly data of the visible fireflies
+std::vector<float> fireflyInstanceData; // static per-firefly data (8 floats each), built by initFireflies
+std::vector<unsigned int> uploadedFireflies; // firefly indices currently in fireflyInstanceVBO
 GLuint groundVAO = 0, groundVBO = 0, groundEBO = 0;
-GLuint groundTextures[3] = {0,0,0};
-int currentGroundTex = 0; // 0: grass, 1: moss, 2: purple
-GLuint pathTexture = 0;
+// Small tiling textures packed into one GL_TEXTURE_2D_ARRAY on unit 1; draws pick a layer through
+// the textureLayer uniform instead of rebinding. The first three layers are the T/M ground choices.
+enum SceneLayer { LAYER_GRASS, LAYER_MOSS, LAYER_PURPLE, LAYER_PATH, LAYER_TRUNK, LAYER_LEAVES, LAYER_COUNT };
+// Material block entries (uniform_blocks.h): first a textured material for texture_diffuse1 and
+// each scene layer (looked up with textureMaterial), then the procedural fountain's solid colours
+enum SceneMaterial {
+    MATERIAL_STONE_PLINTH = LAYER_COUNT + 1, MATERIAL_STONE, MATERIAL_STONE_RIM, MATERIAL_WATER
+};
+const char* kSceneLayerPaths[LAYER_COUNT] = {
+    "Models/grass.png", "Models/moss.png", "Models/purple.png", "Models/path.png", "Models/trunk.png", "Models/leaves.png"
+};
+const int kSceneLayerSize = 64; // moss/trunk/leaves size; the 16x16 tiles are resampled up
+const int kSceneTextureUnit = 1; // unit 0 stays GL_TEXTURE_2D for texture_diffuse1 (fountain OBJ)
+GLuint sceneTextures = 0;
+int currentGroundTex = 0; // 0: grass, 1: moss, 2: purple (= ground layer)
 GLuint pathVAO = 0, pathVBO = 0, pathEBO = 0;
+GLsizei pathIndexCount = 0;
 // Accurate layout-based path mesh (built from Bresenham grid cells)
 GLuint layoutPathVAO = 0, layoutPathVBO = 0, layoutPathEBO = 0;
 GLsizei layoutPathIndexCount = 0;
 GLuint treeSpriteTex = 0, fountainSpriteTex = 0;
-GLuint trunkTexture = 0, leavesTexture = 0;
 float groundRepeat = 4.0f; // UV tiling factor for ground texture
 // Dynamic path width (half extent from center line in world units)
 float pathHalfWidth = 0.3f;
 // Circular walkway ring geometry around fountain
 GLuint ringVAO = 0, ringVBO = 0, ringEBO = 0;
 GLsizei ringIndexCount = 0;
+int ringSampleRadius = 0; // midpoint-circle radius the ring topology was sampled at (0: not built)
+ShaderProgram ringShaderProgram; // ring.vert + fragment_shader.glsl (radii applied in the shader)
+// Allocated byte capacity of the rebuildable meshes' buffers; growth reallocates, otherwise
+// rebuilds go through glBufferSubData
+GLsizeiptr pathVBOCap = 0, pathEBOCap = 0;
+GLsizeiptr layoutPathVBOCap = 0, layoutPathEBOCap = 0;
+GLsizeiptr ringVBOCap = 0, ringEBOCap = 0;
+// Deferred mesh rebuilds: input handlers set bits, flushMeshRebuilds() runs each rebuild at most
+// once per frame before the 3D pass
+enum MeshDirtyBits {
+    MESH_DIRTY_PATH_STYLE    = 1 << 0, // stylized path (P)
+    MESH_DIRTY_LAYOUT_PATH   = 1 << 1, // accurate Bresenham path ribbon
+    MESH_DIRTY_RING_TOPOLOGY = 1 << 2, // ring sample count (radii themselves are uniforms)
+    MESH_DIRTY_HEDGES        = 1 << 3  // wedge templates (scale is in the model matrix)
+};
+unsigned int meshDirty = 0;
+inline void markMeshesDirty(unsigned int bits) { meshDirty |= bits; }
+// Static scene batch (B toggles): ground, path, ring, hedges and the fountain OBJ from one arena
+SceneBatch staticBatch;
+ShaderProgram batchShaderProgram; // scene_batch.vert + fragment_shader.glsl (multi-draw path only)
+bool staticBatching = true;
+unsigned int staticMeshRevision = 0;    // bumped whenever a mesh copied into the arena is rebuilt
+unsigned int staticBatchRevision = ~0u; // revision last packed (~0: never)
+// The fountain OBJ takes one slot per LOD (SLOT_FOUNTAIN + lod), sharing its vertices
+enum StaticBatchSlot { SLOT_GROUND, SLOT_PATH, SLOT_RING, SLOT_WEDGE_INNER, SLOT_WEDGE_OUTER, SLOT_FOUNTAIN,
+                       SLOT_COUNT = SLOT_FOUNTAIN + kMaxMeshLods };
 // Fountain scale used for procedural fountain and ring radius
 float fountainScale = 0.35f;
 
-// Procedural tree geometry (trunk cylinder + foliage cone)
+// Procedural tree geometry (trunk cylinder + foliage cone). Each buffer holds kTreeLods levels
+// (full, 1/2, 1/4 of the segments) back to back; LOD 0 starts at index 0, so trunkIndexCount /
+// coneIndexCount draws stay full detail (the procedural fountain).
+const int kTreeLods = 3;
 GLuint trunkVAO=0, trunkVBO=0, trunkEBO=0; GLsizei trunkIndexCount=0;
 GLuint coneVAO=0, coneVBO=0, coneEBO=0; GLsizei coneIndexCount=0;
+MeshLod trunkLods[kTreeLods] = {}, coneLods[kTreeLods] = {};
+// Per-instance tree data (vec4: x, z, size base, yaw offset) shared by trunkVAO and coneVAO
+GLuint treeInstanceVBO = 0;
+GLsizei treeInstanceCount = 0;
+unsigned int treeInstanceRevision = ~0u; // revision last uploaded (~0: never)
+GLsizeiptr treeInstanceVBOCap = 0;
+std::vector<unsigned int> visibleTrees;  // treeStore indices that passed culling this frame
+std::vector<unsigned int> uploadedTrees; // indices currently in treeInstanceVBO
+bool instancedTrees = true; // N toggles instanced / per-tree draws
+// ----------------- Level of detail -----------------
+// Chosen per object each 3D frame from its projected bounding-sphere diameter (lod.h)
+bool lodEnabled = true; // H toggles
+const float kTreeLodMinPx[kTreeLods - 1] = { 160.0f, 96.0f };
+const float kFountainLodMinPx[kMaxMeshLods - 1] = { 240.0f, 120.0f, 60.0f };
+std::vector<int8_t> treeLods; // per treeStore entry, kept across frames for the hysteresis
+int fountainLod = 0;
+// Impostor tier below the lowest tree LOD: instanced camera-facing quads sampling treeImpostor.
+// Between kImpostorStartPx and kImpostorEndPx (projected tree diameter) the lowest LOD and the
+// impostor crossfade through complementary dither patterns (fragment_shader.glsl +LOD_FADE); the
+// shaders measure it per instance as camera distance per unit of size base.
+const float kImpostorStartPx = 64.0f, kImpostorEndPx = 52.0f;
+const int kImpostorNormalUnit = 2; // units 0/1: texture_diffuse1 (albedo atlas) / scene array
+ImpostorAtlas treeImpostor;
+bool treeImpostorPending = true; // captured once the tree textures are resident
+ShaderProgram impostorShaderProgram;     // impostor.vert + fragment_shader.glsl +IMPOSTOR +ALPHA_TEST +LOD_FADE
+ShaderProgram treeFadeShaderProgram;     // forest.vert +INSTANCED +LOD_FADE (trunks in the fade band)
+ShaderProgram treeLeafFadeShaderProgram; // ... +ALPHA_TEST (cones in the fade band)
+GLuint impostorVAO = 0, impostorQuadVBO = 0;
+struct ImpostorFade { float start, end; }; // in camera distance per unit of size base
+ImpostorFade impostorFade = { 0.0f, 0.0f };
+// visibleTrees is grouped: one group per geometric LOD, then the trees crossfading between the
+// lowest LOD and their impostor, then impostor-only trees. Group g starts at treeGroupStart[g]
+// (also its instance offset); the impostor draw covers the last two groups.
+enum TreeGroup { TREE_GROUP_FADE = kTreeLods, TREE_GROUP_IMPOSTOR, TREE_GROUP_COUNT };
+std::vector<int8_t> treeGroups; // per treeStore entry, this frame
+GLsizei treeGroupStart[TREE_GROUP_COUNT] = {}, treeGroupCount[TREE_GROUP_COUNT] = {};
+GLsizei uploadedGroupCount[TREE_GROUP_COUNT] = {};
+// ----------------- Shadows -----------------
+// Cascaded shadow maps of the directional light (shadow_map.h). The casters are drawn through the
+// instanced tree path and the static batch with depth-only permutations (fragment_shader.glsl
+// +SHADOW_CASTER), each cascade culled against its own light frustum.
+const glm::vec3 kLightDir = glm::vec3(-0.5f, -1.0f, -0.3f);
+const int kShadowMapUnit = 3; // sampler2DArrayShadow; units 0-2: diffuse, scene array, impostor normals
+ShadowMaps shadowMaps;
+bool shadowsEnabled = true; // Y toggles
+ShaderProgram shadowMeshProgram;  // forest.vert +SHADOW_CASTER (procedural fountain)
+ShaderProgram shadowRigidProgram; // forest.vert +UNIFORM_SCALE +SHADOW_CASTER (batch fallback loop)
+ShaderProgram shadowBatchProgram; // scene_batch.vert +SHADOW_CASTER (multi-draw path only)
+ShaderProgram shadowTreeProgram;  // forest.vert +INSTANCED +SHADOW_CASTER (trunks)
+ShaderProgram shadowLeafProgram;  // ... +ALPHA_TEST (cones)
+// Each cascade's tree casters, refilled whenever that cascade renders
+GLuint shadowTreeVBO[kShadowCascades] = {};
+GLsizeiptr shadowTreeVBOCap[kShadowCascades] = {};
+std::vector<unsigned int> shadowTrees;
+std::vector<float> shadowTreeData;
 // Global tree scale factor (applies to all 3D trees)
 float treeScaleFactor = 2.0f;
 // Separate transform controls for fountain and trees
 float fountainGlobalScale = 1.0f;
 float fountainYawDeg = 0.0f; // yaw-only
 float treeGlobalScale = 1.2f; // default trees scaled to 1.2x
+
+// ----------------- Culling -----------------
+// Exp2 fog density shared by the frame block (setSceneUniforms) and the fog-distance cull
+float fogDensity = 0.015f;
+bool cullingEnabled = true; // C toggles frustum/fog culling
+struct CullCounts {
+    int visible = 0;
+    int frustumCulled = 0;
+    int distanceCulled = 0; // beyond full fog (fireflies: beyond their fade-out distance)
+};
+// Counts from the last 3D frame, per object category
+struct CullStats { CullCounts trees, hedges, fireflies, fountain, chunks; };
+CullStats cullStats;
+Frustum viewFrustum;
+float fogCullDist = 0.0f;
+// Fireflies bob 0.3 and drift 0.1 around their rest position (firefly.vert), cube half-size 0.05
+const float kFireflyCullRadius = 0.45f;
+const float kFireflyFadeDistance = 20.0f; // firefly.vert fades them out completely here
+
+// Start a 3D frame: extract the frustum planes and reset the counts
+static void beginCullFrame(const glm::mat4& view, const glm::mat4& projection) {
+    viewFrustum.extract(projection * view);
+    fogCullDist = fogCullDistance(fogDensity);
+    cullStats = CullStats();
+}
+
+// True if the sphere should be drawn; records the outcome in counts
+static bool cullSphere(const BoundingSphere& s, CullCounts& counts, float maxDistance) {
+    if (!cullingEnabled) { counts.visible++; return true; }
+    if (glm::length(s.center - cameraPos) - s.radius > maxDistance) { counts.distanceCulled++; return false; }
+    if (!viewFrustum.intersectsSphere(s)) { counts.frustumCulled++; return false; }
+    counts.visible++;
+    return true;
+}
+
+static void logCullStats() {
+    auto logLine = [](const char* name, const CullCounts& c){
+        std::cout << "[Info] Cull " << name << ": " << c.visible << " visible, " << c.frustumCulled
+                  << " outside frustum, " << c.distanceCulled << " beyond fog/fade\n";
+    };
+    logLine("trees    ", cullStats.trees);
+    logLine("hedges   ", cullStats.hedges);
+    logLine("fireflies", cullStats.fireflies);
+    logLine("fountain ", cullStats.fountain);
+    logLine("chunks   ", cullStats.chunks);
+}
 float treeYawDeg = 0.0f;     // yaw-only
 // Hedge scale follows fountain (uniform XYZ)
 // Hedge wedges are kept slightly smaller (0.8) relative to fountain global scale
@@ -118,6 +317,8 @@ float hedgeHeight = 0.4f;
 // Wedge templates (built after GL init)
 GLuint wedgeVAO1=0, wedgeVBO1=0, wedgeEBO1=0; GLsizei wedgeIdx1=0;
 GLuint wedgeVAO2=0, wedgeVBO2=0, wedgeEBO2=0; GLsizei wedgeIdx2=0;
+// Parameters the wedge templates were last built with; buildHedgeMeshes is a no-op while unchanged
+float wedgeBuiltParams[7] = {0,0,0,0,0,0,-1.0f};
 
 struct Firefly {
     glm::vec3 position;
@@ -128,10 +329,6 @@ struct Firefly {
     float blinkSpeed;
 };
 std::vector<Firefly> fireflies;
-// Maintain per-tree radial margin to the outer circular hedge boundary so distance stays constant across scaling
-static std::vector<float> treeOuterMargin; // margin = r - (wedgeROuter2 * hedgeGlobalScale) at time of placement
-// Maintain per-tree constant radial gap to fountain footprint so tree-fountain distance stays stable across fountain scaling
-static std::vector<float> treeFountainGap; // gap = r - (fountainScale * fountainGlobalScale * 1.1f) at placement
 
 // ----------------- 2D Blueprint State -----------------
 enum ViewMode { VIEW_2D, VIEW_3D };
@@ -157,36 +354,175 @@ static bool isKeyPressedOnce(GLFWwindow* w, int key) {
     return state == GLFW_PRESS && prev != GLFW_PRESS;
 }
 
+// View direction for a yaw/pitch pair in degrees (yaw -90 looks down -Z)
+static glm::vec3 cameraFrontFrom(float yawDeg, float pitchDeg) {
+    float yawRad = glm::radians(yawDeg); float pitchRad = glm::radians(pitchDeg);
+    return glm::normalize(glm::vec3(cos(yawRad) * cos(pitchRad), sin(pitchRad), sin(yawRad) * cos(pitchRad)));
+}
+
+// Frame profiler bar (F1)
+bool showProfiler = false;
+
+// Offscreen render target for --bench --offscreen (hidden window, nothing presented)
+GLuint benchFBO = 0, benchColorRB = 0, benchDepthRB = 0;
+
+static bool createOffscreenTarget(int width, int height) {
+    glGenFramebuffers(1, &benchFBO);
+    glGenRenderbuffers(1, &benchColorRB);
+    glGenRenderbuffers(1, &benchDepthRB);
+    glBindFramebuffer(GL_FRAMEBUFFER, benchFBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, benchColorRB);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, benchColorRB);
+    glBindRenderbuffer(GL_RENDERBUFFER, benchDepthRB);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, benchDepthRB);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete) glBindFramebuffer(GL_FRAMEBUFFER, 0); // fall back to the (hidden) window
+    glViewport(0, 0, width, height);
+    return complete;
+}
+
 // Debug flash indicator
 float debugFlash = 0.0f;
 glm::vec3 debugColor(1.0f, 1.0f, 1.0f);
 static void debugFlashPing(const glm::vec3& c) { debugColor = c; debugFlash = 0.25f; }
 
+// ----------------- Occupancy -----------------
+// Hedge disk, wedge footprints, fountain disk and path cells rasterized once into one grid that
+// tree placement, path meshing and the 2D overlay all query. Rebuilt lazily when the hedge
+// scale, fountain radius or layout changes.
+OccupancyGrid occupancy;
+int occupancySubdivisions = 5; // samples per design cell along each axis (odd keeps cell centres exact)
+unsigned int layoutRevision = 0; // bumped whenever layoutPaths / hedgeWedgeTris are regenerated
+struct OccupancyKey { unsigned int layoutRev; int fountainRadius; float hedgeScale; int sub; };
+OccupancyKey occupancyKey;
+bool occupancyValid = false;
+
+// Fountain radius in design-grid cells, from the 2D overlay pixel radius
+static int fountainGridRadius() {
+    return std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
+}
+
+// Everything the grid is rasterized from, copied so worker jobs can rebuild their own grid
+struct OccupancyInputs {
+    int gridW, gridH, sub;
+    float hedgeDiskR, fountainDiskR; // world units
+    std::vector<Tri> wedgeTris;
+    std::vector<LayoutPath> paths;
+};
+
+static OccupancyInputs occupancyInputs() {
+    return OccupancyInputs{ designGridW, designGridH, occupancySubdivisions, wedgeROuter2 * hedgeGlobalScale,
+                            fountainGridRadius() * (20.0f / (float)designGridW), hedgeWedgeTris, layoutPaths };
+}
+
+// Pure function of its inputs (safe on a worker)
+static void rasterizeOccupancy(OccupancyGrid& grid, const OccupancyInputs& in) {
+    grid.reset(in.gridW, in.gridH, in.sub);
+    grid.fillDisk(glm::vec2(0.0f), in.hedgeDiskR, OCC_HEDGE_DISK);
+    grid.fillDisk(glm::vec2(0.0f), in.fountainDiskR, OCC_FOUNTAIN_DISK);
+    for (auto &tri : in.wedgeTris) grid.fillTriangle(tri.a, tri.b, tri.c, OCC_HEDGE_WEDGE);
+    for (auto &lp : in.paths) grid.markLine(lp.a, lp.b, OCC_PATH);
+}
+
+static const OccupancyGrid& currentOccupancy() {
+    OccupancyKey key{layoutRevision, fountainRadius, hedgeGlobalScale, occupancySubdivisions};
+    if (occupancyValid && key.layoutRev == occupancyKey.layoutRev && key.fountainRadius == occupancyKey.fountainRadius
+        && key.hedgeScale == occupancyKey.hedgeScale && key.sub == occupancyKey.sub) return occupancy;
+    rasterizeOccupancy(occupancy, occupancyInputs());
+    occupancyKey = key;
+    occupancyValid = true;
+    return occupancy;
+}
+
 // Forbid planting inside wedges' outer circle or inside wedge triangle footprints
 static bool isForbiddenAtWorld(float wx, float wz) {
     // Returns true if a world position lies in a forbidden region:
     // - inside the hedges' outer disk
     // - inside any star hedge wedge triangle footprint
-    // Outer circle check against current wedges' outer radius
-    float r2 = wx*wx + wz*wz;
-    float outerR = wedgeROuter2 * hedgeGlobalScale;
-    if (outerR > 0.0f && r2 <= outerR*outerR) return true;
-    // Triangle footprint check
-    auto pointInTri2 = [](const glm::vec2& p, const Tri& t){
-        auto sign=[&](const glm::vec2& p1,const glm::vec2& p2,const glm::vec2& p3){ return (p1.x - p3.x)*(p2.y - p3.y) - (p2.x - p3.x)*(p1.y - p3.y); };
-        float d1 = sign(p, t.a, t.b), d2 = sign(p, t.b, t.c), d3 = sign(p, t.c, t.a);
-        bool hasNeg = (d1<0) || (d2<0) || (d3<0);
-        bool hasPos = (d1>0) || (d2>0) || (d3>0);
-        return !(hasNeg && hasPos);
-    };
-    glm::vec2 p(wx, wz);
-    for (auto &tri : hedgeWedgeTris) { if (pointInTri2(p, tri)) return true; }
-    return false;
+    return (currentOccupancy().atWorld(wx, wz) & OCC_FORBIDDEN) != 0;
+}
+
+// ----------------- Tree spacing -----------------
+// Minimum distance between auto-placed trees (Poisson-disk radius, also the hash cell size)
+float treeMinSpacing = 1.8f;
+// Minimum distance from existing trees for mouse planting
+float plantMinSpacing = 0.5f;
+// Seed for the deterministic tree placement RNG (prompted at bootstrap)
+int layoutSeed = 1337;
+// srand() seed for the fireflies (1 = the C runtime's own start state)
+unsigned int fireflySeed = 1;
+SpatialHash2D treeHash;
+unsigned int treeHashRevision = ~0u; // treeRevision the hash was built for
+
+// Spatial hash over treeStore, rebuilt when trees were moved since the last query
+static const SpatialHash2D& currentTreeHash() {
+    if (treeHashRevision != treeRevision) {
+        treeHash.reset(treeMinSpacing);
+        for (size_t i = 0; i < treeStore.count(); ++i) treeHash.insert(treeStore.pos(i));
+        treeHashRevision = treeRevision;
+    }
+    return treeHash;
 }
 
 // ----------------- Helper Functions -----------------
+// After a fountain scale step: each tree keeps its fountain gap, or its hedge margin where that
+// reaches further out, in one batched pass over treeStore
+static void keepTreeGaps() {
+    RadialConstraint c;
+    c.fountainFoot = fountainScale * fountainGlobalScale * 1.1f;
+    c.hedgeOuter = wedgeROuter2 * hedgeGlobalScale;
+    c.minRadius = 1e-5f;
+    applyRadialConstraint(treeStore, c);
+    treeRevision++;
+}
+
 void placeTree(float x, float y, TreeSize sz = Medium) {
-    treeInstances.push_back(TreeInst{glm::vec2(x, y), sz});
+    // Margins from the current hedge / fountain radii, as the layout gives its trees
+    float r = glm::length(glm::vec2(x, y));
+    treeStore.add(x, y, (uint8_t)sz, std::max(0.0f, r - wedgeROuter2 * hedgeGlobalScale),
+                  std::max(0.0f, r - fountainScale * fountainGlobalScale * 1.1f));
+    // Keep an up-to-date hash current instead of rebuilding it on the next query
+    bool hashCurrent = (treeHashRevision == treeRevision);
+    treeRevision++;
+    if (hashCurrent) { treeHash.insert(glm::vec2(x, y)); treeHashRevision = treeRevision; }
+}
+
+// Size multiplier shared by the per-tree and instanced paths
+static float treeSizeBase(TreeSize sz) {
+    return (sz==Small?0.9f:(sz==Medium?1.2f:1.7f));
+}
+
+// Tree part dimensions per unit of size base (multiply by treeSizeBase)
+struct TreeDims { float trunkH, trunkR, coneH, coneR; };
+static TreeDims treeUnitDims() {
+    float fScale = fountainScale;
+    float k = treeScaleFactor * treeGlobalScale;
+    return TreeDims{ (fScale * 3.0f) * k, (0.10f * fScale * 1.2f) * k, (fScale * 2.4f) * k, (0.24f * fScale * 1.8f) * k };
+}
+
+// Yaw-only rotation and scale given to the OBJ fountain before it is drawn
+static void applyFountainTransform() {
+    fountainModel.rotation.y = glm::radians(fountainYawDeg);
+    fountainModel.rotation.x = 0.0f;
+    fountainModel.rotation.z = 0.0f;
+    fountainModel.scale = glm::vec3(0.5f * fountainGlobalScale);
+}
+
+// Bounding sphere of the fountain that is drawn: OBJ bounds from the Model, or the procedural stack
+static BoundingSphere fountainBounds() {
+    if (useProceduralFountain) {
+        // Plinth (radius 0.60*s) is the widest part, the finial tip sits at 1.42*s
+        float s = fountainScale * fountainGlobalScale;
+        return BoundingSphere{ glm::vec3(0.0f, 0.71f * s, 0.0f), s * std::sqrt(0.71f*0.71f + 0.60f*0.60f) };
+    }
+    float k = 0.5f * fountainGlobalScale; // same scale the 3D pass gives fountainModel
+    float halfH = 0.5f * (fountainModel.maxY - fountainModel.minY) * k;
+    float r = fountainModel.radiusXZ * k;
+    glm::vec3 c = fountainModel.position + glm::vec3(0.0f, 0.5f * (fountainModel.minY + fountainModel.maxY) * k, 0.0f);
+    return BoundingSphere{ c, std::sqrt(halfH*halfH + r*r) };
 }
 
 void mouseCallback(GLFWwindow* window, int button, int action, int mods) {
@@ -199,6 +535,10 @@ void mouseCallback(GLFWwindow* window, int button, int action, int mods) {
             debugFlashPing(glm::vec3(1.0f, 0.3f, 0.3f)); // red flash for invalid placement
             return;
         }
+        if (currentTreeHash().anyWithin(glm::vec2(worldX, worldY), plantMinSpacing)) {
+            debugFlashPing(glm::vec3(1.0f, 0.6f, 0.2f)); // orange flash: too close to an existing tree
+            return;
+        }
         placeTree(worldX, worldY, Medium);
     }
 }
@@ -216,6 +556,28 @@ void initFireflies(int count) {
         f.blinkSpeed = 1.0f + static_cast<float>(rand()%100)/100.0f;
         fireflies.push_back(f);
     }
+
+    // Two vec4s per firefly (locations 3 and 4, divisor 1). The buffer starts with all of them;
+    // drawFireflies compacts it to the visible subset when culling changes that set.
+    std::vector<float>& data = fireflyInstanceData;
+    data.clear();
+    data.reserve(fireflies.size() * 8);
+    uploadedFireflies.clear();
+    for (auto& f : fireflies) {
+        uploadedFireflies.push_back((unsigned int)(data.size() / 8));
+        data.insert(data.end(), {f.position.x, f.position.y, f.position.z, f.phase,
+                                 f.driftPhaseX, f.driftPhaseZ, f.blinkPhase, f.blinkSpeed});
+    }
+    if (!fireflyInstanceVBO) glGenBuffers(1, &fireflyInstanceVBO);
+    bindVertexArray(fireflyVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, fireflyInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, data.size()*sizeof(float), data.empty() ? nullptr : data.data(), GL_DYNAMIC_DRAW);
+    glVertexAttribPointer(3,4,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(3);
+    glVertexAttribPointer(4,4,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(4*sizeof(float))); glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(3, 1);
+    glVertexAttribDivisor(4, 1);
+    bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void createGroundPlane() {
@@ -228,27 +590,28 @@ void createGroundPlane() {
          20.0f, 0.0f,  20.0f,  0,1,0,        groundRepeat,  groundRepeat,
         -20.0f, 0.0f,  20.0f,  0,1,0,        0.0f,          groundRepeat
     };
-    unsigned int indices[] = { 0,1,2, 2,3,0 };
+    unsigned int indices[] = { 0,1,2, 2,3,0 }; // vertices are converted to meshVertexFormat on upload
 
     glGenVertexArrays(1, &groundVAO);
     glGenBuffers(1, &groundVBO);
     glGenBuffers(1, &groundEBO);
 
-    glBindVertexArray(groundVAO);
+    bindVertexArray(groundVAO);
     glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    uploadVertices(vertices, 4, GL_STATIC_DRAW);
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groundEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void*)(3*sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void*)(6*sizeof(float)));
-    glEnableVertexAttribArray(2);
+    applyVertexFormat();
+
+    bindVertexArray(0);
+}
 
-    glBindVertexArray(0);
+// Ground tiles of the chunked world continue the authored quad's tiling (seamless while
+// groundRepeat * chunkWorld / 40 is whole)
+static float chunkGroundRepeat() {
+    return groundRepeat * chunkedWorld.chunkWorld() / 40.0f;
 }
 
 // Update ground UVs when tiling factor changes
@@ -261,76 +624,277 @@ void updateGroundUVRepeat() {
          20.0f, 0.0f,  20.0f,  0,1,0,        groundRepeat,  groundRepeat,
         -20.0f, 0.0f,  20.0f,  0,1,0,        0.0f,          groundRepeat
     };
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    std::vector<unsigned char> encoded = encodeVertices(vertices, 4);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)encoded.size(), encoded.data());
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    staticMeshRevision++; // the static batch holds a copy
+    chunkedWorld.setGroundRepeat(chunkGroundRepeat());
 }
 
 // Create a simple cylinder along Y axis: height 1, radius r
 static void createCylinder(float r, int segments) {
     // Builds a unit-height Y-aligned cylinder mesh (two triangle strips stitched into quads)
-    // r: base radius in local space; segments: angular tessellation
+    // r: base radius in local space; segments: angular tessellation of LOD 0, halved per level
     if (trunkVAO) return;
     std::vector<float> verts; std::vector<unsigned int> idx;
-    for (int i=0;i<=segments;i++) {
-        float t = (float)i/segments; float ang = t * 6.2831853f;
-        float x = r * cosf(ang), z = r * sinf(ang);
-        glm::vec3 n = glm::normalize(glm::vec3(x,0.0f,z));
-        // bottom
-        verts.insert(verts.end(), {x,0.0f,z, n.x,n.y,n.z, t,0.0f});
-        // top
-        verts.insert(verts.end(), {x,1.0f,z, n.x,n.y,n.z, t,1.0f});
-    }
-    for (int i=0;i<segments;i++) {
-        unsigned int b0=i*2, t0=b0+1, b1=(i+1)*2, t1=b1+1;
-        idx.insert(idx.end(), {b0,t0,t1, b0,t1,b1});
+    for (int lod = 0; lod < kTreeLods; ++lod) {
+        int seg = std::max(3, segments >> lod);
+        unsigned int first = (unsigned int)(verts.size()/8);
+        trunkLods[lod].firstIndex = (uint32_t)idx.size();
+        for (int i=0;i<=seg;i++) {
+            float t = (float)i/seg; float ang = t * 6.2831853f;
+            float x = r * cosf(ang), z = r * sinf(ang);
+            glm::vec3 n = glm::normalize(glm::vec3(x,0.0f,z));
+            // bottom
+            verts.insert(verts.end(), {x,0.0f,z, n.x,n.y,n.z, t,0.0f});
+            // top
+            verts.insert(verts.end(), {x,1.0f,z, n.x,n.y,n.z, t,1.0f});
+        }
+        for (int i=0;i<seg;i++) {
+            unsigned int b0=first+i*2, t0=b0+1, b1=first+(i+1)*2, t1=b1+1;
+            idx.insert(idx.end(), {b0,t0,t1, b0,t1,b1});
+        }
+        trunkLods[lod].indexCount = (uint32_t)idx.size() - trunkLods[lod].firstIndex;
     }
     glGenVertexArrays(1,&trunkVAO); glGenBuffers(1,&trunkVBO); glGenBuffers(1,&trunkEBO);
-    glBindVertexArray(trunkVAO);
+    bindVertexArray(trunkVAO);
     glBindBuffer(GL_ARRAY_BUFFER, trunkVBO);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
+    uploadVertices(verts.data(), verts.size()/8, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, trunkEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size()*sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
-    trunkIndexCount = (GLsizei)idx.size();
+    applyVertexFormat();
+    bindVertexArray(0);
+    trunkIndexCount = (GLsizei)trunkLods[0].indexCount;
 }
 
 // Create a cone along Y axis: base at 0 radius r, apex at 1
 static void createCone(float r, int segments) {
-    // Builds a Y-aligned cone mesh with base at y=0 and apex at y=1
+    // Builds a Y-aligned cone mesh with base at y=0 and apex at y=1; segments halve per LOD
     if (coneVAO) return;
     std::vector<float> verts; std::vector<unsigned int> idx;
-    for (int i=0;i<=segments;i++) {
-        float t = (float)i/segments; float ang = t * 6.2831853f;
-        float x = r * cosf(ang), z = r * sinf(ang);
-        glm::vec3 n = glm::normalize(glm::vec3(x, r, z));
-        verts.insert(verts.end(), {x,0.0f,z, n.x,n.y,n.z, t,0.0f});
-    }
-    unsigned int apex = (unsigned int)(verts.size()/8);
-    verts.insert(verts.end(), {0.0f,1.0f,0.0f, 0.0f,1.0f,0.0f, 0.5f,1.0f});
-    for (int i=0;i<segments;i++) { unsigned int b0=i, b1=i+1; idx.insert(idx.end(), {b0,apex,b1}); }
+    for (int lod = 0; lod < kTreeLods; ++lod) {
+        int seg = std::max(3, segments >> lod);
+        unsigned int first = (unsigned int)(verts.size()/8);
+        coneLods[lod].firstIndex = (uint32_t)idx.size();
+        for (int i=0;i<=seg;i++) {
+            float t = (float)i/seg; float ang = t * 6.2831853f;
+            float x = r * cosf(ang), z = r * sinf(ang);
+            glm::vec3 n = glm::normalize(glm::vec3(x, r, z));
+            verts.insert(verts.end(), {x,0.0f,z, n.x,n.y,n.z, t,0.0f});
+        }
+        unsigned int apex = (unsigned int)(verts.size()/8);
+        verts.insert(verts.end(), {0.0f,1.0f,0.0f, 0.0f,1.0f,0.0f, 0.5f,1.0f});
+        for (int i=0;i<seg;i++) { unsigned int b0=first+i, b1=first+i+1; idx.insert(idx.end(), {b0,apex,b1}); }
+        coneLods[lod].indexCount = (uint32_t)idx.size() - coneLods[lod].firstIndex;
+    }
     glGenVertexArrays(1,&coneVAO); glGenBuffers(1,&coneVBO); glGenBuffers(1,&coneEBO);
-    glBindVertexArray(coneVAO);
+    bindVertexArray(coneVAO);
     glBindBuffer(GL_ARRAY_BUFFER, coneVBO);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
+    uploadVertices(verts.data(), verts.size()/8, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, coneEBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size()*sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
-    coneIndexCount = (GLsizei)idx.size();
+    applyVertexFormat();
+    bindVertexArray(0);
+    coneIndexCount = (GLsizei)coneLods[0].indexCount;
+}
+
+// Instance attribute 3 of the bound VAO: vec4s of instanceVBO from firstInstance on
+static void bindTreeInstances(GLuint instanceVBO, GLsizei firstInstance) {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glVertexAttribPointer(3,4,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)(uintptr_t)(firstInstance * 4 * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Attach one per-instance vec4 buffer (location 3, divisor 1) to both tree part VAOs
+static void createTreeInstanceBuffer() {
+    if (treeInstanceVBO) return;
+    glGenBuffers(1, &treeInstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, treeInstanceVBO);
+    GLuint vaos[2] = { trunkVAO, coneVAO };
+    for (GLuint vao : vaos) {
+        bindVertexArray(vao);
+        glVertexAttribPointer(3,4,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)0); glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+    }
+    bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Fill visibleTrees with the trees whose bounding sphere (trunk base to cone tip) survives culling
+static BoundingSphere treeBounds(const TreeInst& ti, const TreeDims& u) {
+    float halfH = 0.5f * (u.trunkH + u.coneH);
+    float maxR = std::max(u.trunkR, u.coneR);
+    float base = treeSizeBase(ti.size);
+    return BoundingSphere{ glm::vec3(ti.pos.x, halfH * base, ti.pos.y), std::sqrt(halfH*halfH + maxR*maxR) * base };
+}
+
+static void cullTrees() {
+    visibleTrees.clear();
+    TreeDims u = treeUnitDims();
+    for (size_t i = 0; i < treeStore.count(); ++i) {
+        if (cullSphere(treeBounds(treeAt(i), u), cullStats.trees, fogCullDist)) visibleTrees.push_back((unsigned int)i);
+    }
+}
+
+// Re-upload instance data only when trees were added or moved, or the visible set or its LOD
+// grouping changed, since the last upload
+static void updateTreeInstanceBuffer() {
+    if (treeInstanceRevision == treeRevision && uploadedTrees == visibleTrees &&
+        std::equal(treeGroupCount, treeGroupCount + TREE_GROUP_COUNT, uploadedGroupCount)) return;
+    const float sizeBase[3] = { treeSizeBase(Small), treeSizeBase(Medium), treeSizeBase(Tall) };
+    GLsizeiptr bytes = (GLsizeiptr)(visibleTrees.size() * 4 * sizeof(float));
+    glBindBuffer(GL_ARRAY_BUFFER, treeInstanceVBO);
+    if (bytes > treeInstanceVBOCap) {
+        treeInstanceVBOCap = bytes + bytes / 2;
+        glBufferData(GL_ARRAY_BUFFER, treeInstanceVBOCap, nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (bytes > 0) {
+        // Packed from treeStore straight into the buffer; invalidating lets the driver hand out
+        // fresh storage instead of waiting on draws that still read the old instances
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (dst) packTreeInstances(treeStore, visibleTrees.data(), visibleTrees.size(), sizeBase, static_cast<float*>(dst));
+        // glUnmapBuffer fails if the storage was lost meanwhile (e.g. a mode switch); upload a copy
+        if (!dst || !glUnmapBuffer(GL_ARRAY_BUFFER)) {
+            std::vector<float> data(visibleTrees.size() * 4);
+            packTreeInstances(treeStore, visibleTrees.data(), visibleTrees.size(), sizeBase, data.data());
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data.data());
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    treeInstanceCount = (GLsizei)visibleTrees.size();
+    uploadedTrees = visibleTrees;
+    std::copy(treeGroupCount, treeGroupCount + TREE_GROUP_COUNT, uploadedGroupCount);
+    treeInstanceRevision = treeRevision;
+}
+
+// One instanced draw of count trees' trunks (cones = false) or foliage cones at one LOD through
+// vao: the authored trees (instance buffer updateTreeInstanceBuffer filled) or one world chunk's.
+// GL 3.3 has no base instance, so a non-zero instanceVBO re-points attribute 3 at firstInstance.
+// Global scale/yaw are uniforms, so I/O/J changes never touch the instance buffers.
+static void drawTreePartInstanced(ShaderProgram& shader, bool cones, GLuint vao, GLsizei count, int lod = 0,
+                                  GLuint instanceVBO = 0, GLsizei firstInstance = 0) {
+    if (count == 0) return;
+    const MeshLod& level = (cones ? coneLods : trunkLods)[std::max(0, std::min(lod, kTreeLods - 1))];
+    const void* indexOffset = (void*)(uintptr_t)(level.firstIndex * sizeof(GLuint));
+    // Same factors as the per-tree path, per unit of size base
+    TreeDims u = treeUnitDims();
+    float trunkH = u.trunkH, trunkR = u.trunkR, coneH = u.coneH, coneR = u.coneR;
+
+    shader.use();
+    shader.setFloat(UNIFORM_TREE_YAW, glm::radians(treeYawDeg));
+
+    if (!cones) {
+        // trunks (cylinder built with radius 0.08, unit height)
+        shader.setVec3(UNIFORM_PART_SCALE, trunkR/0.08f, trunkH, trunkR/0.08f);
+        shader.setFloat(UNIFORM_PART_LIFT, 0.0f);
+        bindMaterial(textureMaterial(LAYER_TRUNK));
+        bindVertexArray(vao);
+        if (instanceVBO) bindTreeInstances(instanceVBO, firstInstance);
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)level.indexCount, GL_UNSIGNED_INT, indexOffset, count); profileCountDraw();
+    } else {
+        // foliage cones (radius 0.20, unit height) on top of the trunks
+        shader.setVec3(UNIFORM_PART_SCALE, coneR/0.20f, coneH, coneR/0.20f);
+        shader.setFloat(UNIFORM_PART_LIFT, trunkH);
+        bindMaterial(textureMaterial(LAYER_LEAVES));
+        bindVertexArray(vao);
+        if (instanceVBO) bindTreeInstances(instanceVBO, firstInstance);
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)level.indexCount, GL_UNSIGNED_INT, indexOffset, count); profileCountDraw();
+    }
+}
+
+// ---------------- Tree impostors ----------------
+// Every TreeSize is the same tree scaled uniformly (as are the I/O scale controls), so one atlas of
+// a unit-base tree serves all of them: impostor.vert scales the quad by the instance's size base.
+static bool impostorsActive() {
+    return lodEnabled && treeImpostor.baked && impostorShaderProgram.id;
+}
+
+// Bounding sphere of a tree of size base 1 at the origin
+static BoundingSphere unitTreeBounds() {
+    float base = treeSizeBase(TreeSize::Medium);
+    BoundingSphere b = treeBounds(TreeInst{ glm::vec2(0.0f), TreeSize::Medium }, treeUnitDims());
+    return BoundingSphere{ b.center / base, b.radius / base };
+}
+
+static void createImpostorQuad() {
+    const float corners[8] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+    glGenVertexArrays(1, &impostorVAO);
+    glGenBuffers(1, &impostorQuadVBO);
+    bindVertexArray(impostorVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, impostorQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0); glEnableVertexAttribArray(0);
+    // Attribute 3 (tree instances) is pointed at a buffer per draw, as for the tree part VAOs
+    glEnableVertexAttribArray(3);
+    glVertexAttribDivisor(3, 1);
+    bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Capture the full-detail tree into treeImpostor. Runs once the trunk and leaf layers are resident
+// (a placeholder texel would be baked in for good); the tree is drawn through the normal instanced
+// path with one instance whose yaw offset cancels the global yaw.
+static void bakeTreeImpostors() {
+    ShaderProgram trunkBake = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "IMPOSTOR_BAKE"});
+    ShaderProgram leafBake = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "ALPHA_TEST", "IMPOSTOR_BAKE"});
+    if (trunkBake.id && leafBake.id) {
+        GLuint instanceVBO = 0;
+        const float instance[4] = { 0.0f, 0.0f, 1.0f, -glm::radians(treeYawDeg) };
+        glGenBuffers(1, &instanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(instance), instance, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        for (ShaderProgram* p : { &trunkBake, &leafBake }) {
+            p->use();
+            p->setInt(UNIFORM_TEXTURE_DIFFUSE1, 0);
+            p->setInt(UNIFORM_TEXTURE_LAYERS, kSceneTextureUnit);
+        }
+        bindTexture(kSceneTextureUnit, GL_TEXTURE_2D_ARRAY, sceneTextures);
+
+        BoundingSphere b = unitTreeBounds();
+        treeImpostor.bake(b.center, b.radius, [&](const glm::mat4& view, const glm::mat4& projection) {
+            // The capture camera goes through the frame block; setSceneUniforms rewrites it later on
+            FrameUniforms capture;
+            capture.view = view;
+            capture.projection = projection;
+            capture.viewPos = glm::vec3(glm::inverse(view)[3]);
+            updateFrameUniforms(capture);
+            drawTreePartInstanced(trunkBake, false, trunkVAO, 1, 0, instanceVBO, 0);
+            drawTreePartInstanced(leafBake, true, coneVAO, 1, 0, instanceVBO, 0);
+        });
+
+        // Back to the authored trees' instances
+        for (GLuint vao : { trunkVAO, coneVAO }) {
+            bindVertexArray(vao);
+            bindTreeInstances(treeInstanceVBO, 0);
+        }
+        bindVertexArray(0);
+        glDeleteBuffers(1, &instanceVBO);
+    }
+    glDeleteProgram(trunkBake.id);
+    glDeleteProgram(leafBake.id);
+}
+
+// count impostors from instanceVBO's firstInstance on (authored trees or one world chunk)
+static void drawTreeImpostors(GLuint instanceVBO, GLsizei firstInstance, GLsizei count) {
+    if (count == 0) return;
+    BoundingSphere b = unitTreeBounds();
+    impostorShaderProgram.use();
+    impostorShaderProgram.setFloat(UNIFORM_TREE_YAW, glm::radians(treeYawDeg));
+    impostorShaderProgram.setVec2(UNIFORM_IMPOSTOR_SIZE, glm::vec2(b.radius, b.center.y));
+    bindMaterial(textureMaterial(-1)); // impostor.vert always samples texture_diffuse1
+    bindTexture(kImpostorNormalUnit, GL_TEXTURE_2D, treeImpostor.normals);
+    bindTexture(0, GL_TEXTURE_2D, treeImpostor.albedo);
+    bindVertexArray(impostorVAO);
+    bindTreeInstances(instanceVBO, firstInstance);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count); profileCountDraw();
 }
 
 // Draw procedural fountain at world origin using cylinders and cones
-static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const glm::mat4& projection) {
-    // Fallback fountain composed of cylinders/cone to demonstrate textured/solid rendering
-    glUseProgram(shader);
-    // Common stone color
-    auto setColor = [&](float r,float g,float b){ glUniform3f(glGetUniformLocation(shader, "objectColor"), r,g,b); glUniform1i(glGetUniformLocation(shader, "solidMode"), 1); };
-    auto unsetColor = [&](){ glUniform1i(glGetUniformLocation(shader, "solidMode"), 0); };
+static void drawProceduralFountain(ShaderProgram& shader) {
+    // Fallback fountain composed of cylinders/cone to demonstrate textured/solid rendering;
+    // every part is a solid-colour material (registerSceneMaterials)
+    shader.use();
 
     float s = fountainScale;
     float baseY = 0.0f; // base sits on ground surface
@@ -348,12 +912,10 @@ static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const g
         float h = 0.30f * s; float r = 0.60f * s; float baseR = 0.08f; // created cylinder base radius
         M = glm::scale(M, glm::vec3(r/baseR, h/1.0f, r/baseR));
         M = Root * M;
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
-        setColor(0.78f, 0.78f, 0.82f);
-        glBindVertexArray(trunkVAO);
-        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        unsetColor();
+        shader.setModel(M);
+        bindMaterial(MATERIAL_STONE_PLINTH);
+        bindVertexArray(trunkVAO);
+        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
     }
 
     // Pedestal column (stone cylinder)
@@ -363,12 +925,10 @@ static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const g
         M = glm::translate(M, glm::vec3(0.0f, baseY + 0.30f * s, 0.0f));
         M = glm::scale(M, glm::vec3(colR/0.08f, colH/1.0f, colR/0.08f));
         M = Root * M;
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
-        setColor(0.82f, 0.82f, 0.86f);
-        glBindVertexArray(trunkVAO);
-        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        unsetColor();
+        shader.setModel(M);
+        bindMaterial(MATERIAL_STONE);
+        bindVertexArray(trunkVAO);
+        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
     }
 
     // Basin rim (wide shallow cylinder)
@@ -379,12 +939,10 @@ static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const g
         M = glm::translate(M, glm::vec3(0.0f, basinY, 0.0f));
         M = glm::scale(M, glm::vec3(rimR/0.08f, rimH/1.0f, rimR/0.08f));
         M = Root * M;
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
-        setColor(0.80f, 0.80f, 0.84f);
-        glBindVertexArray(trunkVAO);
-        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        unsetColor();
+        shader.setModel(M);
+        bindMaterial(MATERIAL_STONE_RIM);
+        bindVertexArray(trunkVAO);
+        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
     }
 
     // Water disc (very shallow cylinder)
@@ -394,12 +952,10 @@ static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const g
         M = glm::translate(M, glm::vec3(0.0f, basinY + rimH*0.4f, 0.0f));
         M = glm::scale(M, glm::vec3(waterR/0.08f, waterH/1.0f, waterR/0.08f));
         M = Root * M;
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
-        setColor(0.55f, 0.70f, 0.95f);
-        glBindVertexArray(trunkVAO);
-        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        unsetColor();
+        shader.setModel(M);
+        bindMaterial(MATERIAL_WATER);
+        bindVertexArray(trunkVAO);
+        glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
     }
 
     // Top finial (small cone)
@@ -409,12 +965,10 @@ static void drawProceduralFountain(GLuint shader, const glm::mat4& view, const g
         M = glm::translate(M, glm::vec3(0.0f, basinY + rimH + finH, 0.0f));
         M = glm::scale(M, glm::vec3(finR/0.20f, finH/1.0f, finR/0.20f));
         M = Root * M;
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]);
-        setColor(0.82f, 0.82f, 0.86f);
-        glBindVertexArray(coneVAO);
-        glDrawElements(GL_TRIANGLES, coneIndexCount, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        unsetColor();
+        shader.setModel(M);
+        bindMaterial(MATERIAL_STONE);
+        bindVertexArray(coneVAO);
+        glDrawElements(GL_TRIANGLES, coneIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
     }
 }
 
@@ -478,85 +1032,137 @@ static void createWedgeTemplate(float rInner, float rOuter, float halfAng, float
     }
 
     glGenVertexArrays(1,&vao); glGenBuffers(1,&vbo); glGenBuffers(1,&ebo);
-    glBindVertexArray(vao);
+    bindVertexArray(vao);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
+    uploadVertices(verts.data(), verts.size()/8, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size()*sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
+    applyVertexFormat();
+    bindVertexArray(0);
     idxCount = (GLsizei)idx.size();
 }
 
+static void destroyWedgeTemplate(GLuint &vao, GLuint &vbo, GLuint &ebo, GLsizei &idxCount) {
+    if (vao) deleteVertexArrays(1, &vao);
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+    vao = vbo = ebo = 0; idxCount = 0;
+}
+
 static void buildHedgeMeshes() {
-    // Build wedge templates for inner/outer rings based on stored wedge parameters
+    // Build wedge templates for inner/outer rings based on stored wedge parameters.
+    // Templates are unscaled (hedgeGlobalScale is applied by the model matrix), so they only
+    // need rebuilding when the radii, angles or height change.
+    float params[7] = { wedgeRInner1, wedgeROuter1, wedgeHalfAng1, wedgeRInner2, wedgeROuter2, wedgeHalfAng2, hedgeHeight };
+    if (wedgeVAO1 && wedgeVAO2 && std::equal(params, params + 7, wedgeBuiltParams)) return;
+    std::copy(params, params + 7, wedgeBuiltParams);
+    destroyWedgeTemplate(wedgeVAO1, wedgeVBO1, wedgeEBO1, wedgeIdx1);
+    destroyWedgeTemplate(wedgeVAO2, wedgeVBO2, wedgeEBO2, wedgeIdx2);
     createWedgeTemplate(wedgeRInner1, wedgeROuter1, wedgeHalfAng1, hedgeHeight, wedgeVAO1, wedgeVBO1, wedgeEBO1, wedgeIdx1);
     createWedgeTemplate(wedgeRInner2, wedgeROuter2, wedgeHalfAng2, hedgeHeight, wedgeVAO2, wedgeVBO2, wedgeEBO2, wedgeIdx2);
 }
 
-static void drawHedgeWedges(GLuint shader) {
-    glUseProgram(shader);
-    glUniform1i(glGetUniformLocation(shader, "solidMode"), 0);
-    glActiveTexture(GL_TEXTURE0);
-    // Use moss texture for hedges; reuse groundTextures[1]
-    glBindTexture(GL_TEXTURE_2D, groundTextures[1]);
-    glUniform1i(glGetUniformLocation(shader, "texture_diffuse1"), 0);
+// Bounding sphere of a wedge template in its local frame (prism along +X, see createWedgeTemplate)
+static BoundingSphere wedgeLocalBounds(float rInner, float rOuter, float halfAng, float height) {
+    float bx = rOuter * cosf(halfAng), bz = rOuter * sinf(halfAng);
+    glm::vec3 c(0.5f * (rInner + bx), 0.5f * height, 0.0f);
+    float rxz = std::max(std::fabs(rInner - c.x), glm::length(glm::vec2(bx - c.x, bz)));
+    return BoundingSphere{ c, std::sqrt(rxz*rxz + c.y*c.y) };
+}
+
+// Calls fn(M, bounds, outer) for every hedge wedge: M is the wedge's model matrix, bounds its template
+// bounds moved by M, outer selects the template (false: inner ring / wedgeVAO1, true: outer ring / wedgeVAO2)
+template <typename Fn>
+static void forEachHedgeWedge(Fn fn) {
     // Apply uniform scale (follow fountain)
-    auto setModel = [&](const glm::mat4& M){ glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &M[0][0]); };
     glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(hedgeGlobalScale, hedgeGlobalScale, hedgeGlobalScale));
+    auto emit = [&](const glm::mat4& M, const BoundingSphere& local, bool outer){
+        fn(M, BoundingSphere{ glm::vec3(M * glm::vec4(local.center, 1.0f)), local.radius * hedgeGlobalScale }, outer);
+    };
     // Inner ring
     if (wedgeVAO1 && wedgeIdx1>0) {
+        BoundingSphere local = wedgeLocalBounds(wedgeRInner1, wedgeROuter1, wedgeHalfAng1, hedgeHeight);
         for (int i=0;i<hedgeInnerCount;i++) {
             float ang = (6.2831853f * i) / hedgeInnerCount;
             glm::mat4 M(1.0f);
             M = glm::rotate(M, ang, glm::vec3(0,1,0));
             M = S * M;
-            setModel(M);
-            glBindVertexArray(wedgeVAO1);
-            glDrawElements(GL_TRIANGLES, wedgeIdx1, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+            emit(M, local, false);
         }
     }
     // Outer ring
     if (wedgeVAO2 && wedgeIdx2>0) {
+        BoundingSphere local = wedgeLocalBounds(wedgeRInner2, wedgeROuter2, wedgeHalfAng2, hedgeHeight);
         for (int i=0;i<hedgeOuterCount;i++) {
             float ang = (6.2831853f * i) / hedgeOuterCount + (3.14159f/hedgeOuterCount);
             glm::mat4 M(1.0f);
             M = glm::rotate(M, ang, glm::vec3(0,1,0));
             M = S * M;
-            setModel(M);
-            glBindVertexArray(wedgeVAO2);
-            glDrawElements(GL_TRIANGLES, wedgeIdx2, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+            emit(M, local, true);
         }
     }
 }
 
-// Build textured annulus covering from fountain edge to outer hedge radius using pathTexture
-void updateFountainRing(float /*fountainScaleUnused*/) {
-    // Builds a textured annulus around the fountain using midpoint circle sampling.
-    // UVs are world-aligned so each design-grid cell corresponds to exactly one texture tile.
+// forEachHedgeWedge limited to the wedges that survive culling; fn(M, outer)
+template <typename Fn>
+static void forEachVisibleHedgeWedge(Fn fn) {
+    forEachHedgeWedge([&](const glm::mat4& M, const BoundingSphere& bounds, bool outer){
+        if (cullSphere(bounds, cullStats.hedges, fogCullDist)) fn(M, outer);
+    });
+}
+
+// Vertices/indices of a rebuildable mesh, filled on a worker and uploaded by the job's completion
+struct MeshStaging {
+    std::vector<float> verts; // pos(3), normal(3), uv(2)
+    std::vector<unsigned int> idx;
+};
+// Accurate path ribbon and ring rebuilds in flight (job_system.h)
+JobGeneration layoutPathJobs, ringJobs;
+
+// Upload interleaved pos(3)/normal(3)/uv(2) data (stored as meshVertexFormat) into a mesh that
+// gets rebuilt at runtime.
+// Storage grows by 1.5x when the data no longer fits; otherwise it is overwritten in place with
+// glBufferSubData, so repeated rebuilds of a similar size never reallocate.
+static void uploadRebuildableMesh(GLuint &vao, GLuint &vbo, GLuint &ebo, GLsizeiptr &vboCap, GLsizeiptr &eboCap,
+                                  const std::vector<float>& verts, const std::vector<unsigned int>& idx) {
+    bool fresh = (vao == 0);
+    if (fresh) { glGenVertexArrays(1,&vao); glGenBuffers(1,&vbo); glGenBuffers(1,&ebo); }
+    auto fill = [](GLenum target, GLsizeiptr &cap, const void* data, GLsizeiptr bytes) {
+        if (bytes > cap) {
+            cap = std::max(bytes, cap + cap/2);
+            glBufferData(target, cap, nullptr, GL_DYNAMIC_DRAW);
+        }
+        if (bytes > 0) glBufferSubData(target, 0, bytes, data);
+    };
+    bindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    std::vector<unsigned char> encoded = encodeVertices(verts.data(), verts.size()/8);
+    fill(GL_ARRAY_BUFFER, vboCap, encoded.data(), (GLsizeiptr)encoded.size());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    fill(GL_ELEMENT_ARRAY_BUFFER, eboCap, idx.data(), (GLsizeiptr)(idx.size()*sizeof(unsigned int)));
+    if (fresh) {
+        applyVertexFormat();
+    }
+    bindVertexArray(0);
+}
+
+// Inner/outer radius of the fountain ring for the current 2D fountain radius and hedge scale
+static void fountainRingRadii(float &innerR, float &outerR) {
     // Compute fountain world radius from 2D pixel radius
     int frGrid = std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
     float cellWorld = 20.0f / (float)designGridW;
-    float innerR = frGrid * cellWorld; // from 2D fountain radius
+    innerR = frGrid * cellWorld; // from 2D fountain radius
     // Ensure inner radius also respects 3D fountain footprint derived from fountainScale
     innerR = std::max(innerR, fountainScale * 1.1f);
     // Outer radius: up to the OUTER edge of the (scaled) outer hedge ring, minus a small gap to avoid z-fighting
-    float outerR = std::max(innerR + 0.05f, wedgeROuter2 * hedgeGlobalScale - 0.02f);
+    outerR = std::max(innerR + 0.05f, wedgeROuter2 * hedgeGlobalScale - 0.02f);
+}
 
-    int rPix = (int)std::round(outerR * 40.0f); // sampling density; higher factor gives smoother ring
-    if (rPix < 16) rPix = 16;
+// Unit-radius annulus topology from midpoint circle sampling at radius rPix (pure, run on a
+// worker). Leaves out empty when the sampling is too coarse for a smooth ring.
+static void buildRingTopology(int rPix, MeshStaging& out) {
     std::vector<glm::ivec2> raw;
-    int x=0, y=rPix; int d=1-rPix;
-    while (x <= y) {
-        raw.push_back({x,y}); raw.push_back({-x,y}); raw.push_back({x,-y}); raw.push_back({-x,-y});
-        raw.push_back({y,x}); raw.push_back({-y,x}); raw.push_back({y,-x}); raw.push_back({-y,-x});
-        if (d < 0) d += 2*x + 3; else { d += 2*(x - y) + 5; y--; }
-        x++;
-    }
+    rasterCircle(0, 0, rPix, [&](int x, int y){ raw.push_back({x,y}); });
 
     struct AngPt { float ang; glm::vec2 dir; }; std::vector<AngPt> ordered; ordered.reserve(raw.size());
     std::unordered_set<long long> seen;
@@ -573,28 +1179,16 @@ void updateFountainRing(float /*fountainScaleUnused*/) {
     std::sort(ordered.begin(), ordered.end(), [](const AngPt&a,const AngPt&b){return a.ang < b.ang;});
     if (ordered.size() < 24) return; // ensure adequate smoothness
 
-    std::vector<float> verts; // pos(3), normal(3), uv(2)
-    std::vector<unsigned int> indices;
-    // World-space UVs: one texture tile per design-grid cell square
-    float invCell = 1.0f / (20.0f / (float)designGridW);
-    auto worldUV = [&](const glm::vec3& p){
-        // Shift to [0,20] range then scale by invCell so each cell = 1 UV unit
-        float u = (p.x + 10.0f) * invCell;
-        float v = (p.z + 10.0f) * invCell;
-        return glm::vec2(u, v);
-    };
-    auto pushV = [&](glm::vec3 pos, glm::vec2 uv){
-        verts.push_back(pos.x); verts.push_back(pos.y); verts.push_back(pos.z);
+    std::vector<float>& verts = out.verts; // unit direction(3), normal(3), edge selector + unused(2)
+    std::vector<unsigned int>& indices = out.idx;
+    auto pushV = [&](const glm::vec2& dir, float edge){
+        verts.push_back(dir.x); verts.push_back(0.001f); verts.push_back(dir.y);
         verts.push_back(0.0f); verts.push_back(1.0f); verts.push_back(0.0f);
-        verts.push_back(uv.x); verts.push_back(uv.y);
+        verts.push_back(edge); verts.push_back(0.0f);
     };
     for (size_t i=0;i<ordered.size();++i) {
-        glm::vec2 dir = ordered[i].dir;
-        glm::vec3 outerP(dir.x * outerR, 0.001f, dir.y * outerR);
-        glm::vec3 innerP(dir.x * innerR, 0.001f, dir.y * innerR);
-        // World-aligned tiling: exactly one path.png per grid cell square
-        pushV(outerP, worldUV(outerP));
-        pushV(innerP, worldUV(innerP));
+        pushV(ordered[i].dir, 1.0f); // outer edge
+        pushV(ordered[i].dir, 0.0f); // inner edge
     }
     unsigned int stride = 2;
     for (size_t i=0;i<ordered.size();++i) {
@@ -604,27 +1198,49 @@ void updateFountainRing(float /*fountainScaleUnused*/) {
         indices.push_back(o0); indices.push_back(i0); indices.push_back(i1);
         indices.push_back(o0); indices.push_back(i1); indices.push_back(o1);
     }
+}
+
+// Build textured annulus covering from fountain edge to outer hedge radius (path layer)
+void updateFountainRing(float /*fountainScaleUnused*/) {
+    // Builds a unit-radius annulus topology using midpoint circle sampling. Vertices store their
+    // direction and an inner/outer edge selector (uv.x); ring.vert applies the actual radii and
+    // world-aligned UVs, so radius changes are uniform updates and the mesh only needs
+    // resampling (on a worker) when the required density leaves the range the current topology
+    // covers.
+    float innerR, outerR;
+    fountainRingRadii(innerR, outerR);
+    int rPix = (int)std::round(outerR * 40.0f); // sampling density; higher factor gives smoother ring
+    if (rPix < 16) rPix = 16;
+    if (ringVAO && rPix <= ringSampleRadius && rPix * 2 >= ringSampleRadius) return;
+    rPix += rPix / 4; // headroom so a growing ring does not resample every frame
+
+    auto staging = std::make_shared<MeshStaging>();
+    unsigned int ticket = ringJobs.next();
+    submitJob([rPix, staging]{ buildRingTopology(rPix, *staging); },
+              [rPix, staging, ticket]{
+        if (!ringJobs.accept(ticket) || staging->idx.empty()) return;
+        uploadRebuildableMesh(ringVAO, ringVBO, ringEBO, ringVBOCap, ringEBOCap, staging->verts, staging->idx);
+        ringIndexCount = (GLsizei)staging->idx.size();
+        ringSampleRadius = rPix;
+        staticMeshRevision++; // the static batch holds a copy
+    });
+}
 
-    if (!ringVAO) { glGenVertexArrays(1,&ringVAO); glGenBuffers(1,&ringVBO); glGenBuffers(1,&ringEBO); }
-    glBindVertexArray(ringVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, ringVBO);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ringEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
-    ringIndexCount = (GLsizei)indices.size();
+// Ring (annulus) with world-aligned UV tiling (path.png 1:1 per grid cell)
+static void drawFountainRing(ShaderProgram& shader) {
+    if (!ringVAO || ringIndexCount <= 0) return;
+    float innerR, outerR;
+    fountainRingRadii(innerR, outerR);
+    shader.use();
+    // One texture tile per design-grid cell: UV = (world + 10) / cellWorld
+    shader.setVec3(UNIFORM_RING_PARAMS, innerR, outerR, (float)designGridW / 20.0f);
+    bindMaterial(textureMaterial(LAYER_PATH));
+    bindVertexArray(ringVAO);
+    glDrawElements(GL_TRIANGLES, ringIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
 }
 
 // Build a simple ground-level textured path mesh based on current pathStyle
 void updatePathMesh(int style) {
-    if (!pathVAO) {
-        glGenVertexArrays(1, &pathVAO);
-        glGenBuffers(1, &pathVBO);
-        glGenBuffers(1, &pathEBO);
-    }
     std::vector<float> verts; // pos(3), normal(3), uv(2)
     std::vector<unsigned int> idx;
 
@@ -672,20 +1288,9 @@ void updatePathMesh(int style) {
         addQuad(glm::vec3(0.0f,0.0f,0.0f), glm::vec3(8.0f,0.0f,-6.0f), pathHalfWidth, 3.0f);
     }
 
-    glBindVertexArray(pathVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, pathVBO);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pathEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size()*sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
-
-    // Store count in EBO by binding later
+    uploadRebuildableMesh(pathVAO, pathVBO, pathEBO, pathVBOCap, pathEBOCap, verts, idx);
+    // Buffers may be larger than the data after a shrink, so the draw uses this count
+    pathIndexCount = (GLsizei)idx.size();
 }
 
 // Convert design grid cell to world XZ (y fixed at 0)
@@ -695,38 +1300,31 @@ static inline glm::vec3 gridToWorld(int gx, int gy) {
     return glm::vec3(wx, 0.0f, wz);
 }
 
-// Build mesh that exactly matches Bresenham layout paths (all unobstructed segments)
-void updateAccuratePathMesh() {
-    // Emits an accurate path ribbon mesh from Bresenham-generated discrete segments.
-    // Segment midpoints are tested against forbidden regions to maintain constraints.
-    if (!layoutGenerated || layoutPaths.empty()) return;
-    if (!layoutPathVAO) { glGenVertexArrays(1,&layoutPathVAO); glGenBuffers(1,&layoutPathVBO); glGenBuffers(1,&layoutPathEBO); }
-    std::vector<float> verts; // pos(3), normal(3), uv(2)
-    std::vector<unsigned int> idx;
-    // Compute fountain circle radius in world units to exclude segments inside it
-    int frGrid = std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
-    float cellWorld = 20.0f / (float)designGridW;
-    float fWorldR = frGrid * cellWorld;
-    // (Removed unused fWorldR2)
-    float wedgeOuterR = std::max(wedgeROuter2 * hedgeGlobalScale, fWorldR); // scaled outer hedge radius
-    float wedgeOuterR2 = wedgeOuterR * wedgeOuterR;
-    auto pointInTri2 = [](const glm::vec2& p, const Tri& t){
-        auto sign=[&](const glm::vec2& p1,const glm::vec2& p2,const glm::vec2& p3){ return (p1.x - p3.x)*(p2.y - p3.y) - (p2.x - p3.x)*(p1.y - p3.y); };
-        float d1 = sign(p, t.a, t.b), d2 = sign(p, t.b, t.c), d3 = sign(p, t.c, t.a);
-        bool hasNeg = (d1<0) || (d2<0) || (d3<0);
-        bool hasPos = (d1>0) || (d2>0) || (d3>0);
-        return !(hasNeg && hasPos);
+// Inputs of the accurate path ribbon, snapshotted on the main thread
+struct PathRibbonInputs {
+    OccupancyInputs occ;
+    float pathHalfWidth;
+};
+// CPU half of the accurate path ribbon: a pure function of its inputs, run on a worker.
+// Emits an accurate path ribbon mesh from Bresenham-generated discrete segments.
+// Segment midpoints are tested against forbidden regions to maintain constraints.
+static void buildAccuratePathRibbon(const PathRibbonInputs& in, MeshStaging& out) {
+    std::vector<float>& verts = out.verts;
+    std::vector<unsigned int>& idx = out.idx;
+    float pathHalfWidth = in.pathHalfWidth;
+    // Fountain circle radius in world units to exclude segments inside it
+    float fWorldR = in.occ.fountainDiskR;
+    float wedgeOuterR = std::max(in.occ.hedgeDiskR, fWorldR); // scaled outer hedge radius
+    OccupancyGrid occ;
+    rasterizeOccupancy(occ, in.occ);
+    auto gridToWorld = [&](int gx, int gy) {
+        return glm::vec3((gx/(float)in.occ.gridW)*20.0f - 10.0f, 0.0f, (gy/(float)in.occ.gridH)*20.0f - 10.0f);
     };
     auto segmentAllowed = [&](const glm::vec3& a, const glm::vec3& b){
         glm::vec3 m = 0.5f*(a+b);
-        float d2 = m.x*m.x + m.z*m.z;
-        // Exclude entire disk inside the (scaled) wedges' outer radius
-        if (d2 <= wedgeOuterR2) return false;
-        glm::vec2 pm(m.x, m.z);
-        for (auto &tri : hedgeWedgeTris) {
-            if (pointInTri2(pm, tri)) return false; // inside hedge wedge footprint
-        }
-        return true;
+        // Exclude the entire disk inside the (scaled) wedges' outer radius / fountain radius,
+        // and the hedge wedge footprints
+        return (occ.atWorld(m.x, m.z) & (OCC_HEDGE_DISK | OCC_FOUNTAIN_DISK | OCC_HEDGE_WEDGE)) == 0;
     };
     auto pushQuad = [&](const glm::vec3& a, const glm::vec3& b){
         glm::vec3 dir = b - a;
@@ -771,97 +1369,625 @@ void updateAccuratePathMesh() {
         idx.push_back(base+2); idx.push_back(base+3); idx.push_back(base+0);
     };
     // Recreate Bresenham per path and emit quads between successive cells
-    for (auto &lp : layoutPaths) {
+    for (auto &lp : in.occ.paths) {
         // Only draw clear paths
         if (!lp.clear) continue;
-        int x0=lp.a.x, y0=lp.a.y, x1=lp.b.x, y1=lp.b.y;
-        int dx=abs(x1-x0), dy=abs(y1-y0); int sx = x0<x1?1:-1; int sy=y0<y1?1:-1; int err=dx-dy;
-        int px=x0, py=y0;
-        int prevX=px, prevY=py;
-        while (true) {
-            if (px==x1 && py==y1) {
-                // last segment
+        bool first = true;
+        int prevX = lp.a.x, prevY = lp.a.y;
+        rasterLine(lp.a.x, lp.a.y, lp.b.x, lp.b.y, [&](int px, int py){
+            if (!first) {
                 glm::vec3 a = gridToWorld(prevX, prevY);
                 glm::vec3 b = gridToWorld(px, py);
                 if (segmentAllowed(a,b)) pushQuad(a,b);
-                break;
             }
-            int e2=2*err; if (e2> -dy){ err -= dy; px += sx; } if (e2 < dx){ err += dx; py += sy; }
-            glm::vec3 a = gridToWorld(prevX, prevY);
-            glm::vec3 b = gridToWorld(px, py);
-            if (segmentAllowed(a,b)) pushQuad(a,b);
-            prevX=px; prevY=py;
-        }
+            first = false;
+            prevX = px; prevY = py;
+        });
     }
-    glBindVertexArray(layoutPathVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, layoutPathVBO);
-    glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(float), verts.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, layoutPathEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx.size()*sizeof(unsigned int), idx.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)0); glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1,3,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(3*sizeof(float))); glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2,2,GL_FLOAT,GL_FALSE,8*sizeof(float),(void*)(6*sizeof(float))); glEnableVertexAttribArray(2);
-    glBindVertexArray(0);
-    layoutPathIndexCount = (GLsizei)idx.size();
+}
+
+// Rebuild the accurate path ribbon on a worker; the current one keeps drawing until the upload
+void updateAccuratePathMesh() {
+    if (!layoutGenerated || layoutPaths.empty()) return;
+    PathRibbonInputs in{ occupancyInputs(), pathHalfWidth };
+    auto staging = std::make_shared<MeshStaging>();
+    unsigned int ticket = layoutPathJobs.next();
+    submitJob([in, staging]{ buildAccuratePathRibbon(in, *staging); },
+              [staging, ticket]{
+        if (!layoutPathJobs.accept(ticket)) return;
+        uploadRebuildableMesh(layoutPathVAO, layoutPathVBO, layoutPathEBO, layoutPathVBOCap, layoutPathEBOCap, staging->verts, staging->idx);
+        layoutPathIndexCount = (GLsizei)staging->idx.size();
+        staticMeshRevision++; // the static batch holds a copy
+    });
 }
 
 // Simple NDC triangle VAO (for pipeline sanity check)
 // (Removed NDC triangle debug)
 
 // ----------------- Draw Helpers -----------------
-void setCommonUniforms(GLuint shader, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos) {
-    glUseProgram(shader);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, &view[0][0]);
-    glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, &projection[0][0]);
-    glUniform3f(glGetUniformLocation(shader, "lightDir"), -0.5f, -1.0f, -0.3f);
-    glUniform3f(glGetUniformLocation(shader, "viewPos"), camPos.x, camPos.y, camPos.z);
+// Sampler units never change, so they are set once per program at startup. Both are set
+// explicitly: two sampler types must never share a texture unit.
+static void setSceneSamplers(ShaderProgram& shader) {
+    if (!shader.id) return;
+    shader.use();
+    shader.setInt(UNIFORM_TEXTURE_DIFFUSE1, 0);
+    shader.setInt(UNIFORM_TEXTURE_LAYERS, kSceneTextureUnit);
+    shader.setInt(UNIFORM_SHADOW_MAP, kShadowMapUnit);
+}
+
+// Material table (uniform_blocks.h), in SceneMaterial order
+static void registerSceneMaterials() {
+    for (int layer = -1; layer < LAYER_COUNT; ++layer) {
+        MaterialUniforms m;
+        m.textureLayer = layer;
+        addMaterial(m);
+    }
+    const glm::vec3 solids[] = {
+        glm::vec3(0.78f, 0.78f, 0.82f), glm::vec3(0.82f, 0.82f, 0.86f), glm::vec3(0.80f, 0.80f, 0.84f), glm::vec3(0.55f, 0.70f, 0.95f)
+    };
+    for (const glm::vec3& color : solids) {
+        MaterialUniforms m;
+        m.objectColor = color;
+        m.solidMode = 1;
+        addMaterial(m);
+    }
+    uploadMaterials();
+}
+
+// Run the rebuilds queued by markMeshesDirty, each at most once per frame. A worker rebuild
+// (ribbon, ring) waits while its previous job is in flight, with its bit left set: a job takes
+// its inputs when submitted, so one submitted after the last change is all that is needed.
+static void flushMeshRebuilds() {
+    unsigned int bits = meshDirty;
+    if (layoutPathJobs.pending()) bits &= ~MESH_DIRTY_LAYOUT_PATH;
+    if (ringJobs.pending())       bits &= ~MESH_DIRTY_RING_TOPOLOGY;
+    if (!bits) return;
+    meshDirty &= ~bits;
+    if (bits & MESH_DIRTY_PATH_STYLE)    updatePathMesh(pathStyle);
+    if (bits & MESH_DIRTY_LAYOUT_PATH)   updateAccuratePathMesh();
+    if (bits & MESH_DIRTY_RING_TOPOLOGY) updateFountainRing(fountainScale);
+    if (bits & MESH_DIRTY_HEDGES)        buildHedgeMeshes();
+    staticMeshRevision++;
+}
+
+// ---------------- Static scene batch ----------------
+// Copy the static meshes into the batch arena again if any of them was rebuilt since the last pack
+static void packStaticBatch() {
+    if (staticBatchRevision == staticMeshRevision) return;
+    std::vector<BatchSource> sources(SLOT_COUNT, BatchSource{ 0, 0, 0 });
+    sources[SLOT_GROUND] = BatchSource{ groundVBO, groundEBO, 6 };
+    // Same preference as the per-object path: accurate user paths, else the stylized mesh
+    if (layoutPathVAO && layoutPathIndexCount > 0) sources[SLOT_PATH] = BatchSource{ layoutPathVBO, layoutPathEBO, layoutPathIndexCount };
+    else if (pathVAO && pathIndexCount > 0)      sources[SLOT_PATH] = BatchSource{ pathVBO, pathEBO, pathIndexCount };
+    sources[SLOT_RING] = BatchSource{ ringVBO, ringEBO, ringIndexCount };
+    sources[SLOT_WEDGE_INNER] = BatchSource{ wedgeVBO1, wedgeEBO1, wedgeIdx1 };
+    sources[SLOT_WEDGE_OUTER] = BatchSource{ wedgeVBO2, wedgeEBO2, wedgeIdx2 };
+    // loadModel produces a single mesh with a single texture; its LODs reuse the LOD 0 vertices
+    if (!useProceduralFountain) {
+        const Mesh& m = fountainModel.meshes[0];
+        for (int l = 0; l < m.lodCount; ++l)
+            sources[SLOT_FOUNTAIN + l] = BatchSource{ m.VBO, m.EBO, (GLsizei)m.lods[l].indexCount, m.lods[l].firstIndex,
+                                                      l > 0 ? (int)SLOT_FOUNTAIN : -1 };
+    }
+    staticBatch.pack(sources);
+    staticBatchRevision = staticMeshRevision;
+}
+
+// Record this frame's batch draws: ground, path, OBJ fountain, visible hedge wedges and the ring,
+// with the same culling and texture layers as the per-object items. The procedural fountain
+// (solid colours on the tree meshes) is not part of the batch. Sorted, the occluders go first and
+// the ground last, as in the render queue's buckets; otherwise the old draw order.
+static void recordStaticBatch(bool fountainVisible) {
+    packStaticBatch();
+    staticBatch.clearDraws();
+    bool sorted = renderQueue.frontToBack;
+    if (!sorted) {
+        staticBatch.addDraw(SLOT_GROUND, glm::mat4(1.0f), LAYER_GRASS + currentGroundTex);
+        staticBatch.addDraw(SLOT_PATH, glm::mat4(1.0f), LAYER_PATH);
+    }
+    if (!useProceduralFountain && fountainVisible) {
+        applyFountainTransform();
+        staticBatch.addDraw(SLOT_FOUNTAIN + fountainLod, modelMatrix(fountainModel), -1);
+    }
+    forEachVisibleHedgeWedge([](const glm::mat4& M, bool outer){
+        staticBatch.addDraw(outer ? SLOT_WEDGE_OUTER : SLOT_WEDGE_INNER, M, LAYER_MOSS);
+    });
+    float innerR, outerR;
+    fountainRingRadii(innerR, outerR);
+    staticBatch.addRingDraw(SLOT_RING, innerR, outerR, (float)designGridW / 20.0f, LAYER_PATH);
+    if (sorted) {
+        staticBatch.addDraw(SLOT_PATH, glm::mat4(1.0f), LAYER_PATH);
+        staticBatch.addDraw(SLOT_GROUND, glm::mat4(1.0f), LAYER_GRASS + currentGroundTex);
+    }
+}
+
+// Per-frame state of every program the 3D pass uses: one write of the frame block
+static void setSceneUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camPos, float time) {
+    frameView = view;
+    frameProjection = projection;
+
+    // Impostor fade band for this projection, in the shaders' measure (lod.h: d = r * scale * H / px)
+    float unitPx = unitTreeBounds().radius * projection[1][1] * (float)SCR_HEIGHT;
+    impostorFade = ImpostorFade{ unitPx / kImpostorStartPx, unitPx / kImpostorEndPx };
+
+    FrameUniforms frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.viewPos = camPos;
+    frame.time = time;
+    frame.lightDir = kLightDir;
     // Slightly brighter lighting and thinner fog
-    glUniform3f(glGetUniformLocation(shader, "lightColor"), 1.2f, 1.2f, 1.15f);
-    glUniform3f(glGetUniformLocation(shader, "fogColor"), 0.1f, 0.15f, 0.2f);
-    glUniform1f(glGetUniformLocation(shader, "fogDensity"), 0.015f);
-    glUniform1i(glGetUniformLocation(shader, "solidMode"), 0);
+    frame.lightColor = glm::vec3(1.2f, 1.2f, 1.15f);
+    frame.fogColor = glm::vec3(0.1f, 0.15f, 0.2f);
+    frame.fogDensity = fogDensity;
+    frame.lodFade = glm::vec2(impostorFade.start, 1.0f / (impostorFade.end - impostorFade.start));
+    shadowMaps.writeFrameUniforms(frame, shadowsEnabled);
+    updateFrameUniforms(frame);
 }
 
-// Generic model drawer
-void drawObject(Model& model, const glm::vec3& position, GLuint shader, const glm::mat4& view, const glm::mat4& projection) {
-    model.position = position;
-    drawModel(model, view, projection);
+// ---------------- Render queue items ----------------
+// Callbacks for renderQueue: bind and draw only. Culling, instance uploads and the batch's draw
+// list are done once per frame by recordScenePass, since the depth pre-pass runs each callback twice.
+static void drawGroundItem(const RenderItem&) {
+    shaderProgram.use();
+    bindMaterial(textureMaterial(LAYER_GRASS + currentGroundTex));
+    shaderProgram.setModel(glm::mat4(1.0f));
+    bindVertexArray(groundVAO);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0); profileCountDraw();
+}
+
+// Accurate user paths when available, else the stylized mesh
+static void drawPathsItem(const RenderItem&) {
+    shaderProgram.use();
+    bindMaterial(textureMaterial(LAYER_PATH));
+    shaderProgram.setModel(glm::mat4(1.0f));
+    if (layoutPathVAO && layoutPathIndexCount > 0) {
+        bindVertexArray(layoutPathVAO);
+        glDrawElements(GL_TRIANGLES, layoutPathIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
+    } else if (pathVAO && pathIndexCount > 0) {
+        bindVertexArray(pathVAO);
+        glDrawElements(GL_TRIANGLES, pathIndexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
+    }
 }
 
-// Draw fireflies with additive blending
-void drawFireflies(GLuint shader, const glm::mat4& view, const glm::mat4& projection, float time) {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+// Ring (annulus) with world-aligned UV tiling (path.png 1:1 per grid cell)
+static void drawRingItem(const RenderItem&) {
+    drawFountainRing(ringShaderProgram);
+}
 
-    glUseProgram(shader);
-    glBindVertexArray(fireflyVAO);
+// OBJ fountain if available, else the procedural fallback. Fountain rotates in yaw only.
+static void drawFountainItem(const RenderItem&) {
+    if (useProceduralFountain) {
+        drawProceduralFountain(shaderProgram);
+    } else {
+        applyFountainTransform();
+        drawModel(fountainModel, fountainLod);
+    }
+}
 
-    for (auto& f : fireflies) {
-        glm::vec3 pos = f.position;
-        pos.y += sin(time + f.phase) * 0.3f;
-        pos.x += sin(time + f.driftPhaseX) * 0.1f;
-        pos.z += cos(time + f.driftPhaseZ) * 0.1f;
+// One star hedge wedge: index 0 = inner template, 1 = outer. Rotated and uniformly scaled, so the
+// model's 3x3 transforms normals directly.
+static void drawHedgeWedgeItem(const RenderItem& item) {
+    bool outer = item.index != 0;
+    rigidShaderProgram.use();
+    // Hedges reuse the moss ground layer
+    bindMaterial(textureMaterial(LAYER_MOSS));
+    rigidShaderProgram.setModel(item.model);
+    bindVertexArray(outer ? wedgeVAO2 : wedgeVAO1);
+    glDrawElements(GL_TRIANGLES, outer ? wedgeIdx2 : wedgeIdx1, GL_UNSIGNED_INT, 0); profileCountDraw();
+}
+
+// Per-tree path: trunk and foliage cone with the matrices recordTrees built
+static void drawTreeTrunkItem(const RenderItem& item) {
+    shaderProgram.use();
+    shaderProgram.setModel(item.model);
+    bindMaterial(textureMaterial(LAYER_TRUNK));
+    const MeshLod& level = trunkLods[treeLods[item.index]];
+    bindVertexArray(trunkVAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)level.indexCount, GL_UNSIGNED_INT,
+                   (void*)(uintptr_t)(level.firstIndex * sizeof(GLuint))); profileCountDraw();
+}
+
+static void drawTreeConeItem(const RenderItem& item) {
+    leafShaderProgram.use();
+    leafShaderProgram.setModel(item.model);
+    bindMaterial(textureMaterial(LAYER_LEAVES));
+    const MeshLod& level = coneLods[treeLods[item.index]];
+    bindVertexArray(coneVAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)level.indexCount, GL_UNSIGNED_INT,
+                   (void*)(uintptr_t)(level.firstIndex * sizeof(GLuint))); profileCountDraw();
+}
+
+// Instanced path: one item per non-empty group, index = TreeGroup (the fade group draws the
+// lowest LOD through the dissolving programs)
+static void drawTreeTrunksInstancedItem(const RenderItem& item) {
+    int g = item.index;
+    drawTreePartInstanced(g == TREE_GROUP_FADE ? treeFadeShaderProgram : treeShaderProgram, false, trunkVAO,
+                          treeGroupCount[g], std::min(g, kTreeLods - 1), treeInstanceVBO, treeGroupStart[g]);
+}
+static void drawTreeLeavesInstancedItem(const RenderItem& item) {
+    int g = item.index;
+    drawTreePartInstanced(g == TREE_GROUP_FADE ? treeLeafFadeShaderProgram : treeLeafShaderProgram, true, coneVAO,
+                          treeGroupCount[g], std::min(g, kTreeLods - 1), treeInstanceVBO, treeGroupStart[g]);
+}
+
+static void drawTreeImpostorsItem(const RenderItem&) {
+    drawTreeImpostors(treeInstanceVBO, treeGroupStart[TREE_GROUP_FADE],
+                      treeGroupCount[TREE_GROUP_FADE] + treeGroupCount[TREE_GROUP_IMPOSTOR]);
+}
+
+// World chunk items: index = slot in chunkedWorld.chunks (stable until the next update), model =
+// translation to the chunk origin
+static void drawChunkMesh(const RenderItem& item, int layer, GLuint vao, GLsizei indexCount) {
+    rigidShaderProgram.use();
+    bindMaterial(textureMaterial(layer));
+    rigidShaderProgram.setModel(item.model);
+    bindVertexArray(vao);
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0); profileCountDraw();
+}
+
+static void drawChunkPathItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawChunkMesh(item, LAYER_PATH, c.pathVAO, c.pathIndexCount);
+}
+
+static void drawChunkGroundItem(const RenderItem& item) {
+    drawChunkMesh(item, LAYER_GRASS + currentGroundTex, chunkedWorld.groundVAO, 6);
+}
+
+static void drawChunkTrunksItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawTreePartInstanced(treeShaderProgram, false, c.trunkVAO, c.treeCount, c.treeLod);
+}
 
-        glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
-        model = glm::scale(model, glm::vec3(0.05f));
+static void drawChunkLeavesItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawTreePartInstanced(treeLeafShaderProgram, true, c.coneVAO, c.treeCount, c.treeLod);
+}
+
+// Chunks reaching into the impostor fade band: every tree through the dissolving programs, each
+// instance's own distance deciding how much of it shows; the impostor draw covers the rest. The
+// chunk's nearest trees can still be close, so it keeps the level picked for them.
+static void drawChunkTrunksFadeItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawTreePartInstanced(treeFadeShaderProgram, false, c.trunkVAO, c.treeCount, c.treeLod);
+}
 
-        glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, &model[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, &view[0][0]);
-        glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, &projection[0][0]);
+static void drawChunkLeavesFadeItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawTreePartInstanced(treeLeafFadeShaderProgram, true, c.coneVAO, c.treeCount, c.treeLod);
+}
 
-        float intensity = 0.5f + 0.5f * sin(time * f.blinkSpeed + f.blinkPhase * 6.2831f);
-        float distance = glm::length(cameraPos - pos);
-        float fade = glm::clamp(1.0f - distance / 20.0f, 0.0f, 1.0f);
-        intensity *= fade;
+static void drawChunkImpostorsItem(const RenderItem& item) {
+    const WorldChunk& c = chunkedWorld.chunks[item.index];
+    drawTreeImpostors(c.instanceVBO, 0, c.treeCount);
+}
 
-        glUniform3f(glGetUniformLocation(shader, "objectColor"), 1.0f * intensity, 1.0f * intensity, 0.5f * intensity);
-        glUniform1i(glGetUniformLocation(shader, "solidMode"), 1);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        glUniform1i(glGetUniformLocation(shader, "solidMode"), 0);
+static void drawStaticBatchItem(const RenderItem&) {
+    // Layers come per draw; the multi-draw path only needs some textured material bound
+    bindMaterial(textureMaterial(-1));
+    // The only texture_diffuse1 user in the batch
+    if (!useProceduralFountain) {
+        bindTexture(0, GL_TEXTURE_2D, fountainModel.meshes[0].textureID);
     }
+    // Every batched model matrix is rotation/translation/uniform scale (see SceneBatch::addDraw)
+    staticBatch.submit(batchShaderProgram, rigidShaderProgram, ringShaderProgram);
+}
 
-    glBindVertexArray(0);
-    glDisable(GL_BLEND); // disable after firefly pass so opaque models aren't blended
+// Select each visible tree's LOD and, on the instanced path, its impostor tier; group visibleTrees
+// by TreeGroup (stable, so a front-to-back order survives inside each group)
+static void selectTreeGroups(const TreeDims& u) {
+    if (treeLods.size() != treeStore.count()) treeLods.assign(treeStore.count(), -1);
+    treeGroups.resize(treeStore.count());
+    float projScaleY = frameProjection[1][1];
+    bool impostors = impostorsActive() && instancedTrees;
+    for (unsigned int i : visibleTrees) {
+        if (!lodEnabled) { treeLods[i] = treeGroups[i] = 0; continue; }
+        TreeInst ti = treeAt(i);
+        BoundingSphere b = treeBounds(ti, u);
+        float px = projectedDiameterPx(b.radius, glm::length(b.center - cameraPos), projScaleY, (float)SCR_HEIGHT);
+        treeLods[i] = (int8_t)selectLod(px, treeLods[i], kTreeLodMinPx, kTreeLods);
+        treeGroups[i] = treeLods[i];
+        if (!impostors) continue;
+        // Same measure as the shaders' fade
+        float perBase = glm::length(glm::vec3(ti.pos.x, 0.0f, ti.pos.y) - cameraPos) / treeSizeBase(ti.size);
+        if (perBase >= impostorFade.end) treeGroups[i] = TREE_GROUP_IMPOSTOR;
+        else if (perBase >= impostorFade.start) treeGroups[i] = TREE_GROUP_FADE;
+    }
+    std::stable_sort(visibleTrees.begin(), visibleTrees.end(),
+                     [](unsigned int a, unsigned int b) { return treeGroups[a] < treeGroups[b]; });
+    std::fill(treeGroupCount, treeGroupCount + TREE_GROUP_COUNT, 0);
+    for (unsigned int i : visibleTrees) treeGroupCount[treeGroups[i]]++;
+    for (int g = 0, start = 0; g < TREE_GROUP_COUNT; start += treeGroupCount[g], ++g) treeGroupStart[g] = start;
+}
+
+// Trunks are opaque, cones alpha-tested. Sorted, visibleTrees is reordered front-to-back first:
+// the per-tree items sort anyway, and instances rasterize in buffer order.
+static void recordTrees() {
+    if (visibleTrees.empty()) return;
+    TreeDims u = treeUnitDims();
+    if (renderQueue.frontToBack) {
+        std::vector<std::pair<float, unsigned int>> byDistance;
+        byDistance.reserve(visibleTrees.size());
+        for (unsigned int i : visibleTrees) {
+            glm::vec3 d = treeBounds(treeAt(i), u).center - cameraPos;
+            byDistance.push_back({ glm::dot(d, d), i });
+        }
+        std::sort(byDistance.begin(), byDistance.end());
+        for (size_t k = 0; k < byDistance.size(); ++k) visibleTrees[k] = byDistance[k].second;
+    }
+    selectTreeGroups(u);
+    if (instancedTrees) {
+        updateTreeInstanceBuffer();
+        // Two instanced draws per group in use; each sorts by its first (when sorted: nearest) tree.
+        // The fade group's trunks discard, so they go with the alpha-tested draws.
+        for (int g = 0; g < TREE_GROUP_IMPOSTOR; ++g) {
+            if (treeGroupCount[g] == 0) continue;
+            glm::vec3 first = treeBounds(treeAt(visibleTrees[treeGroupStart[g]]), u).center;
+            RenderBucket trunkBucket = g == TREE_GROUP_FADE ? BUCKET_ALPHA_TEST : BUCKET_OPAQUE;
+            renderQueue.add(drawTreeTrunksInstancedItem, trunkBucket, PROF_TREES, first, g);
+            renderQueue.add(drawTreeLeavesInstancedItem, BUCKET_ALPHA_TEST, PROF_TREES, first, g);
+        }
+        if (treeGroupCount[TREE_GROUP_FADE] + treeGroupCount[TREE_GROUP_IMPOSTOR] > 0) {
+            glm::vec3 first = treeBounds(treeAt(visibleTrees[treeGroupStart[TREE_GROUP_FADE]]), u).center;
+            renderQueue.add(drawTreeImpostorsItem, BUCKET_ALPHA_TEST, PROF_TREES, first);
+        }
+        return;
+    }
+    for (unsigned int treeIdx : visibleTrees) {
+        TreeInst ti = treeAt(treeIdx);
+        // Increase tree scaling so they are not too small vs fountain
+        float fScale = fountainScale;
+        float base = treeSizeBase(ti.size);
+        float trunkH = base * (fScale * 3.0f) * treeScaleFactor;
+        float trunkR = base * (0.10f * fScale * 1.2f) * treeScaleFactor;
+        float coneH  = base * (fScale * 2.4f) * treeScaleFactor;
+        float coneR  = base * (0.24f * fScale * 1.8f) * treeScaleFactor;
+        glm::vec3 center = treeBounds(ti, u).center;
+
+        // trunk (apply tree yaw rotation and scale)
+        glm::mat4 modelM = glm::translate(glm::mat4(1.0f), glm::vec3(ti.pos.x, 0.0f, ti.pos.y));
+        modelM = glm::rotate(modelM, glm::radians(treeYawDeg), glm::vec3(0,1,0));
+        // scale factors incorporate treeGlobalScale
+        modelM = glm::scale(modelM, glm::vec3((trunkR*treeGlobalScale)/0.08f, (trunkH*treeGlobalScale)/1.0f, (trunkR*treeGlobalScale)/0.08f));
+        renderQueue.add(drawTreeTrunkItem, BUCKET_OPAQUE, PROF_TREES, center, (int)treeIdx, modelM);
+        // foliage cone on top (apply same tree rotation and scale)
+        glm::mat4 coneM = glm::translate(glm::mat4(1.0f), glm::vec3(ti.pos.x, trunkH*treeGlobalScale, ti.pos.y));
+        coneM = glm::rotate(coneM, glm::radians(treeYawDeg), glm::vec3(0,1,0));
+        coneM = glm::scale(coneM, glm::vec3((coneR*treeGlobalScale)/0.20f, (coneH*treeGlobalScale)/1.0f, (coneR*treeGlobalScale)/0.20f));
+        renderQueue.add(drawTreeConeItem, BUCKET_ALPHA_TEST, PROF_TREES, center, (int)treeIdx, coneM);
+    }
+}
+
+// Resident world chunks that survive culling: paths and ground tile (background), trunks (opaque)
+// and cones (alpha-tested). Recorded after everything else, so unsorted they run as one
+// contiguous PROF_CHUNKS scope. A chunk's trees share one LOD, sized for a medium tree at the
+// chunk's nearest point, so each chunk stays two instanced draws. Chunks entirely past the
+// impostor fade band draw one impostor call instead; chunks overlapping the band draw their trees
+// through the dissolving programs plus the impostors.
+static void recordWorldChunks() {
+    if (!worldChunksEnabled) return;
+    TreeDims u = treeUnitDims();
+    float tallest = chunkedWorld.sizeBase[2];
+    float treeHeight = (u.trunkH + u.coneH) * tallest, treeRadius = std::max(u.trunkR, u.coneR) * tallest;
+    BoundingSphere medium = treeBounds(TreeInst{ glm::vec2(0.0f), TreeSize::Medium }, u);
+    float extent = chunkedWorld.chunkWorld();
+    for (int i = 0; i < (int)chunkedWorld.chunks.size(); ++i) {
+        WorldChunk& c = chunkedWorld.chunks[i];
+        BoundingSphere b = chunkedWorld.boundsOf(c, treeHeight, treeRadius);
+        if (!cullSphere(b, cullStats.chunks, fogCullDist)) continue;
+        if (lodEnabled && c.treeCount > 0) {
+            glm::vec3 nearest(glm::clamp(cameraPos.x, c.origin.x, c.origin.x + extent), medium.center.y,
+                              glm::clamp(cameraPos.z, c.origin.z, c.origin.z + extent));
+            float px = projectedDiameterPx(medium.radius, glm::length(nearest - cameraPos), frameProjection[1][1], (float)SCR_HEIGHT);
+            c.treeLod = selectLod(px, c.treeLod, kTreeLodMinPx, kTreeLods);
+        } else {
+            c.treeLod = 0;
+        }
+        glm::mat4 M = glm::translate(glm::mat4(1.0f), c.origin);
+        // Same distance for all of a chunk's items; the stable sort keeps its path ahead of its ground
+        if (c.pathIndexCount > 0) renderQueue.add(drawChunkPathItem, BUCKET_BACKGROUND, PROF_CHUNKS, b.center, i, M);
+        if (c.hasGround) renderQueue.add(drawChunkGroundItem, BUCKET_BACKGROUND, PROF_CHUNKS, b.center, i, M);
+        if (c.treeCount == 0) continue;
+        bool geometry = true, impostors = false;
+        if (impostorsActive()) {
+            glm::vec2 cam(cameraPos.x, cameraPos.z);
+            glm::vec2 lo(c.origin.x, c.origin.z), hi = lo + glm::vec2(extent);
+            glm::vec2 farthest(cam.x < 0.5f * (lo.x + hi.x) ? hi.x : lo.x, cam.y < 0.5f * (lo.y + hi.y) ? hi.y : lo.y);
+            float nearDist = glm::length(glm::vec3(glm::clamp(cam, lo, hi) - cam, cameraPos.y));
+            float farDist = glm::length(glm::vec3(farthest - cam, cameraPos.y));
+            // Largest trees reach the band last, smallest first (size base scales the measure)
+            geometry = nearDist / chunkedWorld.sizeBase[2] < impostorFade.end;
+            impostors = farDist / chunkedWorld.sizeBase[0] >= impostorFade.start;
+        }
+        if (geometry && impostors) {
+            renderQueue.add(drawChunkTrunksFadeItem, BUCKET_ALPHA_TEST, PROF_CHUNKS, b.center, i);
+            renderQueue.add(drawChunkLeavesFadeItem, BUCKET_ALPHA_TEST, PROF_CHUNKS, b.center, i);
+        } else if (geometry) {
+            renderQueue.add(drawChunkTrunksItem, BUCKET_OPAQUE, PROF_CHUNKS, b.center, i);
+            renderQueue.add(drawChunkLeavesItem, BUCKET_ALPHA_TEST, PROF_CHUNKS, b.center, i);
+        }
+        if (impostors) renderQueue.add(drawChunkImpostorsItem, BUCKET_ALPHA_TEST, PROF_CHUNKS, b.center, i);
+    }
+}
+
+// ---------------- Shadow pass ----------------
+// Anything that moves a caster makes every cascade due, so a throttled cascade never shows it late
+static bool shadowCastersMoved() {
+    static unsigned int lastTrees = ~0u, lastMeshes = ~0u, lastChunks = ~0u;
+    static float last[6] = {};
+    // Built or evicted chunks add or remove trees; G itself adds or removes all of them
+    unsigned int chunks = worldChunksEnabled ? chunkedWorld.residencyRevision : ~0u;
+    const float now[6] = { treeGlobalScale, treeYawDeg, fountainGlobalScale, fountainYawDeg, fountainScale, hedgeGlobalScale };
+    bool moved = lastTrees != treeRevision || lastMeshes != staticMeshRevision || lastChunks != chunks
+              || !std::equal(now, now + 6, last);
+    lastTrees = treeRevision;
+    lastMeshes = staticMeshRevision;
+    lastChunks = chunks;
+    std::copy(now, now + 6, last);
+    return moved;
+}
+
+// Authored trees inside the light frustum, into the cascade's own instance buffer (a cascade
+// rendered last frame may still be read from it, so it is orphaned first), then two instanced
+// draws at a LOD that coarsens with the cascade. Every authored draw re-points attribute 3 itself.
+static void drawShadowTrees(int c, const Frustum& light, const TreeDims& u) {
+    shadowTrees.clear();
+    for (size_t i = 0; i < treeStore.count(); ++i)
+        if (light.intersectsSphere(treeBounds(treeAt(i), u))) shadowTrees.push_back((unsigned int)i);
+    int lod = std::min(c, kTreeLods - 1);
+    if (!shadowTrees.empty()) {
+        const float sizeBase[3] = { treeSizeBase(Small), treeSizeBase(Medium), treeSizeBase(Tall) };
+        shadowTreeData.resize(shadowTrees.size() * 4);
+        packTreeInstances(treeStore, shadowTrees.data(), shadowTrees.size(), sizeBase, shadowTreeData.data());
+        GLsizeiptr bytes = (GLsizeiptr)(shadowTreeData.size() * sizeof(float));
+        if (!shadowTreeVBO[c]) glGenBuffers(1, &shadowTreeVBO[c]);
+        glBindBuffer(GL_ARRAY_BUFFER, shadowTreeVBO[c]);
+        if (bytes > shadowTreeVBOCap[c]) shadowTreeVBOCap[c] = bytes + bytes / 2;
+        glBufferData(GL_ARRAY_BUFFER, shadowTreeVBOCap[c], nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, shadowTreeData.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GLsizei count = (GLsizei)shadowTrees.size();
+        drawTreePartInstanced(shadowTreeProgram, false, trunkVAO, count, lod, shadowTreeVBO[c], 0);
+        drawTreePartInstanced(shadowLeafProgram, true, coneVAO, count, lod, shadowTreeVBO[c], 0);
+    }
+    if (!worldChunksEnabled) return;
+    // Resident chunks: their trees are already in per-chunk instance buffers
+    float tallest = chunkedWorld.sizeBase[2];
+    float treeHeight = (u.trunkH + u.coneH) * tallest, treeRadius = std::max(u.trunkR, u.coneR) * tallest;
+    for (const WorldChunk& chunk : chunkedWorld.chunks) {
+        if (chunk.treeCount == 0 || !light.intersectsSphere(chunkedWorld.boundsOf(chunk, treeHeight, treeRadius))) continue;
+        drawTreePartInstanced(shadowTreeProgram, false, chunk.trunkVAO, chunk.treeCount, lod);
+        drawTreePartInstanced(shadowLeafProgram, true, chunk.coneVAO, chunk.treeCount, lod);
+    }
+}
+
+// Fountain and hedge casters inside the light frustum. The ground, paths and ring are flat at
+// y = 0, so they only receive. Always through the static batch (B only switches the camera
+// pass); its draw list is rebuilt for the camera afterwards by recordStaticBatch.
+static void drawShadowStatics(int c, const Frustum& light) {
+    BoundingSphere fb = fountainBounds();
+    bool fountain = light.intersectsSphere(fb);
+    if (useProceduralFountain) {
+        if (fountain) drawProceduralFountain(shadowMeshProgram);
+    }
+    packStaticBatch();
+    staticBatch.clearDraws();
+    if (!useProceduralFountain && fountain) {
+        applyFountainTransform();
+        int lod = std::min(fountainLod + c, fountainModel.meshes[0].lodCount - 1);
+        staticBatch.addDraw(SLOT_FOUNTAIN + lod, modelMatrix(fountainModel), -1);
+    }
+    forEachHedgeWedge([&](const glm::mat4& M, const BoundingSphere& bounds, bool outer){
+        if (light.intersectsSphere(bounds)) staticBatch.addDraw(outer ? SLOT_WEDGE_OUTER : SLOT_WEDGE_INNER, M, LAYER_MOSS);
+    });
+    bindMaterial(textureMaterial(-1));
+    staticBatch.submit(shadowBatchProgram, shadowRigidProgram, shadowRigidProgram);
+    staticBatch.clearDraws();
+}
+
+// Render the cascades due this frame, each in its own profiler scope, with the light's view in
+// that cascade's frame block slot. Leaves the camera slot, framebuffer and viewport bound.
+static void renderShadowPass(const glm::mat4& view, const glm::mat4& projection) {
+    if (!shadowsEnabled || !shadowMaps.ready()) return;
+    if (shadowCastersMoved()) shadowMaps.invalidate();
+    TreeDims u = treeUnitDims();
+    for (int c = 0; c < kShadowCascades; ++c) {
+        if (!shadowMaps.due(c)) continue;
+        ProfileScopeGuard scope((ProfileScope)(PROF_SHADOW_CASCADE0 + c));
+        shadowMaps.fit(c, view, projection, kLightDir);
+        const ShadowCascade& sc = shadowMaps.cascades[c];
+        FrameUniforms light;
+        light.view = sc.view;
+        light.projection = sc.projection;
+        light.viewPos = glm::vec3(glm::inverse(sc.view)[3]);
+        light.lightDir = kLightDir;
+        updateFrameUniforms(light, 1 + c);
+        bindFrameUniforms(1 + c);
+        Frustum lightFrustum;
+        lightFrustum.extract(sc.projection * sc.view);
+        shadowMaps.beginCascade(c);
+        drawShadowStatics(c, lightFrustum);
+        drawShadowTrees(c, lightFrustum, u);
+    }
+    shadowMaps.endFrame();
+    bindFrameUniforms(0);
+}
+
+// Cull and record the opaque 3D pass (everything but the blended fireflies). Unsorted, the items
+// keep the old draw order: ground, paths, fountain, trees, hedges, ring, then the world chunks.
+static void recordScenePass() {
+    renderQueue.begin(cameraPos);
+    const glm::vec3 origin(0.0f);
+    bool fountainVisible = cullSphere(fountainBounds(), cullStats.fountain, fogCullDist);
+    if (!useProceduralFountain && fountainVisible) {
+        BoundingSphere fb = fountainBounds();
+        float px = projectedDiameterPx(fb.radius, glm::length(fb.center - cameraPos), frameProjection[1][1], (float)SCR_HEIGHT);
+        fountainLod = lodEnabled ? selectLod(px, fountainLod, kFountainLodMinPx, fountainModel.meshes[0].lodCount) : 0;
+    }
+    if (staticBatching) {
+        // Ground, paths, OBJ fountain, hedges and ring from the shared arena
+        recordStaticBatch(fountainVisible);
+        renderQueue.add(drawStaticBatchItem, BUCKET_BACKGROUND, PROF_STATIC_BATCH, origin);
+        if (useProceduralFountain && fountainVisible)
+            renderQueue.add(drawFountainItem, BUCKET_OPAQUE, PROF_FOUNTAIN, fountainBounds().center);
+        recordTrees();
+        recordWorldChunks();
+        return;
+    }
+    // Sorted, the ground goes last within the background: paths and ring lie on it and hide part of it
+    if (!renderQueue.frontToBack) renderQueue.add(drawGroundItem, BUCKET_BACKGROUND, PROF_GROUND, origin);
+    renderQueue.add(drawPathsItem, BUCKET_BACKGROUND, PROF_PATHS, origin);
+    if (fountainVisible) renderQueue.add(drawFountainItem, BUCKET_OPAQUE, PROF_FOUNTAIN, fountainBounds().center);
+    recordTrees();
+    BoundingSphere innerLocal = wedgeLocalBounds(wedgeRInner1, wedgeROuter1, wedgeHalfAng1, hedgeHeight);
+    BoundingSphere outerLocal = wedgeLocalBounds(wedgeRInner2, wedgeROuter2, wedgeHalfAng2, hedgeHeight);
+    forEachVisibleHedgeWedge([&](const glm::mat4& M, bool outer){
+        glm::vec3 center(M * glm::vec4((outer ? outerLocal : innerLocal).center, 1.0f));
+        renderQueue.add(drawHedgeWedgeItem, BUCKET_OPAQUE, PROF_HEDGES, center, outer ? 1 : 0, M);
+    });
+    renderQueue.add(drawRingItem, BUCKET_BACKGROUND, PROF_RING, origin);
+    if (renderQueue.frontToBack) renderQueue.add(drawGroundItem, BUCKET_BACKGROUND, PROF_GROUND, origin);
+    recordWorldChunks();
+}
+
+// Generic model drawer
+void drawObject(Model& model, const glm::vec3& position) {
+    model.position = position;
+    drawModel(model);
+}
+
+// Draw fireflies with additive blending: one instanced draw of the visible ones, animated in
+// firefly.vert. The instance buffer is only rewritten when the visible set changes.
+void drawFireflies(ShaderProgram& shader) {
+    if (fireflies.empty()) return;
+    std::vector<unsigned int> visible;
+    visible.reserve(fireflies.size());
+    float maxDistance = std::min(fogCullDist, kFireflyFadeDistance);
+    for (size_t i = 0; i < fireflies.size(); ++i) {
+        if (cullSphere(BoundingSphere{ fireflies[i].position, kFireflyCullRadius }, cullStats.fireflies, maxDistance))
+            visible.push_back((unsigned int)i);
+    }
+    if (visible != uploadedFireflies) {
+        std::vector<float> data;
+        data.reserve(visible.size() * 8);
+        for (unsigned int i : visible)
+            data.insert(data.end(), fireflyInstanceData.begin() + i*8, fireflyInstanceData.begin() + (i+1)*8);
+        glBindBuffer(GL_ARRAY_BUFFER, fireflyInstanceVBO);
+        if (!data.empty()) glBufferSubData(GL_ARRAY_BUFFER, 0, data.size()*sizeof(float), data.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        uploadedFireflies.swap(visible);
+    }
+    if (uploadedFireflies.empty()) return;
+    setBlend(true);
+    setBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+    // Camera and animation time come from the frame block
+    shader.use();
+
+    bindVertexArray(fireflyVAO);
+    glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, (GLsizei)uploadedFireflies.size()); profileCountDraw();
+    setBlend(false); // disable after firefly pass so opaque models aren't blended
 }
 
 // (Removed debug cube rendering)
@@ -891,52 +2017,112 @@ static inline glm::ivec2 worldToScreen(const glm::vec2& w) {
     return glm::ivec2(sx, sy);
 }
 
-void drawBlueprintOverlay() {
-    // Pixel grid-based overlay for 2D view
-    if (currentView != VIEW_2D) return;
-    glDisable(GL_DEPTH_TEST);
-    glUseProgram(0);
-    beginOrtho2D(SCR_WIDTH, SCR_HEIGHT);
-
-    // Grid parameters: auto-scale so the whole map fits with margins and reserved legend space
+// Retained overlay geometry. Grid lines live in a static VBO, cell quads in one dynamic VBO that
+// is rebuilt only when the inputs in OverlayCellKey change, and tree markers in a VBO keyed on
+// treeRevision. Drawn through the fixed-function client arrays, like the rest of the overlay.
+struct OverlayGridLayout { int cellSize, gridWpx, gridHpx, originX, originY; };
+struct OverlayCellKey {
+    unsigned int treeRev; int fountainRadius; float hedgeScale; unsigned int layoutRev; bool layout;
+    bool operator==(const OverlayCellKey& o) const {
+        return treeRev==o.treeRev && fountainRadius==o.fountainRadius && hedgeScale==o.hedgeScale
+            && layoutRev==o.layoutRev && layout==o.layout;
+    }
+};
+GLuint overlayLineVBO = 0;           // border loop (4 verts) followed by grid lines
+GLsizei overlayLineVertCount = 0;
+GLuint overlayCellVBO = 0;           // pos(2) + color(3) per vertex, 4 verts per cell
+GLsizei overlayCellVertCount = 0;
+GLsizeiptr overlayCellVBOCap = 0;
+OverlayCellKey overlayCellKey;
+bool overlayCellsValid = false;
+std::vector<unsigned char> overlayOcc; // flat designGridW*designGridH occupancy, index gx*designGridH+gy
+std::vector<float> overlayCellScratch; // reused vertex staging for the cell VBO
+GLuint treeMarkerVBO = 0;            // pos(2), 4 verts per tree
+GLsizei treeMarkerVertCount = 0;
+GLsizeiptr treeMarkerVBOCap = 0;
+unsigned int treeMarkerRevision = ~0u;
+
+// Grid parameters: auto-scale so the whole map fits with margins and reserved legend space
+static OverlayGridLayout overlayGridLayout() {
     int margin = 16;
     int reservedBottom = 28; // leave room for legend and flash bar
     int maxCellW = std::max(1, (SCR_WIDTH  - 2*margin) / std::max(1, designGridW));
     int maxCellH = std::max(1, (SCR_HEIGHT - 2*margin - reservedBottom) / std::max(1, designGridH));
-    int cellSize = std::max(4, std::min(maxCellW, maxCellH));
-    int gridWpx = designGridW * cellSize;
-    int gridHpx = designGridH * cellSize;
+    OverlayGridLayout g;
+    g.cellSize = std::max(4, std::min(maxCellW, maxCellH));
+    g.gridWpx = designGridW * g.cellSize;
+    g.gridHpx = designGridH * g.cellSize;
     // Center the grid horizontally and vertically (above reservedBottom)
-    int originX = std::max(margin, (SCR_WIDTH - gridWpx)/2);
-    int originY = std::max(margin, (SCR_HEIGHT - reservedBottom - gridHpx)/2);
-    auto cellToScreen = [&](int gx, int gy){ return glm::ivec2(originX + gx*cellSize, originY + gy*cellSize); };
+    g.originX = std::max(margin, (SCR_WIDTH - g.gridWpx)/2);
+    g.originY = std::max(margin, (SCR_HEIGHT - reservedBottom - g.gridHpx)/2);
+    return g;
+}
 
-    // Cyan border
-    glColor3f(0.0f, 0.8f, 0.85f);
-    glBegin(GL_LINE_LOOP);
-        glVertex2i(originX, originY);
-        glVertex2i(originX + gridWpx, originY);
-        glVertex2i(originX + gridWpx, originY + gridHpx);
-        glVertex2i(originX, originY + gridHpx);
-    glEnd();
+// Upload into a dynamic VBO, growing it by 1.5x when the data no longer fits
+static void uploadOverlayVBO(GLuint &vbo, GLsizeiptr &cap, const std::vector<float>& data) {
+    if (!vbo) glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLsizeiptr bytes = (GLsizeiptr)(data.size()*sizeof(float));
+    if (bytes > cap) {
+        cap = std::max(bytes, cap + cap/2);
+        glBufferData(GL_ARRAY_BUFFER, cap, nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (bytes > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    // Grid lines
-    glColor3f(0.18f, 0.18f, 0.20f);
+// Draw a range of 2D vertices from a VBO; withColor selects pos(2)+color(3) over pos(2) only
+static void drawOverlayArrays(GLuint vbo, GLenum mode, GLint first, GLsizei count, bool withColor) {
+    if (!vbo || count <= 0) return;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (withColor) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 5*sizeof(float), (void*)0);
+        glColorPointer(3, GL_FLOAT, 5*sizeof(float), (void*)(2*sizeof(float)));
+    } else {
+        glVertexPointer(2, GL_FLOAT, 2*sizeof(float), (void*)0);
+    }
+    glDrawArrays(mode, first, count); profileCountDraw();
+    if (withColor) glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Cyan border and grid lines; depends only on the grid dimensions, so built once
+static void buildOverlayLines(const OverlayGridLayout& g) {
+    if (overlayLineVBO) return;
+    std::vector<float> v;
+    v.reserve((4 + 2*(designGridW + designGridH + 2)) * 2);
+    auto push = [&](int x, int y){ v.push_back((float)x); v.push_back((float)y); };
+    push(g.originX, g.originY);
+    push(g.originX + g.gridWpx, g.originY);
+    push(g.originX + g.gridWpx, g.originY + g.gridHpx);
+    push(g.originX, g.originY + g.gridHpx);
     for (int gx=0; gx<=designGridW; ++gx) {
-        int x = originX + gx*cellSize;
-        glBegin(GL_LINES); glVertex2i(x, originY); glVertex2i(x, originY + gridHpx); glEnd();
+        int x = g.originX + gx*g.cellSize;
+        push(x, g.originY); push(x, g.originY + g.gridHpx);
     }
     for (int gy=0; gy<=designGridH; ++gy) {
-        int y = originY + gy*cellSize;
-        glBegin(GL_LINES); glVertex2i(originX, y); glVertex2i(originX + gridWpx, y); glEnd();
+        int y = g.originY + gy*g.cellSize;
+        push(g.originX, y); push(g.originX + g.gridWpx, y);
     }
+    glGenBuffers(1, &overlayLineVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, overlayLineVBO);
+    glBufferData(GL_ARRAY_BUFFER, v.size()*sizeof(float), v.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    overlayLineVertCount = (GLsizei)(v.size() / 2);
+}
 
-    // Occupancy maps: path, fountain core, annulus (fountain edge -> wedges), tree
-    std::vector<std::vector<unsigned char>> occ(designGridW, std::vector<unsigned char>(designGridH, 0));
+// Occupancy maps: path, fountain core, annulus (fountain edge -> wedges), tree; then cell quads
+static void rebuildOverlayCells(const OverlayGridLayout& g) {
+    overlayOcc.assign((size_t)designGridW * designGridH, 0);
+    auto occ = [&](int gx, int gy) -> unsigned char& { return overlayOcc[(size_t)gx * designGridH + gy]; };
     // Fountain core and ring (compute first so we can prevent path marks inside)
     glm::ivec2 fCenter(designGridW/2, designGridH/2);
     // Map pixel fountainRadius to grid cells consistently with 3D logic
-    int fountainGridR = std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
+    int fountainGridR = fountainGridRadius();
+    const OccupancyGrid& grid = currentOccupancy();
     // Use current scaled hedge outer radius to derive grid-space wedge boundary
     float cellWorld = 20.0f / (float)designGridW;
     float wedgeOuterGridR = (wedgeROuter2 * hedgeGlobalScale) / cellWorld;
@@ -944,116 +2130,110 @@ void drawBlueprintOverlay() {
         for (int gy=0; gy<designGridH; ++gy) {
             int dx = gx - fCenter.x, dy = gy - fCenter.y; int d2 = dx*dx + dy*dy;
             if (d2 <= (fountainGridR-2)*(fountainGridR-2)) {
-                occ[gx][gy] = 2; // core fountain (bluish white)
+                occ(gx, gy) = 2; // core fountain (bluish white)
             } else if (d2 <= fountainGridR*fountainGridR) {
-                if (occ[gx][gy]==0) occ[gx][gy] = 3; // inner ring (thin)
+                if (occ(gx, gy)==0) occ(gx, gy) = 3; // inner ring (thin)
             }
         }
     }
-    // Helper: point in triangle for hedge exclusion
-    auto pointInTri2 = [](const glm::vec2& p, const Tri& t){
-        auto sign=[&](const glm::vec2& p1,const glm::vec2& p2,const glm::vec2& p3){ return (p1.x - p3.x)*(p2.y - p3.y) - (p2.x - p3.x)*(p1.y - p3.y); };
-        float d1 = sign(p, t.a, t.b), d2 = sign(p, t.b, t.c), d3 = sign(p, t.c, t.a);
-        bool hasNeg = (d1<0) || (d2<0) || (d3<0);
-        bool hasPos = (d1>0) || (d2>0) || (d3>0);
-        return !(hasNeg && hasPos);
-    };
-    // Mark paths using Bresenham, but skip any cell inside the full annulus (fountain -> wedges)
-    // or inside hedge wedge footprints
+    // Mark path cells (Bresenham, rasterized into the occupancy grid), but skip any cell inside
+    // the full annulus (fountain -> wedges) or inside hedge wedge footprints
     if (layoutGenerated && !layoutPaths.empty()) {
-        for (auto &lp : layoutPaths) {
-            int x0=lp.a.x, y0=lp.a.y, x1=lp.b.x, y1=lp.b.y;
-            int dx=abs(x1-x0), dy=abs(y1-y0); int sx = x0<x1?1:-1; int sy=y0<y1?1:-1; int err=dx-dy;
-            while(true){
-                if (x0>=0&&x0<designGridW&&y0>=0&&y0<designGridH) {
-                    int ddx = x0 - fCenter.x, ddy = y0 - fCenter.y; int d2 = ddx*ddx + ddy*ddy;
-                    bool inCircle = d2 <= (int)std::ceil(wedgeOuterGridR*wedgeOuterGridR); // exclude entire annulus up to wedges
-                    bool inHedge = false;
-                    if (!inCircle) {
-                        glm::vec3 w = gridToWorld(x0, y0);
-                        glm::vec2 p(w.x, w.z);
-                        for (auto &tri : hedgeWedgeTris) { if (pointInTri2(p, tri)) { inHedge=true; break; } }
-                    }
-                    if (!inCircle && !inHedge && occ[x0][y0]==0) occ[x0][y0] = 1; // path only if empty and allowed
-                }
-                if (x0==x1 && y0==y1) break;
-                int e2=2*err; if (e2> -dy){ err -= dy; x0 += sx; } if (e2 < dx){ err += dx; y0 += sy; }
+        for (int gx=0; gx<designGridW; ++gx) {
+            for (int gy=0; gy<designGridH; ++gy) {
+                uint8_t bits = grid.atCell(gx, gy);
+                if (!(bits & OCC_PATH) || (bits & OCC_HEDGE_WEDGE) || occ(gx, gy) != 0) continue;
+                int dx = gx - fCenter.x, dy = gy - fCenter.y; int d2 = dx*dx + dy*dy;
+                bool inCircle = d2 <= (int)std::ceil(wedgeOuterGridR*wedgeOuterGridR); // exclude entire annulus up to wedges
+                if (!inCircle) occ(gx, gy) = 1; // path only if empty and allowed
             }
         }
     }
     // Trees: mark tree cells to avoid grass painting; markers drawn later with sizes
-    for (auto &ti : treeInstances) {
+    for (size_t i = 0; i < treeStore.count(); ++i) {
+        TreeInst ti = treeAt(i);
         int gx = (int)glm::clamp(((ti.pos.x + 10.0f) / 20.0f) * designGridW + 0.5f, 0.0f, (float)designGridW - 1.0f);
         int gy = (int)glm::clamp(((ti.pos.y + 10.0f) / 20.0f) * designGridH + 0.5f, 0.0f, (float)designGridH - 1.0f);
-        occ[gx][gy] = 4; // tree present
+        occ(gx, gy) = 4; // tree present
     }
-    // Hedge wedges: mark cells inside any wedge triangle footprint (reuse pointInTri2 defined above)
+    // Hedge wedges: mark cells inside any wedge triangle footprint
     for (int gx=0; gx<designGridW; ++gx) {
         for (int gy=0; gy<designGridH; ++gy) {
-            if (occ[gx][gy] != 0) continue; // keep higher-priority features
-            glm::vec3 w = gridToWorld(gx, gy);
-            glm::vec2 p(w.x, w.z);
-            for (auto &tri : hedgeWedgeTris) {
-                if (pointInTri2(p, tri)) { occ[gx][gy] = 5; break; }
-            }
+            if (occ(gx, gy) != 0) continue; // keep higher-priority features
+            if (grid.atCell(gx, gy) & OCC_HEDGE_WEDGE) occ(gx, gy) = 5;
         }
     }
 
     // Annulus fill: mark remaining cells between fountain edge and outer wedge radius as yellow
     for (int gx=0; gx<designGridW; ++gx) {
         for (int gy=0; gy<designGridH; ++gy) {
-            if (occ[gx][gy] != 0) continue; // don't override paths/trees/hedges/core
+            if (occ(gx, gy) != 0) continue; // don't override paths/trees/hedges/core
             int dx = gx - fCenter.x, dy = gy - fCenter.y; int d2 = dx*dx + dy*dy;
             if (d2 > fountainGridR*fountainGridR && d2 <= wedgeOuterGridR*wedgeOuterGridR) {
-                occ[gx][gy] = 3; // annulus area (yellow)
+                occ(gx, gy) = 3; // annulus area (yellow)
             }
         }
     }
 
-    // Paint cells: grass (light green) where empty, path brown, fountain bluish white, annulus yellow, trees dark green, bushes mid green
-    auto fillCell = [&](int gx, int gy, float r, float g, float b, int pad){
-        glm::ivec2 tl = cellToScreen(gx, gy);
-        glColor3f(r,g,b);
-        glBegin(GL_QUADS);
-            glVertex2i(tl.x+pad, tl.y+pad);
-            glVertex2i(tl.x+cellSize-pad, tl.y+pad);
-            glVertex2i(tl.x+cellSize-pad, tl.y+cellSize-pad);
-            glVertex2i(tl.x+pad, tl.y+cellSize-pad);
-        glEnd();
+    // Cell quads: grass (light green) where empty, path brown, fountain bluish white, annulus yellow, trees dark green, bushes mid green
+    struct CellStyle { float r, g, b; int pad; };
+    static const CellStyle kStyles[6] = {
+        {0.60f, 0.85f, 0.60f, 3}, // 0 empty grass (light green)
+        {0.55f, 0.40f, 0.20f, 3}, // 1 path (brown)
+        {0.85f, 0.90f, 0.98f, 2}, // 2 fountain core (bluish white)
+        {0.95f, 0.92f, 0.35f, 2}, // 3 fountain ring / annulus (yellow)
+        {0.10f, 0.35f, 0.18f, 4}, // 4 tree cell (darker base under marker)
+        {0.25f, 0.70f, 0.35f, 3}  // 5 bush (mid green)
     };
+    overlayCellScratch.clear();
+    overlayCellScratch.reserve(overlayOcc.size() * 20);
     for (int gx=0; gx<designGridW; ++gx) {
         for (int gy=0; gy<designGridH; ++gy) {
-            switch(occ[gx][gy]) {
-                case 0: // empty grass
-                    fillCell(gx, gy, 0.60f, 0.85f, 0.60f, 3); // light green
-                    break;
-                case 1: // path
-                    fillCell(gx, gy, 0.55f, 0.40f, 0.20f, 3); // brown
-                    break;
-                case 2: // fountain core
-                    fillCell(gx, gy, 0.85f, 0.90f, 0.98f, 2); // bluish white
-                    break;
-                case 3: // fountain ring / annulus
-                    fillCell(gx, gy, 0.95f, 0.92f, 0.35f, 2); // yellow
-                    break;
-                case 4: // tree cell (background keep dark to emphasize marker)
-                    fillCell(gx, gy, 0.10f, 0.35f, 0.18f, 4); // darker base under marker
-                    break;
-                case 5: // bush
-                    fillCell(gx, gy, 0.25f, 0.70f, 0.35f, 3); // mid green
-                    break;
-            }
+            const CellStyle& c = kStyles[occ(gx, gy)];
+            float x0 = (float)(g.originX + gx*g.cellSize + c.pad), x1 = (float)(g.originX + (gx+1)*g.cellSize - c.pad);
+            float y0 = (float)(g.originY + gy*g.cellSize + c.pad), y1 = (float)(g.originY + (gy+1)*g.cellSize - c.pad);
+            overlayCellScratch.insert(overlayCellScratch.end(), {
+                x0, y0, c.r, c.g, c.b,  x1, y0, c.r, c.g, c.b,
+                x1, y1, c.r, c.g, c.b,  x0, y1, c.r, c.g, c.b });
         }
     }
+    uploadOverlayVBO(overlayCellVBO, overlayCellVBOCap, overlayCellScratch);
+    overlayCellVertCount = (GLsizei)(overlayCellScratch.size() / 5);
+}
+
+void drawBlueprintOverlay() {
+    // Pixel grid-based overlay for 2D view
+    if (currentView != VIEW_2D) return;
+    setDepthTest(false);
+    useProgram(0);
+    beginOrtho2D(SCR_WIDTH, SCR_HEIGHT);
+
+    OverlayGridLayout g = overlayGridLayout();
+    buildOverlayLines(g);
+    OverlayCellKey key{treeRevision, fountainRadius, hedgeGlobalScale, layoutRevision, layoutGenerated};
+    if (!overlayCellsValid || !(key == overlayCellKey)) {
+        rebuildOverlayCells(g);
+        overlayCellKey = key;
+        overlayCellsValid = true;
+    }
+
+    // Cyan border, then grid lines
+    glColor3f(0.0f, 0.8f, 0.85f);
+    drawOverlayArrays(overlayLineVBO, GL_LINE_LOOP, 0, 4, false);
+    glColor3f(0.18f, 0.18f, 0.20f);
+    drawOverlayArrays(overlayLineVBO, GL_LINES, 4, overlayLineVertCount - 4, false);
+
+    // Paint cells
+    drawOverlayArrays(overlayCellVBO, GL_QUADS, 0, overlayCellVertCount, true);
 
     // Legend color chips
     // Place legend under grid if there is space; otherwise above the grid
-    int proposedLegendY = originY + gridHpx + 8;
+    int proposedLegendY = g.originY + g.gridHpx + 8;
     int legendY = proposedLegendY;
-    if (legendY + 12 > SCR_HEIGHT) legendY = std::max(8, originY - 18);
-    int lx = originX;
-    auto legendRect=[&](float r,float g,float b){
-        glColor3f(r,g,b);
+    if (legendY + 12 > SCR_HEIGHT) legendY = std::max(8, g.originY - 18);
+    int lx = g.originX;
+    auto legendRect=[&](float r,float gr,float b){
+        glColor3f(r,gr,b);
         glBegin(GL_QUADS);
             glVertex2i(lx, legendY);
             glVertex2i(lx+18, legendY);
@@ -1081,59 +2261,352 @@ void drawBlueprintOverlay() {
     }
 
     endOrtho2D();
-    glEnable(GL_DEPTH_TEST);
+    setDepthTest(true);
+}
+
+// Profiler bar (F1), drawn top-left in both views like the debug flash bar. Top strip: GPU time, bottom
+// strip: CPU time, each stacked per scope and scaled so the frame marker sits at 16.7 ms.
+static const float kProfilerScopeColors[PROF_SCOPE_COUNT][3] = {
+    {0.45f, 0.75f, 0.35f}, // ground
+    {0.60f, 0.45f, 0.25f}, // paths
+    {0.80f, 0.85f, 0.95f}, // fountain
+    {0.15f, 0.50f, 0.20f}, // trees
+    {0.35f, 0.80f, 0.55f}, // hedges
+    {0.95f, 0.90f, 0.35f}, // ring
+    {1.00f, 0.60f, 0.20f}, // fireflies
+    {0.55f, 0.55f, 0.95f}, // overlay
+    {0.85f, 0.55f, 0.85f}, // static batch
+    {0.40f, 0.40f, 0.45f}, // depth pre-pass
+    {0.30f, 0.65f, 0.45f}, // opaque
+    {0.20f, 0.80f, 0.30f}, // alpha test
+    {0.55f, 0.70f, 0.40f}, // background
+    {0.95f, 0.40f, 0.40f}, // chunk streaming
+    {0.25f, 0.45f, 0.30f}, // chunks
+    {0.30f, 0.30f, 0.55f}, // shadow cascade 0
+    {0.40f, 0.40f, 0.65f}, // shadow cascade 1
+    {0.50f, 0.50f, 0.75f}  // shadow cascade 2
+};
+
+static void drawProfilerBar() {
+    const ProfileFrame& f = profilerLatestFrame();
+    const float pxPerMs = 300.0f / 16.667f;
+    const int x0 = 10, gpuY = SCR_HEIGHT - 24, cpuY = SCR_HEIGHT - 38, stripH = 12;
+    setDepthTest(false);
+    useProgram(0);
+    beginOrtho2D(SCR_WIDTH, SCR_HEIGHT);
+    glBegin(GL_QUADS);
+        // background
+        glColor3f(0.05f, 0.05f, 0.06f);
+        glVertex2i(x0 - 4, cpuY - 4); glVertex2i(x0 + 604, cpuY - 4);
+        glVertex2i(x0 + 604, gpuY + stripH + 4); glVertex2i(x0 - 4, gpuY + stripH + 4);
+        float gpuX = (float)x0, cpuX = (float)x0;
+        for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+            const ProfileSample& sm = f.scopes[s];
+            if (!sm.ran) continue;
+            glColor3f(kProfilerScopeColors[s][0], kProfilerScopeColors[s][1], kProfilerScopeColors[s][2]);
+            float gw = std::min((float)sm.gpuMs * pxPerMs, x0 + 600.0f - gpuX);
+            float cw = std::min((float)sm.cpuMs * pxPerMs, x0 + 600.0f - cpuX);
+            glVertex2f(gpuX, (float)gpuY); glVertex2f(gpuX + gw, (float)gpuY);
+            glVertex2f(gpuX + gw, (float)(gpuY + stripH)); glVertex2f(gpuX, (float)(gpuY + stripH));
+            glVertex2f(cpuX, (float)cpuY); glVertex2f(cpuX + cw, (float)cpuY);
+            glVertex2f(cpuX + cw, (float)(cpuY + stripH)); glVertex2f(cpuX, (float)(cpuY + stripH));
+            gpuX += gw; cpuX += cw;
+        }
+    glEnd();
+    // 16.7 ms (60 Hz) marker
+    glColor3f(1.0f, 1.0f, 1.0f);
+    glBegin(GL_LINES);
+        glVertex2i(x0 + 300, cpuY - 4);
+        glVertex2i(x0 + 300, gpuY + stripH + 4);
+    glEnd();
+    endOrtho2D();
+    setDepthTest(true);
+}
+
+// Console summary of the latest resolved frame (per-scope times and counters)
+static void logProfilerFrame() {
+    const ProfileFrame& f = profilerLatestFrame();
+    std::cout << "[Info] Profile frame " << f.index << ": " << f.frameCpuMs << " ms CPU\n";
+    for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+        const ProfileSample& sm = f.scopes[s];
+        if (!sm.ran) continue;
+        std::cout << "       " << profileScopeName((ProfileScope)s) << ": cpu " << sm.cpuMs << " ms, gpu " << sm.gpuMs
+                  << " ms, draws " << sm.drawCalls << ", uniforms " << sm.uniformUploads << ", state changes " << sm.stateChanges << "\n";
+    }
 }
 
 // Draw 2D pixel glyphs for trees (fountain handled in overlay) in VIEW_2D
 void drawPixelObjects2D() {
     if (currentView != VIEW_2D) return;
-    glDisable(GL_DEPTH_TEST);
-    glUseProgram(0);
+    setDepthTest(false);
+    useProgram(0);
     beginOrtho2D(SCR_WIDTH, SCR_HEIGHT);
 
-    auto drawFilledPixel = [](int px, int py, int size){
-        glBegin(GL_QUADS);
-            glVertex2i(px, py);
-            glVertex2i(px + size, py);
-            glVertex2i(px + size, py + size);
-            glVertex2i(px, py + size);
-        glEnd();
+    // Trees: markers at exact mapped screen positions to avoid overlapping in the same cell.
+    // The marker VBO is only rebuilt when trees were added or moved.
+    if (treeMarkerRevision != treeRevision) {
+        OverlayGridLayout g = overlayGridLayout();
+        auto worldToScreenOverlay = [&](float wx, float wz){
+            float xNorm = ((wx + 10.0f) / 20.0f) * (float)designGridW;
+            float yNorm = ((wz + 10.0f) / 20.0f) * (float)designGridH;
+            int sx = g.originX + (int)std::round(xNorm * g.cellSize);
+            int sy = g.originY + (int)std::round(yNorm * g.cellSize);
+            return glm::ivec2(sx, sy);
+        };
+        std::vector<float> v;
+        v.reserve(treeStore.count() * 8);
+        for (size_t i = 0; i < treeStore.count(); ++i) {
+            TreeInst ti = treeAt(i);
+            glm::ivec2 s = worldToScreenOverlay(ti.pos.x, ti.pos.y);
+            // Size: 2x2 for small, 3x3 for medium, 4x4 for tall for better visibility
+            int marker = (ti.size==Small?2:(ti.size==Medium?3:4));
+            float x0 = (float)(s.x - marker/2), y0 = (float)(s.y - marker/2);
+            float x1 = x0 + marker, y1 = y0 + marker;
+            v.insert(v.end(), {x0, y0, x1, y0, x1, y1, x0, y1});
+        }
+        uploadOverlayVBO(treeMarkerVBO, treeMarkerVBOCap, v);
+        treeMarkerVertCount = (GLsizei)(v.size() / 2);
+        treeMarkerRevision = treeRevision;
+    }
+    glColor3f(0.15f, 0.65f, 0.35f);
+    drawOverlayArrays(treeMarkerVBO, GL_QUADS, 0, treeMarkerVertCount, false);
+
+    endOrtho2D();
+    setDepthTest(true);
+}
+
+// ----------------- Layout generation -----------------
+// Bootstrap layout: hub paths to the fountain cell, star hedge wedge footprints, Poisson-disk
+// trees. generateLayout is a pure function of LayoutParams (its own RNG and occupancy grid), so it
+// runs on a job worker; applyLayout publishes the result on the main thread.
+struct LayoutParams {
+    int smallCount, mediumCount, tallCount, pathCount;
+    int fountainRadius, seed;
+    int gridW, gridH, occupancySub;
+    float hedgeScale, treeMinSpacing;
+    float fountainFoot; // fountain footprint radius the per-tree gaps are measured from
+};
+struct LayoutResult {
+    std::vector<LayoutPath> paths;
+    std::vector<Tri> wedgeTris;
+    float rInner1, rOuter1, halfAng1, rInner2, rOuter2, halfAng2;
+    int innerCount, outerCount;
+    TreeStore trees;                             // with their margins, like treeStore
+    int placed[3] = { 0, 0, 0 };                 // per TreeSize
+    int targetTotal = 0;
+};
+
+static void generateLayout(const LayoutParams& p, LayoutResult& out) {
+    // Paths and trees draw from one seeded engine: workers must not use rand(), whose state is
+    // per thread on some C runtimes
+    std::mt19937 layoutRng((unsigned int)p.seed);
+    auto randBelow = [&](int n){ return (int)(layoutRng() % (unsigned int)n); };
+
+    // Hub-style paths: connect random allowed forest cells back to the central fountain cell
+    // Fountain is at design grid center
+    glm::ivec2 fountainCell(p.gridW/2, p.gridH/2);
+    // Compute wedge outer radius in GRID units using same factors as hedges (ROuter2 = 3.6 * fWorldR)
+    int frGrid = std::max(2, (int)(p.fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(p.gridW,p.gridH))));
+    float wedgeOuterGrid = frGrid * 3.6f;
+    auto outsideWedgeCircle = [&](const glm::ivec2& cell){
+        int dx = cell.x - fountainCell.x; int dy = cell.y - fountainCell.y;
+        return (dx*dx + dy*dy) > (int)std::ceil(wedgeOuterGrid*wedgeOuterGrid);
+    };
+    auto sampleStartOutside = [&](){
+        // Try random sampling first
+        for (int t=0;t<4000;t++) {
+            glm::ivec2 cand(randBelow(p.gridW), randBelow(p.gridH));
+            if (outsideWedgeCircle(cand)) return cand;
+        }
+        // Fallback: pick a random angle and place on boundary near the edge of grid
+        float ang = (randBelow(1000)/1000.0f) * 6.2831853f;
+        float r = std::max({fountainCell.x, p.gridW-1 - fountainCell.x, fountainCell.y, p.gridH-1 - fountainCell.y}) - 1.0f;
+        glm::ivec2 cand(
+            fountainCell.x + (int)std::round(r * cosf(ang)),
+            fountainCell.y + (int)std::round(r * sinf(ang))
+        );
+        cand.x = std::max(0, std::min(p.gridW-1, cand.x));
+        cand.y = std::max(0, std::min(p.gridH-1, cand.y));
+        return cand;
     };
+    for (int i=0;i<p.pathCount;i++) {
+        glm::ivec2 a = sampleStartOutside();
+        glm::ivec2 b = fountainCell; // all paths terminate at fountain
+        // Path cells are rasterized with Bresenham into the occupancy grid (OCC_PATH)
+        out.paths.push_back({a,b,true});
+    }
 
-    // Trees: draw markers at exact mapped screen positions to avoid overlapping in the same cell
-    int margin = 16;
-    int reservedBottom = 28;
-    int maxCellW = std::max(1, (SCR_WIDTH  - 2*margin) / std::max(1, designGridW));
-    int maxCellH = std::max(1, (SCR_HEIGHT - 2*margin - reservedBottom) / std::max(1, designGridH));
-    int cellSize = std::max(4, std::min(maxCellW, maxCellH));
-    int gridWpx = designGridW * cellSize;
-    int gridHpx = designGridH * cellSize;
-    int originX = std::max(margin, (SCR_WIDTH - gridWpx)/2);
-    int originY = std::max(margin, (SCR_HEIGHT - reservedBottom - gridHpx)/2);
-    auto worldToScreenOverlay = [&](float wx, float wz){
-        float xNorm = ((wx + 10.0f) / 20.0f) * (float)designGridW;
-        float yNorm = ((wz + 10.0f) / 20.0f) * (float)designGridH;
-        int sx = originX + (int)std::round(xNorm * cellSize);
-        int sy = originY + (int)std::round(yNorm * cellSize);
-        return glm::ivec2(sx, sy);
+    // Hedge wedges: compute world-space triangle footprints before tree placement
+    float cellWorld = 20.0f / (float)p.gridW;
+    float fWorldR = frGrid * cellWorld;
+    // Reduced radii for a tighter star pattern
+    out.rInner1 = fWorldR * 1.4f; out.rOuter1 = fWorldR * 2.4f; out.halfAng1 = glm::radians(12.0f);
+    out.rInner2 = fWorldR * 2.6f; out.rOuter2 = fWorldR * 3.6f; out.halfAng2 = glm::radians(8.0f);
+    out.innerCount = 8; out.outerCount = 16;
+    auto rot2 = [](const glm::vec2& v, float ang){ return glm::vec2(v.x*cosf(ang)-v.y*sinf(ang), v.x*sinf(ang)+v.y*cosf(ang)); };
+    // base triangles oriented along +X
+    auto makeTriLocal = [](float rIn, float rOut, float hAng){
+        glm::vec2 A(rIn, 0.0f), BL(rOut*cosf(hAng),  rOut*sinf(hAng)), BR(rOut*cosf(hAng), -rOut*sinf(hAng));
+        return Tri{A,BL,BR};
     };
+    Tri t1 = makeTriLocal(out.rInner1, out.rOuter1, out.halfAng1);
+    Tri t2 = makeTriLocal(out.rInner2, out.rOuter2, out.halfAng2);
+    for (int i=0;i<out.innerCount;i++) {
+        float ang = (6.2831853f * i) / out.innerCount;
+        out.wedgeTris.push_back({ rot2(t1.a,ang), rot2(t1.b,ang), rot2(t1.c,ang) });
+    }
+    for (int i=0;i<out.outerCount;i++) {
+        float ang = (6.2831853f * i) / out.outerCount + (3.14159f/out.outerCount);
+        out.wedgeTris.push_back({ rot2(t2.a,ang), rot2(t2.b,ang), rot2(t2.c,ang) });
+    }
 
-    for (auto &ti : treeInstances) {
-        glm::ivec2 s = worldToScreenOverlay(ti.pos.x, ti.pos.y);
-        // Size: 2x2 for small, 3x3 for medium, 4x4 for tall for better visibility
-        int marker = (ti.size==Small?2:(ti.size==Medium?3:4));
-        int x0 = s.x - marker/2;
-        int y0 = s.y - marker/2;
-        glColor3f(0.15f, 0.65f, 0.35f);
-        drawFilledPixel(x0, y0, marker);
+    // Place trees with Bridson Poisson-disk sampling over the allowed area (outside hedge disk
+    // and wedge footprints, off paths). The disk radius is the minimum spacing, so spacing
+    // holds by construction; sizes are assigned over a seeded shuffle so they stay mixed.
+    OccupancyGrid occ;
+    rasterizeOccupancy(occ, OccupancyInputs{ p.gridW, p.gridH, p.occupancySub, out.rOuter2 * p.hedgeScale, fWorldR,
+                                             out.wedgeTris, out.paths });
+    out.targetTotal = p.smallCount + p.mediumCount + p.tallCount;
+    auto worldToGrid = [&](float wx, float wz){
+        int gx = (int)glm::clamp(((wx + 10.0f) / 20.0f) * p.gridW + 0.5f, 0.0f, (float)p.gridW - 1.0f);
+        int gy = (int)glm::clamp(((wz + 10.0f) / 20.0f) * p.gridH + 0.5f, 0.0f, (float)p.gridH - 1.0f);
+        return glm::ivec2(gx, gy);
+    };
+    float minR = out.rOuter2 + 0.20f; // stay outside hedges outer disk with small gap
+    auto allowedAt = [&](const glm::vec2& v){
+        // Skip forbidden zones (outer disk and wedge triangles)
+        if (occ.atWorld(v.x, v.y) & OCC_FORBIDDEN) return false;
+        // Maintain minimum gap from hedges outer radius
+        if (glm::length(v) < minR) return false;
+        // Skip path cells
+        glm::ivec2 gc = worldToGrid(v.x, v.y);
+        return (occ.atCell(gc.x, gc.y) & OCC_PATH) == 0;
+    };
+    std::vector<glm::vec2> sites = poissonDiskSample(glm::vec2(-10.0f), glm::vec2(10.0f), p.treeMinSpacing, allowedAt, layoutRng);
+    std::shuffle(sites.begin(), sites.end(), layoutRng);
+    if ((int)sites.size() > out.targetTotal) sites.resize(out.targetTotal);
+    // Per-tree margins from the current outer hedge radius so future scaling preserves the gap
+    float currentOuter = out.rOuter2 * p.hedgeScale;
+    out.trees.reserve(sites.size());
+    for (auto &site : sites) {
+        // Size distribution
+        TreeSize assign = Medium;
+        if (out.placed[Small] < p.smallCount) assign = Small;
+        else if (out.placed[Medium] < p.mediumCount) assign = Medium;
+        else assign = Tall;
+        out.placed[assign]++;
+        float r = glm::length(site);
+        out.trees.add(site.x, site.y, (uint8_t)assign, std::max(0.0f, r - currentOuter), std::max(0.0f, r - p.fountainFoot));
     }
+}
 
-    endOrtho2D();
-    glEnable(GL_DEPTH_TEST);
+// Main thread: publish a generated layout and log it
+static void applyLayout(LayoutResult& r) {
+    // Glades removed: no generation
+    glades.clear();
+    layoutPaths = std::move(r.paths);
+    hedgeWedgeTris = std::move(r.wedgeTris);
+    wedgeRInner1 = r.rInner1; wedgeROuter1 = r.rOuter1; wedgeHalfAng1 = r.halfAng1;
+    wedgeRInner2 = r.rInner2; wedgeROuter2 = r.rOuter2; wedgeHalfAng2 = r.halfAng2;
+    hedgeInnerCount = r.innerCount; hedgeOuterCount = r.outerCount;
+    layoutRevision++; // paths and hedge footprints changed: occupancy is rebuilt on next query
+    treeStore = std::move(r.trees);
+    autoTreeCount = (int)treeStore.count(); // prevent legacy autoplace from adding more
+    treeRevision++;
+
+    // Console Output
+    // Glades removed (no glade generation in this design)
+    std::cout << "[*] Weaving mystic paths to the central fountain...\n";
+    int pi=1; for (auto &p: layoutPaths) {
+        std::cout << "    Path "<<pi++<<": ("<<p.a.x<<","<<p.a.y<<") -> ("<<p.b.x<<","<<p.b.y<<") - "<<(p.clear?"Unobstructed":"Touches glade")<<"\n";
+    }
+    std::cout << "[*] Seating ancient trees outside hedges...\n";
+    std::cout << "[*] Layout summary: Trees Placed="<<treeStore.count()<<" (S="<<r.placed[Small]<<" M="<<r.placed[Medium]<<" T="<<r.placed[Tall]<<") Paths="<<layoutPaths.size()<<" Hedges="<<hedgeWedgeTris.size()<<"\n\n";
+    if ((int)treeStore.count() < r.targetTotal) {
+        std::cout << "[Guard] Not all requested trees could be placed due to constraints; placed "<<treeStore.count()<<" of "<<r.targetTotal<<".\n";
+    }
+    layoutGenerated = true;
+}
+
+// ----------------- Scene snapshot -----------------
+// The live scene (trees as moved/planted so far) for F5
+static SceneSnapshot captureScene() {
+    SceneSnapshot s;
+    s.settings = SceneSettings{ layoutSeed, fireflySeed, fountainRadius, pathStyle, currentGroundTex,
+                                treeGlobalScale, treeYawDeg, fountainGlobalScale, fountainYawDeg, hedgeGlobalScale,
+                                wedgeRInner1, wedgeROuter1, wedgeHalfAng1, wedgeRInner2, wedgeROuter2, wedgeHalfAng2,
+                                hedgeInnerCount, hedgeOuterCount };
+    s.trees.reserve(treeStore.count());
+    for (size_t i = 0; i < treeStore.count(); ++i) {
+        s.trees.push_back(SnapshotTree{ treeStore.x[i], treeStore.z[i], (uint32_t)treeStore.size[i],
+                                        treeStore.outerMargin[i], treeStore.fountainGap[i] });
+    }
+    for (const LayoutPath& p : layoutPaths)
+        s.paths.push_back(SnapshotPath{ p.a.x, p.a.y, p.b.x, p.b.y, p.clear ? 1u : 0u });
+    for (const Tri& t : hedgeWedgeTris)
+        s.tris.push_back(SnapshotTri{ t.a.x, t.a.y, t.b.x, t.b.y, t.c.x, t.c.y });
+    return s;
+}
+
+static void saveScene(const char* binPath, const char* jsonPath) {
+    SceneSnapshot s = captureScene();
+    if (!writeSceneSnapshot(binPath, s)) { std::cout << "[Guard] Could not write " << binPath << "\n"; return; }
+    bool json = writeSceneSnapshotJson(jsonPath, s);
+    std::cout << "[Action] Scene snapshot (" << s.trees.size() << " trees, " << s.paths.size() << " paths, "
+              << s.tris.size() << " hedge triangles) -> " << binPath << (json ? std::string(" + ") + jsonPath : std::string()) << "\n";
+    if (!json) std::cout << "[Guard] Could not write " << jsonPath << "\n";
+}
+
+// Settings and layout from a snapshot, in place of the prompts and generateLayout; false leaves
+// everything untouched
+static bool loadScene(const std::string& path) {
+    MappedFile file;
+    SceneSnapshotView v;
+    if (!openSceneSnapshot(path, file, v)) return false;
+    const SceneSettings& s = v.settings;
+    layoutSeed = s.layoutSeed;
+    fireflySeed = s.fireflySeed;
+    fountainRadius = glm::clamp(s.fountainRadius, 20, 200);
+    pathStyle = glm::clamp(s.pathStyle, 0, 2);
+    currentGroundTex = glm::clamp(s.groundTexture, 0, 2);
+    treeGlobalScale = s.treeScale; treeYawDeg = s.treeYawDeg;
+    fountainGlobalScale = s.fountainScale; fountainYawDeg = s.fountainYawDeg;
+    hedgeGlobalScale = s.hedgeScale;
+
+    // Through applyLayout like a generated layout, so the same state is invalidated and logged
+    LayoutResult r;
+    r.rInner1 = s.wedgeInner1; r.rOuter1 = s.wedgeOuter1; r.halfAng1 = s.wedgeHalfAngle1;
+    r.rInner2 = s.wedgeInner2; r.rOuter2 = s.wedgeOuter2; r.halfAng2 = s.wedgeHalfAngle2;
+    r.innerCount = s.hedgeInnerCount; r.outerCount = s.hedgeOuterCount;
+    r.paths.reserve(v.pathCount);
+    for (uint32_t i = 0; i < v.pathCount; ++i) {
+        const SnapshotPath& p = v.paths[i];
+        r.paths.push_back(LayoutPath{ glm::ivec2(p.ax, p.ay), glm::ivec2(p.bx, p.by), p.clear != 0 });
+    }
+    r.wedgeTris.reserve(v.triCount);
+    for (uint32_t i = 0; i < v.triCount; ++i) {
+        const SnapshotTri& t = v.tris[i];
+        r.wedgeTris.push_back(Tri{ glm::vec2(t.ax, t.az), glm::vec2(t.bx, t.bz), glm::vec2(t.cx, t.cz) });
+    }
+    r.trees.reserve(v.treeCount);
+    for (uint32_t i = 0; i < v.treeCount; ++i) {
+        const SnapshotTree& t = v.trees[i];
+        TreeSize size = (TreeSize)std::min<uint32_t>(t.size, Tall);
+        r.trees.add(t.x, t.z, (uint8_t)size, t.outerMargin, t.fountainGap);
+        r.placed[size]++;
+    }
+    r.targetTotal = (int)v.treeCount;
+    applyLayout(r);
+    return true;
 }
 
 // ----------------- Main -----------------
-int main() {
+int main(int argc, char** argv) {
+    BenchRun bench;
+    if (!parseBenchArgs(argc, argv, bench.cfg)) return 1;
+    if (!bench.cfg.enabled && argc > (bench.cfg.scenePath.empty() ? 1 : 3))
+        std::cout << "[Guard] Options other than --scene ignored without --bench\n";
+    if (bench.cfg.enabled) parseVertexFormat(bench.cfg.vertexFormat, meshVertexFormat);
     // --- Enchanted Forest Layout Generation Console ---
     {
     // Console bootstrap collects user preferences for counts/styles and logs the resulting layout.
@@ -1158,191 +2631,91 @@ int main() {
             std::cout << prompt << " (" << minV << "-" << maxV << ") [" << var << "]: ";
             if (std::getline(std::cin, line)) if(!line.empty()) { try { int v=std::stoi(line); if(v>=minV&&v<=maxV) var=v; } catch(...) {} }
         };
-        readRange("Trees Small", smallCount, 0, 50);
-        readRange("Trees Medium", mediumCount, 0, 50);
-        readRange("Trees Tall", tallCount, 0, 50);
-        // Glades removed: no input prompt
-        readRange("Mystic Paths", pathCount, 1, 12);
-        readRange("Fountain radius px", fountainRadius, 20, 200);
-        readRange("Ground texture (0=grass,1=moss,2=purple)", currentGroundTex, 0, 2);
-        readRange("Path style (0=straight,1=polyline,2=branching)", pathStyle, 0, 2);
-
-        // Glades removed: no generation
-        glades.clear();
-
-        // Bresenham helper (integer grid): returns inclusive list of grid cells from A to B
-        auto bresenham = [&](glm::ivec2 a, glm::ivec2 b){
-            std::vector<glm::ivec2> pts; int x0=a.x, y0=a.y, x1=b.x, y1=b.y; int dx=abs(x1-x0), dy=abs(y1-y0);
-            int sx = x0<x1?1:-1; int sy = y0<y1?1:-1; int err = dx-dy;
-            while(true){ pts.push_back({x0,y0}); if(x0==x1 && y0==y1) break; int e2=2*err; if(e2> -dy){ err -= dy; x0 += sx; } if(e2 < dx){ err += dx; y0 += sy; } }
-            return pts;
-        };
-
-        // Hub-style paths: connect random allowed forest cells back to the central fountain cell
-        // Fountain is at design grid center
-        layoutPaths.clear();
-        glm::ivec2 fountainCell(designGridW/2, designGridH/2);
-        std::vector<glm::ivec2> allPathCells; // to avoid tree placement on paths
-        // Compute wedge outer radius in GRID units using same factors as hedges (ROuter2 = 3.6 * fWorldR)
-        int frGrid_paths = std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
-        float wedgeOuterGrid = frGrid_paths * 3.6f;
-        auto outsideWedgeCircle = [&](const glm::ivec2& cell){
-            int dx = cell.x - fountainCell.x; int dy = cell.y - fountainCell.y;
-            return (dx*dx + dy*dy) > (int)std::ceil(wedgeOuterGrid*wedgeOuterGrid);
-        };
-        auto sampleStartOutside = [&](){
-            // Try random sampling first
-            for (int t=0;t<4000;t++) {
-                glm::ivec2 cand(rand()%designGridW, rand()%designGridH);
-                if (outsideWedgeCircle(cand)) return cand;
-            }
-            // Fallback: pick a random angle and place on boundary near the edge of grid
-            float ang = ((rand()%1000)/1000.0f) * 6.2831853f;
-            float r = std::max({fountainCell.x, designGridW-1 - fountainCell.x, fountainCell.y, designGridH-1 - fountainCell.y}) - 1.0f;
-            glm::ivec2 cand(
-                fountainCell.x + (int)std::round(r * cosf(ang)),
-                fountainCell.y + (int)std::round(r * sinf(ang))
-            );
-            cand.x = std::max(0, std::min(designGridW-1, cand.x));
-            cand.y = std::max(0, std::min(designGridH-1, cand.y));
-            return cand;
-        };
-        for (int i=0;i<pathCount;i++) {
-            glm::ivec2 a = sampleStartOutside();
-            glm::ivec2 b = fountainCell; // all paths terminate at fountain
-            auto pts = bresenham(a,b);
-            layoutPaths.push_back({a,b,true});
-            // record path cells for tree exclusion
-            allPathCells.insert(allPathCells.end(), pts.begin(), pts.end());
-        }
-
-        // Hedge wedges: compute world-space triangle footprints before tree placement
-        hedgeWedgeTris.clear();
-        {
-            int frGrid = std::max(2, (int)(fountainRadius / (std::min(SCR_WIDTH,SCR_HEIGHT)/(float)std::max(designGridW,designGridH))));
-            float cellWorld = 20.0f / (float)designGridW;
-            float fWorldR = frGrid * cellWorld;
-            // Reduced radii for a tighter star pattern
-            wedgeRInner1 = fWorldR * 1.4f; wedgeROuter1 = fWorldR * 2.4f; wedgeHalfAng1 = glm::radians(12.0f);
-            wedgeRInner2 = fWorldR * 2.6f; wedgeROuter2 = fWorldR * 3.6f; wedgeHalfAng2 = glm::radians(8.0f);
-            hedgeInnerCount = 8; hedgeOuterCount = 16;
-            auto rot2 = [](const glm::vec2& p, float ang){ return glm::vec2(p.x*cosf(ang)-p.y*sinf(ang), p.x*sinf(ang)+p.y*cosf(ang)); };
-            // base triangles oriented along +X
-            auto makeTriLocal = [](float rIn, float rOut, float hAng){
-                glm::vec2 A(rIn, 0.0f), BL(rOut*cosf(hAng),  rOut*sinf(hAng)), BR(rOut*cosf(hAng), -rOut*sinf(hAng));
-                return Tri{A,BL,BR};
-            };
-            Tri t1 = makeTriLocal(wedgeRInner1, wedgeROuter1, wedgeHalfAng1);
-            Tri t2 = makeTriLocal(wedgeRInner2, wedgeROuter2, wedgeHalfAng2);
-            for (int i=0;i<hedgeInnerCount;i++) {
-                float ang = (6.2831853f * i) / hedgeInnerCount;
-                hedgeWedgeTris.push_back({ rot2(t1.a,ang), rot2(t1.b,ang), rot2(t1.c,ang) });
-            }
-            for (int i=0;i<hedgeOuterCount;i++) {
-                float ang = (6.2831853f * i) / hedgeOuterCount + (3.14159f/hedgeOuterCount);
-                hedgeWedgeTris.push_back({ rot2(t2.a,ang), rot2(t2.b,ang), rot2(t2.c,ang) });
-            }
+        // A saved scene replaces both the prompts and the layout generation
+        bool sceneLoaded = false;
+        if (!bench.cfg.scenePath.empty()) {
+            sceneLoaded = loadScene(bench.cfg.scenePath);
+            if (sceneLoaded) std::cout << "[Info] Scene loaded from " << bench.cfg.scenePath << " (seed " << layoutSeed << ")\n";
+            else std::cout << "[Guard] Could not load scene " << bench.cfg.scenePath << "; generating one instead\n";
         }
-
-        // Place trees uniformly around the allowed area (outside hedge disk and wedge footprints),
-        // avoid paths, and enforce minimum spacing for even distribution. Adapt spacing if needed.
-        treeInstances.clear();
-        int targetTotal = smallCount + mediumCount + tallCount;
-        // Fast lookup for path cells
-        struct CellHash { size_t operator()(const glm::ivec2& c) const noexcept { return (size_t)((c.x & 0xFFFF) << 16) ^ (size_t)(c.y & 0xFFFF); } };
-        struct CellEq { bool operator()(const glm::ivec2& a, const glm::ivec2& b) const noexcept { return a.x==b.x && a.y==b.y; } };
-        std::unordered_set<glm::ivec2, CellHash, CellEq> pathCells;
-        for (auto &pc : allPathCells) pathCells.insert(pc);
-        auto worldToGrid = [&](float wx, float wz){
-            int gx = (int)glm::clamp(((wx + 10.0f) / 20.0f) * designGridW + 0.5f, 0.0f, (float)designGridW - 1.0f);
-            int gy = (int)glm::clamp(((wz + 10.0f) / 20.0f) * designGridH + 0.5f, 0.0f, (float)designGridH - 1.0f);
-            return glm::ivec2(gx, gy);
-        };
-        auto forbiddenWorld = [&](float wx, float wz){ return isForbiddenAtWorld(wx, wz); };
-        float minR = wedgeROuter2 + 0.20f; // stay outside hedges outer disk with small gap
-        float minSpacingStart = 1.8f;      // keep spacing constant; +1 over previous
-        float minSpacing = minSpacingStart;
-        int sPlaced=0, mPlaced=0, tPlaced=0;
-        for (int pass=0; pass<8 && (int)treeInstances.size() < targetTotal; ++pass) {
-            int attempts = 0, maxAttempts = targetTotal * 600;
-            while ((int)treeInstances.size() < targetTotal && attempts < maxAttempts) {
-                attempts++;
-                // Sample uniformly over world bounds; reject forbidden areas for truly scattered placement
-                float wx = -10.0f + ((rand()%10000)/10000.0f) * 20.0f;
-                float wz = -10.0f + ((rand()%10000)/10000.0f) * 20.0f;
-                // Bounds clamp (world is [-10,10])
-                if (wx < -10.0f || wx > 10.0f || wz < -10.0f || wz > 10.0f) continue;
-                // Skip forbidden zones (outer disk and wedge triangles)
-                if (forbiddenWorld(wx, wz)) continue;
-                // Maintain minimum gap from hedges outer radius
-                float r = sqrtf(wx*wx + wz*wz);
-                if (r < minR) continue;
-                // Skip path cells
-                glm::ivec2 gc = worldToGrid(wx, wz);
-                if (pathCells.find(gc) != pathCells.end()) continue;
-                // Enforce minimum spacing from existing trees
-                bool tooClose = false;
-                for (auto &ti : treeInstances) {
-                    float dx = ti.pos.x - wx, dz = ti.pos.y - wz;
-                    if ((dx*dx + dz*dz) < (minSpacing * minSpacing)) { tooClose = true; break; }
-                }
-                if (tooClose) continue;
-                // Size distribution
-                TreeSize assign = Medium;
-                if (sPlaced < smallCount) assign = Small;
-                else if (mPlaced < mediumCount) assign = Medium;
-                else assign = Tall;
-                if (assign == Small) sPlaced++; else if (assign == Medium) mPlaced++; else tPlaced++;
-                treeInstances.push_back(TreeInst{glm::vec2(wx, wz), assign});
-            }
-            // Keep spacing constant across passes (no relaxation)
-            (void)pass; // spacing remains fixed
+        if (sceneLoaded) {
+            // Settings came with the layout
+        } else if (bench.cfg.enabled) {
+            // Fixed scene from the command line / config file; rand() drives the fireflies
+            smallCount = bench.cfg.smallTrees; mediumCount = bench.cfg.mediumTrees; tallCount = bench.cfg.tallTrees;
+            pathCount = bench.cfg.paths;
+            fountainRadius = bench.cfg.fountainRadius;
+            layoutSeed = bench.cfg.seed;
+            fireflySeed = (unsigned int)bench.cfg.seed;
+            std::cout << "[Info] Bench scene: trees " << smallCount << "/" << mediumCount << "/" << tallCount << ", paths " << pathCount
+                      << ", fountain radius " << fountainRadius << " px, fireflies " << bench.cfg.fireflies << ", seed " << layoutSeed << "\n";
+        } else {
+            readRange("Trees Small", smallCount, 0, 50);
+            readRange("Trees Medium", mediumCount, 0, 50);
+            readRange("Trees Tall", tallCount, 0, 50);
+            // Glades removed: no input prompt
+            readRange("Mystic Paths", pathCount, 1, 12);
+            readRange("Fountain radius px", fountainRadius, 20, 200);
+            readRange("Ground texture (0=grass,1=moss,2=purple)", currentGroundTex, 0, 2);
+            readRange("Path style (0=straight,1=polyline,2=branching)", pathStyle, 0, 2);
+            readRange("Layout seed", layoutSeed, 0, 999999);
         }
-        autoTreeCount = (int)treeInstances.size(); // prevent legacy autoplace from adding more
-        // Initialize per-tree margin from current outer hedge radius so future scaling preserves gap
-        treeOuterMargin.clear();
-        treeFountainGap.clear();
-        float currentOuter = wedgeROuter2 * hedgeGlobalScale;
-        float currentFountainFoot = fountainScale * fountainGlobalScale * 1.1f;
-        treeOuterMargin.reserve(treeInstances.size());
-        treeFountainGap.reserve(treeInstances.size());
-        for (auto &ti : treeInstances) {
-            float r = glm::length(glm::vec2(ti.pos.x, ti.pos.y));
-            treeOuterMargin.push_back(std::max(0.0f, r - currentOuter));
-            treeFountainGap.push_back(std::max(0.0f, r - currentFountainFoot));
+        srand(fireflySeed);
+
+        // Generated on a worker while the window, GL context and shaders come up (applyLayout)
+        if (!sceneLoaded) {
+            LayoutParams layoutParams{ smallCount, mediumCount, tallCount, pathCount, fountainRadius, layoutSeed,
+                                       designGridW, designGridH, occupancySubdivisions, hedgeGlobalScale, treeMinSpacing,
+                                       fountainScale * fountainGlobalScale * 1.1f };
+            auto layout = std::make_shared<LayoutResult>();
+            submitJob([layoutParams, layout]{ generateLayout(layoutParams, *layout); },
+                      [layout]{ applyLayout(*layout); });
         }
 
-        // Console Output
-        // Glades removed (no glade generation in this design)
-        std::cout << "[*] Weaving mystic paths to the central fountain...\n";
-        int pi=1; for (auto &p: layoutPaths) {
-            std::cout << "    Path "<<pi++<<": ("<<p.a.x<<","<<p.a.y<<") -> ("<<p.b.x<<","<<p.b.y<<") - "<<(p.clear?"Unobstructed":"Touches glade")<<"\n";
-        }
-        std::cout << "[*] Seating ancient trees outside hedges...\n";
-        std::cout << "[*] Layout summary: Trees Placed="<<treeInstances.size()<<" (S="<<sPlaced<<" M="<<mPlaced<<" T="<<tPlaced<<") Paths="<<layoutPaths.size()<<" Hedges="<<hedgeWedgeTris.size()<<"\n\n";
-        if ((int)treeInstances.size() < targetTotal) {
-            std::cout << "[Guard] Not all requested trees could be placed due to constraints; placed "<<treeInstances.size()<<" of "<<targetTotal<<".\n";
-        }
         std::cout << "=== CONTROLS ===\n";
         std::cout << "V           : Toggle 2D / 3D realms\n";
         std::cout << "W/A/S/D     : Wander (3D)\n";
         std::cout << "P           : Cycle path style (visual only)\n";
         std::cout << "[/]         : Fountain radius pixel ring\n";
         std::cout << "T/M         : Cycle ground texture\n";
+        std::cout << "N           : Toggle instanced tree rendering\n";
+        std::cout << "B           : Toggle static scene batching\n";
+        std::cout << "C           : Toggle culling (logs visible/culled counts)\n";
+        std::cout << "X / Z       : Toggle front-to-back sorting / depth pre-pass\n";
+        std::cout << "G           : Toggle the streamed chunked world\n";
+        std::cout << "H           : Toggle level of detail (simpler meshes, tree impostors)\n";
+        std::cout << "Y           : Toggle shadows\n";
+        std::cout << "F1 / F2     : Profiler bar / dump profile.csv\n";
+        std::cout << "F3          : Log asset VRAM usage\n";
+        std::cout << "F4          : Cycle frame pacing (vsync/adaptive/uncapped/capped)\n";
+        std::cout << "F5          : Save scene to scene.efs (+ scene.json)\n";
         std::cout << "I/O,K/L,J,U : Scale / rotate models (3D)\n";
         std::cout << "Mouse L     : Plant extra tree (both views)\n";
         std::cout << "ESC         : Exit\n";
         std::cout << "\nBootstrapping complete. Summoning window...\n";
-        layoutGenerated = true;
     }
     // GLFW / GLEW Init
     if (!glfwInit()) return -1;
+    if (bench.cfg.offscreen) glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
     GLFWwindow* win = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "Enchanted Forest", NULL, NULL);
     if (!win) return -1;
     glfwMakeContextCurrent(win);
     glfwSetInputMode(win, GLFW_STICKY_KEYS, GLFW_TRUE);
     glfwSetMouseButtonCallback(win, mouseCallback);
     glewInit();
+    profilerInit();
+    if (bench.cfg.enabled) {
+        // Bench frames each run one tick, so the scene is the same at any frame rate or pacing
+        frameClock.lockstep = true;
+        framePacing = benchPacing(bench.cfg);
+        if (bench.cfg.fpsCap > 0) frameLimiter.fps = bench.cfg.fpsCap;
+    }
+    framePacing = applyFramePacing(framePacing);
+    bench.pacing = framePacing;
+    if (bench.cfg.enabled) {
+        if (bench.cfg.offscreen && !createOffscreenTarget(SCR_WIDTH, SCR_HEIGHT))
+            std::cout << "[Guard] Offscreen framebuffer incomplete; rendering to the hidden window\n";
+    }
 
         // Show view name in window title
         {
@@ -1350,15 +2723,53 @@ int main() {
             glfwSetWindowTitle(win, title.c_str());
         }
 
-    glEnable(GL_DEPTH_TEST);
+    setDepthTest(true);
 
     // Load shaders & models
     // NOTE: vertex shader is stored as 'forest.vert'.
-    shaderProgram = compileShaderFromFile("forest.vert", "fragment_shader.glsl");
-    glUseProgram(shaderProgram);
+    initUniformBlocks();
+    shaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl");
+    rigidShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"UNIFORM_SCALE"});
+    treeShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED"});
+    leafShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"ALPHA_TEST"});
+    treeLeafShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "ALPHA_TEST"});
+    ringShaderProgram = createShaderProgram("ring.vert", "fragment_shader.glsl");
+    fireflyShaderProgram = createShaderProgram("firefly.vert", "firefly.frag");
+    impostorShaderProgram = createShaderProgram("impostor.vert", "fragment_shader.glsl",
+                                                {"IMPOSTOR", "ALPHA_TEST", "LOD_FADE",
+                                                 "IMPOSTOR_FRAMES_X " + std::to_string(treeImpostor.framesX),
+                                                 "IMPOSTOR_FRAMES_Y " + std::to_string(treeImpostor.framesY)});
+    treeFadeShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "LOD_FADE"});
+    treeLeafFadeShaderProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "ALPHA_TEST", "LOD_FADE"});
+    // scene_batch.vert is #version 430: only compiled where the multi-draw path can run
+    if (multiDrawIndirectSupported()) batchShaderProgram = createShaderProgram("scene_batch.vert", "fragment_shader.glsl");
+    // Depth-only caster permutations for the shadow pass
+    shadowMeshProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"SHADOW_CASTER"});
+    shadowRigidProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"UNIFORM_SCALE", "SHADOW_CASTER"});
+    shadowTreeProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "SHADOW_CASTER"});
+    shadowLeafProgram = createShaderProgram("forest.vert", "fragment_shader.glsl", {"INSTANCED", "ALPHA_TEST", "SHADOW_CASTER"});
+    if (multiDrawIndirectSupported()) shadowBatchProgram = createShaderProgram("scene_batch.vert", "fragment_shader.glsl", {"SHADOW_CASTER"});
+    for (ShaderProgram* p : { &shaderProgram, &rigidShaderProgram, &treeShaderProgram, &leafShaderProgram, &treeLeafShaderProgram,
+                              &ringShaderProgram, &batchShaderProgram, &impostorShaderProgram, &treeFadeShaderProgram,
+                              &treeLeafFadeShaderProgram, &shadowMeshProgram, &shadowRigidProgram, &shadowBatchProgram,
+                              &shadowTreeProgram, &shadowLeafProgram })
+        setSceneSamplers(*p);
+    if (impostorShaderProgram.id) {
+        impostorShaderProgram.use();
+        impostorShaderProgram.setInt(UNIFORM_IMPOSTOR_NORMALS, kImpostorNormalUnit);
+    }
+    registerSceneMaterials();
+    staticBatch.init(batchShaderProgram.id);
+    staticBatching = !bench.cfg.noBatch;
+    renderQueue.frontToBack = !bench.cfg.unsorted;
+    renderQueue.depthPrepass = bench.cfg.depthPrepass;
+    shadowMaps.throttle = !bench.cfg.shadowEveryFrame;
+    shadowsEnabled = !bench.cfg.noShadows && shadowMaps.init(bench.cfg.shadowSize);
+    std::cout << "[Info] Vertex format: " << meshVertexFormat.name() << " (" << meshVertexFormat.stride() << " bytes/vertex)\n";
+    shaderProgram.use();
 
     // Fountain: load OBJ model and set scale to 0.5 of original size; texture mapped via fountain.png
-    fountainModel = loadModel("Models/fountain.obj", "Models/fountain.png");
+    fountainModel = acquireModel("Models/fountain.obj", "Models/fountain.png");
     useProceduralFountain = fountainModel.meshes.empty();
     // Set position; we will align Y so base sits at ground
     fountainModel.position = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -1389,34 +2800,58 @@ int main() {
     }
     // Procedural ground plane + textures
     createGroundPlane();
-    extern GLuint loadTexture(const char* path);
-    groundTextures[0] = loadTexture("Models/grass.png");
-    groundTextures[1] = loadTexture("Models/moss.png");
-    groundTextures[2] = loadTexture("Models/purple.png");
-    pathTexture = loadTexture("Models/path.png");
+    // Ground, path and tree textures: one array, sampled by layer
+    sceneTextures = acquireTextureArray(std::vector<std::string>(kSceneLayerPaths, kSceneLayerPaths + LAYER_COUNT), kSceneLayerSize);
     // 2D sprite textures for non-OBJ 2D view
     treeSpriteTex = 0; // no 2D sprite needed for trees
-    fountainSpriteTex = loadTexture("Models/fountain.png");
-    // Procedural tree textures
-    trunkTexture = loadTexture("Models/trunk.png");
-    leavesTexture = loadTexture("Models/leaves.png");
+    fountainSpriteTex = acquireTexture("Models/fountain.png"); // shared with the fountain model
+
+    // Paths, hedge footprints and trees are needed from here on
+    finishJobs();
 
     // Fixed path width (for stylized path mesh); accurate path mesh uses 1× tile per grid step
     pathHalfWidth = 0.3f;
     updatePathMesh(pathStyle);
     updateAccuratePathMesh();
     updateFountainRing(fountainScale);
+    finishJobs(); // the first frame already has the ribbon and ring
 
-
-    initFireflies(30);
+    initFireflies(bench.cfg.enabled ? bench.cfg.fireflies : 30);
     createCylinder(0.08f, 24);
     createCone(0.20f, 24);
+    createTreeInstanceBuffer();
+    createImpostorQuad();
     buildHedgeMeshes();
+    chunkedWorld.cellWorld = 20.0f / (float)designGridW;
+    chunkedWorld.seed = (uint32_t)layoutSeed;
+    chunkedWorld.memoryBudget = (size_t)bench.cfg.chunkBudgetKB * 1024;
+    chunkedWorld.init(ChunkTreeMeshes{ trunkVBO, trunkEBO, coneVBO, coneEBO }, chunkGroundRepeat());
+    worldChunksEnabled = bench.cfg.worldChunks;
+    lodEnabled = !bench.cfg.noLod;
 
     glm::mat4 projection = glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
 
-    float time = 0.0f;
+    // Bench runs start with every texture resident so they never time streaming
+    if (bench.cfg.enabled) {
+        finishTextureUploads();
+        logAssetUsage();
+    }
+
+    float time = 0.0f, prevTime = 0.0f; // firefly clock after the last tick and one tick earlier
     while (!glfwWindowShouldClose(win)) {
+        auto frameStart = std::chrono::steady_clock::now();
+        profilerBeginFrame();
+        // PNGs decoded on the loader threads since last frame replace their placeholders
+        pumpTextureUploads();
+        // Tree impostors are captured from the real tree textures, so not before they are resident
+        if (treeImpostorPending && pendingTextureUploads() == 0) {
+            bakeTreeImpostors();
+            treeImpostorPending = false;
+        }
+        // Meshes rebuilt on the job workers since last frame replace the ones drawn so far
+        pumpJobs();
+        // The uploads and the capture bind textures, programs and depth state behind the cache's back
+        resetStateCache();
         // Distinct background colors for views
         if (currentView == VIEW_3D) {
             glClearColor(0.1f, 0.15f, 0.2f, 1.0f); // night forest tone
@@ -1425,30 +2860,71 @@ int main() {
         }
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Camera movement (3D only)
-        float speed = 0.1f;
-        if (currentView == VIEW_3D) {
-            if (glfwGetKey(win, GLFW_KEY_W)) cameraPos += speed * cameraFront;
-            if (glfwGetKey(win, GLFW_KEY_S)) cameraPos -= speed * cameraFront;
-            if (glfwGetKey(win, GLFW_KEY_A)) cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * speed;
-            if (glfwGetKey(win, GLFW_KEY_D)) cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * speed;
+        // Fixed-rate simulation: held keys, the firefly clock and the flash fade advance in kSimStep
+        // ticks, as many as the wall time since the last frame covers (amounts are per tick)
+        int ticks = frameClock.advance(glfwGetTime());
+        for (int tick = 0; tick < ticks; ++tick) {
+            prevSimCamera = simCamera;
+            prevTime = time;
+            if (currentView == VIEW_3D) {
+                // Camera movement along the current heading
+                float speed = 0.1f;
+                glm::vec3 front = cameraFrontFrom(simCamera.yawDeg, simCamera.pitchDeg);
+                glm::vec3 right = glm::normalize(glm::cross(front, cameraUp));
+                if (glfwGetKey(win, GLFW_KEY_W)) simCamera.position += speed * front;
+                if (glfwGetKey(win, GLFW_KEY_S)) simCamera.position -= speed * front;
+                if (glfwGetKey(win, GLFW_KEY_A)) simCamera.position -= right * speed;
+                if (glfwGetKey(win, GLFW_KEY_D)) simCamera.position += right * speed;
+
+                // Camera rotation (yaw/pitch); reduced rotation speed for finer per-key control
+                float rotSpeed = 0.3f;
+                if (glfwGetKey(win, GLFW_KEY_LEFT)) simCamera.yawDeg -= rotSpeed;
+                if (glfwGetKey(win, GLFW_KEY_RIGHT)) simCamera.yawDeg += rotSpeed;
+                if (glfwGetKey(win, GLFW_KEY_UP)) simCamera.pitchDeg += rotSpeed;
+                if (glfwGetKey(win, GLFW_KEY_DOWN)) simCamera.pitchDeg -= rotSpeed;
+                simCamera.pitchDeg = glm::clamp(simCamera.pitchDeg, -89.0f, 89.0f);
+
+                // Model controls. Trees: scale with I/O, yaw left with J
+                if (glfwGetKey(win, GLFW_KEY_I)) { treeGlobalScale = std::min(3.0f, treeGlobalScale + 0.01f); std::cout << "[Action] Trees scale + -> " << treeGlobalScale << "\n"; }
+                if (glfwGetKey(win, GLFW_KEY_O)) { treeGlobalScale = std::max(0.2f, treeGlobalScale - 0.01f); std::cout << "[Action] Trees scale - -> " << treeGlobalScale << "\n"; }
+                if (glfwGetKey(win, GLFW_KEY_J)) { treeYawDeg -= 0.8f; std::cout << "[Action] Trees yaw left -> " << treeYawDeg << " deg\n"; }
+
+                // Fountain: scale with K/L, yaw right with U
+                if (glfwGetKey(win, GLFW_KEY_K)) {
+                    fountainGlobalScale = std::min(3.0f, fountainGlobalScale + 0.01f);
+                    hedgeGlobalScale = fountainGlobalScale * 0.8f;
+                    // Hedges follow through their model matrix; the ring radius is a uniform
+                    markMeshesDirty(MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
+                    // Preserve per-tree fountain gap: r_new = fountainFootprintNew + gap_i
+                    keepTreeGaps();
+                    std::cout << "[Action] Fountain scale + -> " << fountainGlobalScale << " (paths/ring/hedges updated)\n";
+                }
+                if (glfwGetKey(win, GLFW_KEY_L)) {
+                    fountainGlobalScale = std::max(0.2f, fountainGlobalScale - 0.01f);
+                    hedgeGlobalScale = fountainGlobalScale * 0.8f;
+                    markMeshesDirty(MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
+                    // Preserve per-tree fountain gap: r_new = fountainFootprintNew + gap_i
+                    keepTreeGaps();
+                    std::cout << "[Action] Fountain scale - -> " << fountainGlobalScale << " (paths/ring/hedges updated)\n";
+                }
+                if (glfwGetKey(win, GLFW_KEY_U)) { fountainYawDeg += 0.8f; std::cout << "[Action] Fountain yaw right -> " << fountainYawDeg << " deg\n"; }
+            }
+            time += 0.01f;
+            if (debugFlash > 0.0f) debugFlash -= 0.016f;
         }
-
-        // Camera rotation (yaw/pitch) when in 3D
-        if (currentView == VIEW_3D) {
-            // Reduced rotation speed for finer per-key control
-            float rotSpeed = 0.3f;
-            if (glfwGetKey(win, GLFW_KEY_LEFT)) yawDeg -= rotSpeed;
-            if (glfwGetKey(win, GLFW_KEY_RIGHT)) yawDeg += rotSpeed;
-            if (glfwGetKey(win, GLFW_KEY_UP)) pitchDeg += rotSpeed;
-            if (glfwGetKey(win, GLFW_KEY_DOWN)) pitchDeg -= rotSpeed;
-            if (pitchDeg > 89.0f) pitchDeg = 89.0f; if (pitchDeg < -89.0f) pitchDeg = -89.0f;
-            float yawRad = glm::radians(yawDeg); float pitchRad = glm::radians(pitchDeg);
-            cameraFront = glm::normalize(glm::vec3(
-                cos(yawRad) * cos(pitchRad),
-                sin(pitchRad),
-                sin(yawRad) * cos(pitchRad)
-            ));
+        // Render between the last two ticks
+        {
+            float alpha = frameClock.alpha();
+            cameraPos = glm::mix(prevSimCamera.position, simCamera.position, alpha);
+            cameraFront = cameraFrontFrom(glm::mix(prevSimCamera.yawDeg, simCamera.yawDeg, alpha),
+                                          glm::mix(prevSimCamera.pitchDeg, simCamera.pitchDeg, alpha));
+        }
+        float renderTime = glm::mix(prevTime, time, frameClock.alpha());
+        // Bench: the camera follows the scripted spline regardless of input
+        if (bench.cfg.enabled) {
+            CameraPose pose = benchCameraAt(bench.splineParam());
+            cameraPos = pose.position;
+            cameraFront = pose.front;
         }
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
 
@@ -1458,16 +2934,10 @@ int main() {
             if (currentView == VIEW_3D) showBlueprint = false; else showBlueprint = true;
             std::cout << "[Action] View toggled: " << (currentView==VIEW_3D?"3D":"2D") << "\n";
             if (currentView == VIEW_3D) {
-                // Keep current fountainScale (fixed to match OBJ scale request)
-                updateFountainRing(fountainScale);
-                updatePathMesh(pathStyle);
-                updateAccuratePathMesh();
-                // Rebuild hedge meshes with existing radii; do not override radii on toggle
-                wedgeVAO1 = wedgeVBO1 = wedgeEBO1 = 0; wedgeIdx1 = 0;
-                wedgeVAO2 = wedgeVBO2 = wedgeEBO2 = 0; wedgeIdx2 = 0;
-                // Rebuild hedge meshes with new radii
-                buildHedgeMeshes();
-                std::cout << "[Action] Hedge meshes rebuilt for 3D view\n";
+                // Keep current fountainScale (fixed to match OBJ scale request); hedges keep their
+                // existing radii on toggle, so their rebuild is skipped unless parameters changed
+                markMeshesDirty(MESH_DIRTY_RING_TOPOLOGY | MESH_DIRTY_PATH_STYLE | MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_HEDGES);
+                std::cout << "[Action] Path/ring/hedge meshes refreshed for 3D view\n";
             }
             // Update title with current view
             {
@@ -1478,200 +2948,142 @@ int main() {
         // Cycle path style (visual only for stylized demo path mesh)
         if (isKeyPressedOnce(win, GLFW_KEY_P)) {
             pathStyle = (pathStyle + 1) % 3;
-            updatePathMesh(pathStyle);
+            markMeshesDirty(MESH_DIRTY_PATH_STYLE);
             debugFlashPing(glm::vec3(0.6f, 0.8f, 1.0f));
             std::cout << "[Action] Path style cycled to " << pathStyle << " (visual-only mesh)\n";
         }
         // Cycle ground texture forward/backward
         if (isKeyPressedOnce(win, GLFW_KEY_T)) { currentGroundTex = (currentGroundTex + 1) % 3; std::cout << "[Action] Ground texture -> index " << currentGroundTex << "\n"; }
         if (isKeyPressedOnce(win, GLFW_KEY_M)) { currentGroundTex = (currentGroundTex + 2) % 3; std::cout << "[Action] Ground texture <- index " << currentGroundTex << "\n"; }
+        // Toggle instanced tree rendering (2 draws total) vs the per-tree path (2 draws per tree)
+        if (isKeyPressedOnce(win, GLFW_KEY_N)) {
+            instancedTrees = !instancedTrees;
+            std::cout << "[Action] Tree rendering -> " << (instancedTrees ? "instanced" : "per-tree") << "\n";
+        }
+        // Profiler: F1 toggles the on-screen bar, F2 writes the retained history to CSV
+        if (isKeyPressedOnce(win, GLFW_KEY_F1)) {
+            showProfiler = !showProfiler;
+            std::cout << "[Action] Profiler bar -> " << (showProfiler ? "on" : "off") << "\n";
+            if (showProfiler) logProfilerFrame();
+        }
+        if (isKeyPressedOnce(win, GLFW_KEY_F2)) {
+            if (profilerDumpCSV("profile.csv"))
+                std::cout << "[Action] Profiler history (" << profilerHistorySize() << " frames) -> profile.csv\n";
+            else
+                std::cout << "[Guard] Could not write profile.csv\n";
+        }
+        // Static scene batch on/off (per-object draws when off), e.g. to compare in the profiler
+        if (isKeyPressedOnce(win, GLFW_KEY_B)) {
+            staticBatching = !staticBatching;
+            std::cout << "[Action] Static scene batch -> " << (staticBatching ? (staticBatch.multiDraw ? "multi-draw indirect" : "arena loop") : "off (per-object draws)") << "\n";
+        }
+        // Render queue: front-to-back sorting and the depth pre-pass, e.g. to compare in the profiler
+        if (isKeyPressedOnce(win, GLFW_KEY_X)) {
+            renderQueue.frontToBack = !renderQueue.frontToBack;
+            std::cout << "[Action] Opaque draw order -> " << (renderQueue.frontToBack ? "front-to-back" : "submission order") << "\n";
+        }
+        if (isKeyPressedOnce(win, GLFW_KEY_Z)) {
+            renderQueue.depthPrepass = !renderQueue.depthPrepass;
+            std::cout << "[Action] Depth pre-pass -> " << (renderQueue.depthPrepass ? "on" : "off") << "\n";
+        }
+        // Level of detail on/off, e.g. to compare triangle cost in the profiler
+        if (isKeyPressedOnce(win, GLFW_KEY_H)) {
+            lodEnabled = !lodEnabled;
+            std::cout << "[Action] Level of detail -> " << (lodEnabled ? "on" : "off (full detail)") << "\n";
+        }
+        // Cascaded shadow maps on/off, e.g. to see their cost in the profiler
+        if (isKeyPressedOnce(win, GLFW_KEY_Y)) {
+            if (!shadowMaps.ready()) {
+                std::cout << "[Guard] Shadow maps unavailable\n";
+            } else {
+                shadowsEnabled = !shadowsEnabled;
+                shadowMaps.invalidate(); // layers went stale while off
+                std::cout << "[Action] Shadows -> " << (shadowsEnabled ? "on" : "off") << "\n";
+            }
+        }
+        // Procedural chunked forest around the design square, streamed as the camera moves
+        if (isKeyPressedOnce(win, GLFW_KEY_G)) {
+            worldChunksEnabled = !worldChunksEnabled;
+            std::cout << "[Action] Chunked world -> " << (worldChunksEnabled ? "on" : "off") << "\n";
+            chunkedWorld.logStats();
+        }
+        // Loaded textures/models with ref counts and VRAM read back from GL
+        if (isKeyPressedOnce(win, GLFW_KEY_F3)) logAssetUsage();
+        // Current layout and model controls, to reproduce this scene with --scene
+        if (isKeyPressedOnce(win, GLFW_KEY_F5)) saveScene("scene.efs", "scene.json");
+        // Presentation only; the simulation keeps its fixed rate in every mode
+        if (isKeyPressedOnce(win, GLFW_KEY_F4) && !bench.cfg.enabled) {
+            FramePacing wanted = (FramePacing)((framePacing + 1) % PACING_COUNT);
+            framePacing = applyFramePacing(wanted);
+            // Adaptive vsync fell back to plain vsync: move on instead of toggling vsync twice
+            if (wanted == PACING_ADAPTIVE_VSYNC && framePacing != wanted) framePacing = applyFramePacing(PACING_UNCAPPED);
+            std::cout << "[Action] Frame pacing -> " << framePacingName(framePacing);
+            if (framePacing == PACING_CAPPED) std::cout << " " << frameLimiter.fps << " fps";
+            std::cout << "\n";
+        }
+        // Toggle frustum/fog culling and report what the last frame culled
+        if (isKeyPressedOnce(win, GLFW_KEY_C)) {
+            logCullStats();
+            cullingEnabled = !cullingEnabled;
+            std::cout << "[Action] Culling -> " << (cullingEnabled ? "on" : "off") << "\n";
+        }
         // Adjust fountain radius in 2D (affects overlay annulus and 3D ring build)
         if (isKeyPressedOnce(win, GLFW_KEY_LEFT_BRACKET)) {
             fountainRadius = std::max(10, fountainRadius - 2);
-            updateAccuratePathMesh();
-            updateFountainRing(fountainScale);
+            markMeshesDirty(MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
             std::cout << "[Action] Fountain radius decreased: " << fountainRadius << " px\n";
         }
         if (isKeyPressedOnce(win, GLFW_KEY_RIGHT_BRACKET)) {
             fountainRadius = std::min(240, fountainRadius + 2);
-            updateAccuratePathMesh();
-            updateFountainRing(fountainScale);
+            markMeshesDirty(MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
             std::cout << "[Action] Fountain radius increased: " << fountainRadius << " px\n";
         }
 
+        // Coalesced mesh rebuilds queued by this and the previous frame's input handling
+        flushMeshRebuilds();
+
         // 3D rendering pass
         if (currentView == VIEW_3D) {
-            setCommonUniforms(shaderProgram, view, projection, cameraPos);
-
-            // Ground
-            glUseProgram(shaderProgram);
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, groundTextures[currentGroundTex]);
-            glUniform1i(glGetUniformLocation(shaderProgram, "texture_diffuse1"), 0);
-            glm::mat4 groundModel(1.0f);
-            glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &groundModel[0][0]);
-            glBindVertexArray(groundVAO);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
-
-            // Paths (always render accurate user paths when available). Fallback to stylized mesh.
-            glBindTexture(GL_TEXTURE_2D, pathTexture);
-            if (layoutPathVAO && layoutPathIndexCount > 0) {
-                glBindVertexArray(layoutPathVAO);
-                glDrawElements(GL_TRIANGLES, layoutPathIndexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-            } else if (pathVAO) {
-                glBindVertexArray(pathVAO);
-                GLint eboSize = 0; glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &eboSize);
-                GLsizei count = (GLsizei)(eboSize / sizeof(unsigned int));
-                glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
+            beginCullFrame(view, projection);
+            if (worldChunksEnabled) {
+                // Out to full fog, capped at the far plane
+                profilerBegin(PROF_CHUNK_STREAM);
+                chunkedWorld.update(cameraPos, std::min(fogCullDist, 100.0f));
+                profilerEnd(PROF_CHUNK_STREAM);
             }
+            cullTrees();
 
-            // Fountain: draw OBJ if available, else procedural fallback. Fountain rotates in yaw only.
-            if (useProceduralFountain) {
-                drawProceduralFountain(shaderProgram, view, projection);
-            } else {
-                // Apply yaw-only rotation and scale to OBJ fountain
-                fountainModel.rotation.y = glm::radians(fountainYawDeg);
-                fountainModel.rotation.x = 0.0f;
-                fountainModel.rotation.z = 0.0f;
-                fountainModel.scale = glm::vec3(0.5f * fountainGlobalScale);
-                drawModel(fountainModel, view, projection);
-            }
+            // The only texture bind of the pass besides the fountain OBJ: every other draw picks a layer
+            bindTexture(kSceneTextureUnit, GL_TEXTURE_2D_ARRAY, sceneTextures);
+            // Depth from the light for the cascades due this frame, then the receivers' frame block
+            renderShadowPass(view, projection);
+            bindTexture(kShadowMapUnit, GL_TEXTURE_2D_ARRAY, shadowMaps.depthArray);
+            setSceneUniforms(view, projection, cameraPos, renderTime);
 
-            // Procedural trees: trunk (textured) + leaves (textured)
-            for (auto &ti : treeInstances) {
-                // Increase tree scaling so they are not too small vs fountain
-                float fScale = fountainScale;
-                float base = (ti.size==Small?0.9f:(ti.size==Medium?1.2f:1.7f));
-                float trunkH = base * (fScale * 3.0f) * treeScaleFactor;
-                float trunkR = base * (0.10f * fScale * 1.2f) * treeScaleFactor;
-                float coneH  = base * (fScale * 2.4f) * treeScaleFactor;
-                float coneR  = base * (0.24f * fScale * 1.8f) * treeScaleFactor;
-
-                // trunk (apply tree yaw rotation and scale)
-                glm::mat4 modelM = glm::translate(glm::mat4(1.0f), glm::vec3(ti.pos.x, 0.0f, ti.pos.y));
-                modelM = glm::rotate(modelM, glm::radians(treeYawDeg), glm::vec3(0,1,0));
-                // scale factors incorporate treeGlobalScale
-                modelM = glm::scale(modelM, glm::vec3((trunkR*treeGlobalScale)/0.08f, (trunkH*treeGlobalScale)/1.0f, (trunkR*treeGlobalScale)/0.08f));
-                glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &modelM[0][0]);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, trunkTexture);
-                glUniform1i(glGetUniformLocation(shaderProgram, "texture_diffuse1"), 0);
-                glUniform1i(glGetUniformLocation(shaderProgram, "solidMode"), 0);
-                glBindVertexArray(trunkVAO);
-                glDrawElements(GL_TRIANGLES, trunkIndexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                // foliage cone on top (apply same tree rotation and scale)
-                glm::mat4 coneM = glm::translate(glm::mat4(1.0f), glm::vec3(ti.pos.x, trunkH*treeGlobalScale, ti.pos.y));
-                coneM = glm::rotate(coneM, glm::radians(treeYawDeg), glm::vec3(0,1,0));
-                coneM = glm::scale(coneM, glm::vec3((coneR*treeGlobalScale)/0.20f, (coneH*treeGlobalScale)/1.0f, (coneR*treeGlobalScale)/0.20f));
-                glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &coneM[0][0]);
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, leavesTexture);
-                glUniform1i(glGetUniformLocation(shaderProgram, "texture_diffuse1"), 0);
-                glUniform1i(glGetUniformLocation(shaderProgram, "solidMode"), 0);
-                glBindVertexArray(coneVAO);
-                glDrawElements(GL_TRIANGLES, coneIndexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-                glUniform1i(glGetUniformLocation(shaderProgram, "solidMode"), 0);
-            }
-
-            // Star hedge wedges
-            drawHedgeWedges(shaderProgram);
-
-            // Ring (annulus) with world-aligned UV tiling (path.png 1:1 per grid cell)
-            if (ringVAO && ringIndexCount > 0) {
-                glm::mat4 ringModel = glm::mat4(1.0f);
-                glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &ringModel[0][0]);
-                glBindTexture(GL_TEXTURE_2D, pathTexture);
-                glBindVertexArray(ringVAO);
-                glDrawElements(GL_TRIANGLES, ringIndexCount, GL_UNSIGNED_INT, 0);
-                glBindVertexArray(0);
-            }
+            // Opaque and alpha-tested geometry: sorted for early-Z, optionally after a depth pre-pass
+            recordScenePass();
+            renderQueue.execute();
 
             // Fireflies
-            drawFireflies(shaderProgram, view, projection, time);
+            profilerBegin(PROF_FIREFLIES);
+            drawFireflies(fireflyShaderProgram);
+            profilerEnd(PROF_FIREFLIES);
         }
 
-        // In 2D view, draw coded pixel glyphs instead of OBJ models / textures
+        // In 2D view, draw coded pixel glyphs instead of OBJ models / textures, then the
+        // blueprint overlay
         if (currentView == VIEW_2D) {
+            profilerBegin(PROF_OVERLAY);
             drawPixelObjects2D();
+            drawBlueprintOverlay();
+            profilerEnd(PROF_OVERLAY);
         }
 
         // (Debug cubes removed)
 
         // (Removed NDC triangle debug)
 
-
-        // Draw 2D blueprint overlay only in VIEW_2D
-        drawBlueprintOverlay();
-
-        // Separate model controls (3D only)
-        if (currentView == VIEW_3D) {
-            // Trees: scale with I/O, yaw left with J
-            if (glfwGetKey(win, GLFW_KEY_I)) { treeGlobalScale = std::min(3.0f, treeGlobalScale + 0.01f); std::cout << "[Action] Trees scale + -> " << treeGlobalScale << "\n"; }
-            if (glfwGetKey(win, GLFW_KEY_O)) { treeGlobalScale = std::max(0.2f, treeGlobalScale - 0.01f); std::cout << "[Action] Trees scale - -> " << treeGlobalScale << "\n"; }
-            if (glfwGetKey(win, GLFW_KEY_J)) { treeYawDeg -= 0.8f; std::cout << "[Action] Trees yaw left -> " << treeYawDeg << " deg\n"; }
-
-            // Fountain: scale with K/L, yaw right with U
-            if (glfwGetKey(win, GLFW_KEY_K)) {
-                fountainGlobalScale = std::min(3.0f, fountainGlobalScale + 0.01f);
-                hedgeGlobalScale = fountainGlobalScale * 0.8f;
-                updateAccuratePathMesh();
-                updateFountainRing(fountainScale);
-                // Rebuild hedge meshes to reflect scale visually
-                wedgeVAO1 = wedgeVBO1 = wedgeEBO1 = 0; wedgeIdx1 = 0;
-                wedgeVAO2 = wedgeVBO2 = wedgeEBO2 = 0; wedgeIdx2 = 0;
-                buildHedgeMeshes();
-                // Preserve per-tree fountain gap: r_new = fountainFootprintNew + gap_i
-                float newFountainFoot = fountainScale * fountainGlobalScale * 1.1f;
-                float newHedgeOuter   = wedgeROuter2 * hedgeGlobalScale;
-                for (size_t i=0;i<treeInstances.size();++i) {
-                    glm::vec2 p(treeInstances[i].pos.x, treeInstances[i].pos.y);
-                    float r = glm::length(p);
-                    float desiredR = newFountainFoot + (i < treeFountainGap.size()? treeFountainGap[i] : 0.0f);
-                    // Ensure we also honor stored hedge margin if it pushes further out
-                    if (i < treeOuterMargin.size()) {
-                        float hedgeDesired = newHedgeOuter + treeOuterMargin[i];
-                        if (hedgeDesired > desiredR) desiredR = hedgeDesired;
-                    }
-                    if (r > 1e-5f) {
-                        glm::vec2 dir = p / r;
-                        treeInstances[i].pos = dir * desiredR;
-                    }
-                }
-                std::cout << "[Action] Fountain scale + -> " << fountainGlobalScale << " (paths/ring/hedges updated)\n";
-            }
-            if (glfwGetKey(win, GLFW_KEY_L)) {
-                fountainGlobalScale = std::max(0.2f, fountainGlobalScale - 0.01f);
-                hedgeGlobalScale = fountainGlobalScale * 0.8f;
-                updateAccuratePathMesh();
-                updateFountainRing(fountainScale);
-                wedgeVAO1 = wedgeVBO1 = wedgeEBO1 = 0; wedgeIdx1 = 0;
-                wedgeVAO2 = wedgeVBO2 = wedgeEBO2 = 0; wedgeIdx2 = 0;
-                buildHedgeMeshes();
-                // Preserve per-tree fountain gap when shrinking
-                float newFountainFoot = fountainScale * fountainGlobalScale * 1.1f;
-                float newHedgeOuter   = wedgeROuter2 * hedgeGlobalScale;
-                for (size_t i=0;i<treeInstances.size();++i) {
-                    glm::vec2 p(treeInstances[i].pos.x, treeInstances[i].pos.y);
-                    float r = glm::length(p);
-                    float desiredR = newFountainFoot + (i < treeFountainGap.size()? treeFountainGap[i] : 0.0f);
-                    if (i < treeOuterMargin.size()) {
-                        float hedgeDesired = newHedgeOuter + treeOuterMargin[i];
-                        if (hedgeDesired > desiredR) desiredR = hedgeDesired; // keep trees outside hedge margin
-                    }
-                    if (r > 1e-5f) {
-                        glm::vec2 dir = p / r;
-                        treeInstances[i].pos = dir * desiredR;
-                    }
-                }
-                std::cout << "[Action] Fountain scale - -> " << fountainGlobalScale << " (paths/ring/hedges updated)\n";
-            }
-            if (glfwGetKey(win, GLFW_KEY_U)) { fountainYawDeg += 0.8f; std::cout << "[Action] Fountain yaw right -> " << fountainYawDeg << " deg\n"; }
-        }
+        if (showProfiler) drawProfilerBar();
 
         // Collision guard: prevent fountain scaling into hedges; scale hedges with fountain and push/pull trees to follow
         {
@@ -1684,6 +3096,7 @@ int main() {
                 float prev = fountainGlobalScale;
                 fountainGlobalScale = std::max(0.2f, (hedgeInnerScaled*0.95f) / (fountainScale * 1.1f));
                 if (fabsf(prev - fountainGlobalScale) > 1e-6f) {
+                    markMeshesDirty(MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
                     std::cout << "[Guard] Fountain scale clamped from " << prev << " to " << fountainGlobalScale << " to avoid hedge collision\n";
                 }
             }
@@ -1692,33 +3105,20 @@ int main() {
             // Push trees outward if now inside outer hedge disk; pull inward if hedge shrinks
             static float lastHedgeOuterScaled = wedgeROuter2; // initial reference
             float newHedgeOuterScaled = wedgeROuter2 * hedgeGlobalScale;
-            int pushed=0, pulled=0;
-            for (auto &ti : treeInstances) {
-                glm::vec2 p(ti.pos.x, ti.pos.y);
-                float r = glm::length(p);
-                float minR = newHedgeOuterScaled + 0.15f;
-                if (newHedgeOuterScaled >= lastHedgeOuterScaled) {
-                    // Hedge expanded: ensure trees are at least just outside the new disk
-                    if (r < minR && r > 1e-4f) {
-                        glm::vec2 dir = p / r;
-                        // Preserve per-tree margin if available
-                        size_t idx = &ti - &treeInstances[0];
-                        float margin = (idx < treeOuterMargin.size() ? treeOuterMargin[idx] : 0.15f);
-                        ti.pos = dir * std::max(minR, newHedgeOuterScaled + margin);
-                        pushed++;
-                    }
-                } else {
-                    // Hedge shrank: keep constant margin from new outer radius
-                    if (r > 1e-4f) {
-                        size_t idx = &ti - &treeInstances[0];
-                        float margin = (idx < treeOuterMargin.size() ? treeOuterMargin[idx] : 0.15f);
-                        float newR = std::max(minR, newHedgeOuterScaled + margin);
-                        glm::vec2 dir = p / r;
-                        ti.pos = dir * newR;
-                        pulled++;
-                    }
-                }
+            // One batched pass over treeStore; a hedge at rest only scans for trees inside its disk
+            RadialConstraint c;
+            c.floorR = newHedgeOuterScaled + 0.15f;
+            c.hedgeOuter = newHedgeOuterScaled;
+            size_t pushed = 0, pulled = 0;
+            if (newHedgeOuterScaled >= lastHedgeOuterScaled) {
+                // Hedge expanded: ensure trees are at least just outside the new disk, keeping their margin
+                c.onlyInsideFloor = true;
+                pushed = applyRadialConstraint(treeStore, c);
+            } else {
+                // Hedge shrank: keep constant margin from new outer radius
+                pulled = applyRadialConstraint(treeStore, c);
             }
+            if (pushed>0 || pulled>0) treeRevision++;
             if (pushed>0) std::cout << "[Guard] Trees pushed outward: " << pushed << "\n";
             if (pulled>0) std::cout << "[Guard] Trees pulled inward: " << pulled << "\n";
             lastHedgeOuterScaled = newHedgeOuterScaled;
@@ -1731,12 +3131,11 @@ int main() {
 
         // R to fully reset: camera, view mode, all transforms, scalings, and visual state
         if (isKeyPressedOnce(win, GLFW_KEY_R)) {
-            // Reset camera and orientation
-            cameraPos   = glm::vec3(0.0f, 2.0f, 10.0f);
-            cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+            // Reset camera and orientation (both ticks, so it does not glide back)
+            simCamera = prevSimCamera = kStartCamera;
+            cameraPos   = kStartCamera.position;
+            cameraFront = cameraFrontFrom(kStartCamera.yawDeg, kStartCamera.pitchDeg);
             cameraUp    = glm::vec3(0.0f, 1.0f, 0.0f);
-            yawDeg   = -90.0f;
-            pitchDeg = 0.0f;
             // Reset view mode
             currentView = VIEW_3D;
             std::string t = std::string("Enchanted Forest [") + (currentView==VIEW_3D?"3D":"2D") + "]";
@@ -1760,34 +3159,45 @@ int main() {
             } else {
                 fountainScale = 0.5f; // procedural base scale
             }
-            // Rebuild hedges with base radii
-            wedgeVAO1 = wedgeVBO1 = wedgeEBO1 = 0; wedgeIdx1 = 0;
-            wedgeVAO2 = wedgeVBO2 = wedgeEBO2 = 0; wedgeIdx2 = 0;
-            buildHedgeMeshes();
-            // Recompute dependent meshes
-            updatePathMesh(pathStyle);
-            updateAccuratePathMesh();
-            updateFountainRing(fountainScale);
+            // Rebuild hedges with base radii and recompute dependent meshes (next frame's flush)
+            markMeshesDirty(MESH_DIRTY_HEDGES | MESH_DIRTY_PATH_STYLE | MESH_DIRTY_LAYOUT_PATH | MESH_DIRTY_RING_TOPOLOGY);
             // Recompute per-tree gap baselines after full reset
-            treeOuterMargin.clear();
-            treeFountainGap.clear();
             float resetOuter = wedgeROuter2 * hedgeGlobalScale;
             float resetFountainFoot = fountainScale * fountainGlobalScale * 1.1f;
-            for (auto &ti : treeInstances) {
-                float r = glm::length(glm::vec2(ti.pos.x, ti.pos.y));
-                treeOuterMargin.push_back(std::max(0.0f, r - resetOuter));
-                treeFountainGap.push_back(std::max(0.0f, r - resetFountainFoot));
+            for (size_t i = 0; i < treeStore.count(); ++i) {
+                float r = glm::length(treeStore.pos(i));
+                treeStore.outerMargin[i] = std::max(0.0f, r - resetOuter);
+                treeStore.fountainGap[i] = std::max(0.0f, r - resetFountainFoot);
             }
             debugFlashPing(glm::vec3(0.7f, 0.9f, 0.6f));
             std::cout << "[Action] Full reset: camera, view, styles, transforms, and meshes restored to start\n";
         }
 
-        glfwSwapBuffers(win);
+        profilerEndFrame();
+        if (framePacing == PACING_CAPPED) frameLimiter.wait();
+        // Offscreen has no swap to pace on, so wait for the GPU to keep frame times honest
+        if (benchFBO) glFinish(); else glfwSwapBuffers(win);
         glfwPollEvents();
-        time += 0.01f;
-        if (debugFlash > 0.0f) debugFlash -= 0.016f;
+        if (bench.cfg.enabled) {
+            bench.recordFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+            if (bench.finished()) glfwSetWindowShouldClose(win, GLFW_TRUE);
+        }
     }
 
+    if (bench.cfg.enabled) bench.report();
+
+    shutdownTextureLoader();
+    shutdownJobs();
+    staticBatch.destroy();
+    chunkedWorld.destroy();
+    treeImpostor.destroy();
+    shadowMaps.destroy();
+    glDeleteBuffers(kShadowCascades, shadowTreeVBO);
+    destroyUniformBlocks();
+    glDeleteBuffers(1, &impostorQuadVBO);
+    deleteVertexArrays(1, &impostorVAO);
+    releaseAllAssets();
+    profilerShutdown();
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,157 @@
+#include "mesh_cache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+// ---------------- Mapped file ----------------
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE fh = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(fh, &sz) || sz.QuadPart <= 0) { CloseHandle(fh); return false; }
+    HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mh) { CloseHandle(fh); return false; }
+    void* view = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mh); CloseHandle(fh); return false; }
+    fileHandle = fh;
+    mappingHandle = mh;
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)sz.QuadPart;
+#else
+    int f = ::open(path.c_str(), O_RDONLY);
+    if (f < 0) return false;
+    struct stat st;
+    if (fstat(f, &st) != 0 || st.st_size <= 0) { ::close(f); return false; }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, f, 0);
+    if (view == MAP_FAILED) { ::close(f); return false; }
+    fd = f;
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    mappingHandle = fileHandle = nullptr;
+#else
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// ---------------- Binary mesh cache ----------------
+static bool statSource(const std::string& path, uint64_t& size, int64_t& mtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    size = (uint64_t)st.st_size;
+    mtime = (int64_t)st.st_mtime;
+    return true;
+}
+
+static uint32_t alignUp16(uint32_t v) { return (v + 15u) & ~15u; }
+
+std::string meshCachePathFor(const std::string& sourcePath) {
+    return sourcePath + ".meshcache";
+}
+
+bool openMeshCache(const std::string& sourcePath, MappedFile& file, MeshCacheView& view) {
+    uint64_t srcSize = 0; int64_t srcTime = 0;
+    if (!statSource(sourcePath, srcSize, srcTime)) return false;
+    if (!file.open(meshCachePathFor(sourcePath))) return false;
+    if (file.size < sizeof(MeshCacheHeader)) { file.close(); return false; }
+
+    MeshCacheHeader h;
+    std::memcpy(&h, file.data, sizeof(h));
+    bool valid = std::memcmp(h.magic, "EFMC", 4) == 0
+              && h.version == MESH_CACHE_VERSION
+              && h.floatsPerVertex == 8
+              && h.sourceSize == srcSize
+              && h.sourceMTime == srcTime
+              && (h.vertexOffset % 16) == 0 && (h.indexOffset % 16) == 0
+              && (uint64_t)h.vertexOffset + (uint64_t)h.vertexCount * 8 * sizeof(float) <= file.size
+              && (uint64_t)h.indexOffset + (uint64_t)h.indexCount * sizeof(uint32_t) <= file.size
+              && h.lodCount >= 1 && h.lodCount <= (uint32_t)kMaxMeshLods;
+    for (uint32_t i = 0; valid && i < h.lodCount; ++i)
+        valid = (uint64_t)h.lods[i].firstIndex + h.lods[i].indexCount <= h.indexCount;
+    // One pass over the indices: a damaged or hand-edited file must not reach glDrawElements
+    // with indices past the vertex block; rejecting it rebuilds the cache from the OBJ
+    if (valid) {
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(file.data + h.indexOffset);
+        for (uint32_t i = 0; valid && i < h.indexCount; ++i) valid = indices[i] < h.vertexCount;
+    }
+    if (!valid) { file.close(); return false; }
+
+    view.vertices    = reinterpret_cast<const float*>(file.data + h.vertexOffset);
+    view.vertexCount = h.vertexCount;
+    view.indices     = reinterpret_cast<const uint32_t*>(file.data + h.indexOffset);
+    view.indexCount  = h.indexCount;
+    view.lodCount    = h.lodCount;
+    std::memcpy(view.lods, h.lods, sizeof(h.lods));
+    view.radiusXZ = h.radiusXZ;
+    view.minY = h.minY;
+    view.maxY = h.maxY;
+    return true;
+}
+
+bool writeMeshCache(const std::string& sourcePath,
+                    const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                    const std::vector<MeshLod>& lods, float radiusXZ, float minY, float maxY) {
+    if (lods.empty() || lods.size() > (size_t)kMaxMeshLods) return false;
+    MeshCacheHeader h;
+    std::memset(&h, 0, sizeof(h));
+    if (!statSource(sourcePath, h.sourceSize, h.sourceMTime)) return false;
+    std::memcpy(h.magic, "EFMC", 4);
+    h.version = MESH_CACHE_VERSION;
+    h.floatsPerVertex = 8;
+    h.vertexCount = (uint32_t)(vertices.size() / 8);
+    h.indexCount = (uint32_t)indices.size();
+    h.vertexOffset = alignUp16((uint32_t)sizeof(MeshCacheHeader));
+    h.indexOffset = alignUp16(h.vertexOffset + h.vertexCount * 8 * (uint32_t)sizeof(float));
+    h.radiusXZ = radiusXZ;
+    h.minY = minY;
+    h.maxY = maxY;
+    h.lodCount = (uint32_t)lods.size();
+    for (size_t i = 0; i < lods.size(); ++i) h.lods[i] = lods[i];
+
+    // Write to a temp file first so a crash mid-write never leaves a truncated cache behind
+    std::string cachePath = meshCachePathFor(sourcePath);
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        static const char zeros[16] = {0};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(zeros, h.vertexOffset - sizeof(h));
+        out.write(reinterpret_cast<const char*>(vertices.data()), (std::streamsize)(h.vertexCount * 8 * sizeof(float)));
+        uint32_t vertexEnd = h.vertexOffset + h.vertexCount * 8 * (uint32_t)sizeof(float);
+        out.write(zeros, h.indexOffset - vertexEnd);
+        out.write(reinterpret_cast<const char*>(indices.data()), (std::streamsize)(indices.size() * sizeof(uint32_t)));
+        if (!out.good()) { out.close(); std::remove(tmpPath.c_str()); return false; }
+    }
+    std::remove(cachePath.c_str()); // rename() does not overwrite on Windows
+    return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+}
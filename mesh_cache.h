@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------------- Mapped file ----------------
+// Read-only view of a whole file (Win32 file mapping or POSIX mmap).
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// ---------------- Binary mesh cache ----------------
+// Compiled form of an OBJ mesh written next to the source file (<source>.meshcache).
+// Layout: MeshCacheHeader, interleaved vertex block (pos3, normal3, uv2 floats), index block
+// (uint32). Both blocks start on 16-byte boundaries so they can be uploaded straight from the mapping.
+// Version 2: deduplicated shared vertices in vertex-cache-optimised triangle order.
+// Version 3: the index block holds lodCount levels back to back (LOD 0 first, full detail), all
+// indexing the one vertex block.
+// Version 4: levels simplified on the welded surface (version 3 files mostly hold one level).
+static const uint32_t MESH_CACHE_VERSION = 4;
+
+static const int kMaxMeshLods = 4;
+// Triangle share of each simplified level, relative to LOD 0
+static const float kMeshLodRatios[kMaxMeshLods - 1] = { 0.5f, 0.25f, 0.125f };
+// Range of one detail level inside a mesh's index buffer
+struct MeshLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+struct MeshCacheHeader {
+    char     magic[4];        // "EFMC"
+    uint32_t version;         // MESH_CACHE_VERSION
+    uint64_t sourceSize;      // staleness check: size of the source OBJ at bake time
+    int64_t  sourceMTime;     // staleness check: modification time of the source OBJ
+    uint32_t vertexCount;
+    uint32_t floatsPerVertex; // 8 (pos, normal, uv)
+    uint32_t indexCount;      // all levels
+    uint32_t vertexOffset;    // byte offset of the vertex block
+    uint32_t indexOffset;     // byte offset of the index block
+    float    radiusXZ;        // bounds mirrored from Model
+    float    minY;
+    float    maxY;
+    uint32_t lodCount;        // 1..kMaxMeshLods
+    MeshLod  lods[kMaxMeshLods];
+};
+
+// Pointers into a mapped cache file; valid while the MappedFile stays open.
+struct MeshCacheView {
+    const float*    vertices = nullptr;
+    uint32_t        vertexCount = 0;
+    const uint32_t* indices = nullptr;
+    uint32_t        indexCount = 0;
+    uint32_t        lodCount = 0;
+    MeshLod         lods[kMaxMeshLods] = {};
+    float radiusXZ = 1.0f, minY = 0.0f, maxY = 0.0f;
+};
+
+std::string meshCachePathFor(const std::string& sourcePath);
+// Maps <sourcePath>.meshcache and validates it against the source file; false if missing, stale or
+// damaged (ranges past the file, or an index past the vertex block).
+bool openMeshCache(const std::string& sourcePath, MappedFile& file, MeshCacheView& view);
+// indices holds every level; lods (1..kMaxMeshLods entries) are ranges into it
+bool writeMeshCache(const std::string& sourcePath,
+                    const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                    const std::vector<MeshLod>& lods, float radiusXZ, float minY, float maxY);
@@ -0,0 +1,461 @@
+#include "mesh_optimize.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+// ---------------- Forsyth vertex scoring ----------------
+namespace {
+const int   kCacheSize          = 32;
+const float kCacheDecayPower    = 1.5f;
+const float kLastTriScore       = 0.75f;
+const float kValenceBoostScale  = 2.0f;
+const float kValenceBoostPower  = 0.5f;
+
+float vertexScore(int cachePos, int remainingTris) {
+    if (remainingTris <= 0) return -1.0f; // no triangles left: never pick
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        if (cachePos < 3) {
+            // Vertices of the triangle just emitted get a fixed score so the next triangle
+            // does not simply reuse the same edge every time
+            score = kLastTriScore;
+        } else {
+            const float scaler = 1.0f / (kCacheSize - 3);
+            score = std::pow(1.0f - (cachePos - 3) * scaler, kCacheDecayPower);
+        }
+    }
+    // Boost vertices with few remaining triangles so lone triangles are not left stranded
+    score += kValenceBoostScale * std::pow((float)remainingTris, -kValenceBoostPower);
+    return score;
+}
+} // namespace
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triCount = indices.size() / 3;
+    if (triCount == 0 || vertexCount == 0) return;
+
+    // Vertex -> triangle adjacency (CSR layout)
+    std::vector<int> triOffset(vertexCount + 1, 0);
+    for (unsigned int v : indices) triOffset[v + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) triOffset[v + 1] += triOffset[v];
+    std::vector<int> triList(indices.size());
+    std::vector<int> fill(triOffset.begin(), triOffset.end() - 1);
+    for (size_t t = 0; t < triCount; ++t)
+        for (int k = 0; k < 3; ++k) triList[fill[indices[t*3+k]]++] = (int)t;
+
+    std::vector<int> remaining(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) remaining[v] = triOffset[v+1] - triOffset[v];
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vScore[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> tScore(triCount);
+    std::vector<char> emitted(triCount, 0);
+    for (size_t t = 0; t < triCount; ++t)
+        tScore[t] = vScore[indices[t*3]] + vScore[indices[t*3+1]] + vScore[indices[t*3+2]];
+
+    std::vector<unsigned int> out;
+    out.reserve(indices.size());
+    // LRU cache with room for the 3 vertices pushed by the incoming triangle
+    int cache[kCacheSize + 3];
+    int cacheCount = 0;
+
+    int bestTri = 0;
+    for (size_t t = 1; t < triCount; ++t) if (tScore[t] > tScore[bestTri]) bestTri = (int)t;
+    size_t scanCursor = 0; // restart point when the cache neighbourhood is exhausted
+
+    for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+        if (bestTri < 0) {
+            // Nothing adjacent to the cache is left: restart from the next unused triangle in
+            // input order (a global best-score search here would make the pass quadratic)
+            while (scanCursor < triCount && emitted[scanCursor]) scanCursor++;
+            if (scanCursor == triCount) break;
+            bestTri = (int)scanCursor;
+        }
+
+        emitted[bestTri] = 1;
+        unsigned int tv[3] = { indices[bestTri*3], indices[bestTri*3+1], indices[bestTri*3+2] };
+        out.insert(out.end(), tv, tv + 3);
+
+        // Remove the triangle from its vertices' adjacency lists
+        for (unsigned int v : tv) {
+            int* begin = &triList[triOffset[v]];
+            int* end = begin + remaining[v];
+            int* it = std::find(begin, end, bestTri);
+            if (it != end) { *it = *(end - 1); remaining[v]--; }
+        }
+
+        // Move the triangle's vertices to the front of the LRU cache
+        int newCache[kCacheSize + 3];
+        int newCount = 0;
+        for (unsigned int v : tv) newCache[newCount++] = (int)v;
+        for (int i = 0; i < cacheCount; ++i) {
+            int v = cache[i];
+            if (v == (int)tv[0] || v == (int)tv[1] || v == (int)tv[2]) continue;
+            newCache[newCount++] = v;
+        }
+        // Vertices that fell out of the cache lose their cache bonus
+        for (int i = kCacheSize; i < newCount; ++i) {
+            int v = newCache[i];
+            cachePos[v] = -1;
+            vScore[v] = vertexScore(-1, remaining[v]);
+            for (int k = triOffset[v]; k < triOffset[v] + remaining[v]; ++k) {
+                int t = triList[k];
+                tScore[t] = vScore[indices[t*3]] + vScore[indices[t*3+1]] + vScore[indices[t*3+2]];
+            }
+        }
+        cacheCount = std::min(newCount, kCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        // Rescore everything still in the cache and pick the best neighbouring triangle
+        for (int i = 0; i < cacheCount; ++i) {
+            int v = cache[i];
+            cachePos[v] = i;
+            vScore[v] = vertexScore(i, remaining[v]);
+        }
+        bestTri = -1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < cacheCount; ++i) {
+            int v = cache[i];
+            for (int k = triOffset[v]; k < triOffset[v] + remaining[v]; ++k) {
+                int t = triList[k];
+                float s = vScore[indices[t*3]] + vScore[indices[t*3+1]] + vScore[indices[t*3+2]];
+                tScore[t] = s;
+                if (s > bestScore) { bestScore = s; bestTri = t; }
+            }
+        }
+    }
+
+    indices.swap(out);
+}
+
+void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices, size_t stride) {
+    const size_t vertexCount = vertices.size() / stride;
+    const unsigned int kUnassigned = 0xFFFFFFFFu;
+    std::vector<unsigned int> remap(vertexCount, kUnassigned);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+    unsigned int next = 0;
+    for (unsigned int& idx : indices) {
+        if (remap[idx] == kUnassigned) {
+            remap[idx] = next++;
+            reordered.insert(reordered.end(), vertices.begin() + idx*stride, vertices.begin() + (idx+1)*stride);
+        }
+        idx = remap[idx];
+    }
+    vertices.swap(reordered);
+}
+
+float averageCacheMissRatio(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize) {
+    if (indices.size() < 3) return 0.0f;
+    // FIFO model: what most post-transform caches behave like in practice
+    std::vector<int> insertedAt(vertexCount, -1);
+    int clock = 0, misses = 0;
+    for (unsigned int v : indices) {
+        if (insertedAt[v] < 0 || clock - insertedAt[v] >= cacheSize) {
+            insertedAt[v] = clock++;
+            misses++;
+        }
+    }
+    return (float)misses / (float)(indices.size() / 3);
+}
+
+// ---------------- Quadric simplification ----------------
+namespace {
+// Symmetric 4x4 error quadric: xx xy xz xw yy yz yw zz zw ww
+struct Quadric {
+    double m[10] = {};
+    void addPlane(const glm::dvec3& n, double d, double weight) {
+        double p[4] = { n.x, n.y, n.z, d };
+        int k = 0;
+        for (int i = 0; i < 4; ++i)
+            for (int j = i; j < 4; ++j) m[k++] += weight * p[i] * p[j];
+    }
+    void add(const Quadric& o) { for (int i = 0; i < 10; ++i) m[i] += o.m[i]; }
+    double error(const glm::dvec3& v) const {
+        double x = v.x, y = v.y, z = v.z;
+        return m[0]*x*x + 2*m[1]*x*y + 2*m[2]*x*z + 2*m[3]*x + m[4]*y*y + 2*m[5]*y*z + 2*m[6]*y
+             + m[7]*z*z + 2*m[8]*z + m[9];
+    }
+};
+
+struct Collapse {
+    double cost;
+    unsigned int from, to;  // position ids
+    unsigned int stamp;     // from's stamp when queued; stale once from's neighbourhood changed
+    bool operator<(const Collapse& o) const { return cost > o.cost; } // min-heap
+};
+
+// Bit pattern of a position; -0 is folded onto +0 so both weld
+struct PositionKey {
+    uint32_t bits[3];
+    bool operator==(const PositionKey& o) const {
+        return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+    }
+};
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& k) const {
+        return (size_t)(k.bits[0] * 73856093u ^ k.bits[1] * 19349663u ^ k.bits[2] * 83492791u);
+    }
+};
+
+// An attribute mismatch of 1 (squared normal + UV distance) costs as much as moving the
+// vertex's area by 3% of the mesh's bounding diagonal (the least UV stretch on Fountain.obj)
+const double kAttributeWeight = 0.03 * 0.03;
+} // namespace
+
+std::vector<unsigned int> simplifyMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                                       size_t stride, size_t targetIndexCount) {
+    const size_t vertexCount = vertices.size() / stride;
+    const size_t triCount = indices.size() / 3;
+    std::vector<unsigned int> tris(indices.begin(), indices.begin() + triCount * 3);
+    if (triCount == 0 || targetIndexCount >= tris.size()) return tris;
+
+    // Weld: the vertices the OBJ split at one position (normal / UV seams) share a position id.
+    // Topology, quadrics and collapses work on position ids; tris keeps the split vertices.
+    std::vector<unsigned int> posId(vertexCount);
+    std::vector<glm::dvec3> positions;
+    {
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> weld;
+        weld.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            PositionKey key;
+            for (int k = 0; k < 3; ++k) {
+                float f = vertices[v * stride + k] + 0.0f;
+                std::memcpy(&key.bits[k], &f, sizeof(float));
+            }
+            auto it = weld.emplace(key, (unsigned int)positions.size());
+            if (it.second) {
+                const float* p = &vertices[v * stride];
+                positions.push_back(glm::dvec3(p[0], p[1], p[2]));
+            }
+            posId[v] = it.first->second;
+        }
+    }
+    const size_t posCount = positions.size();
+    auto at = [&](unsigned int t, int k) { return posId[tris[t * 3 + k]]; };
+    auto hasPos = [&](unsigned int t, unsigned int p) { return at(t, 0) == p || at(t, 1) == p || at(t, 2) == p; };
+
+    // Triangles that weld down to a point or a line draw nothing; they are dropped
+    std::vector<char> triAlive(triCount, 1);
+    std::vector<std::vector<unsigned int>> posTris(posCount);
+    size_t liveTris = 0;
+    for (size_t t = 0; t < triCount; ++t) {
+        unsigned int a = at((unsigned int)t, 0), b = at((unsigned int)t, 1), c = at((unsigned int)t, 2);
+        if (a == b || b == c || a == c) { triAlive[t] = 0; continue; }
+        for (int k = 0; k < 3; ++k) posTris[at((unsigned int)t, k)].push_back((unsigned int)t);
+        liveTris++;
+    }
+
+    // Open and non-manifold edges of the welded mesh lock both of their positions; seams are
+    // closed once welded, so only real borders stay fixed
+    std::unordered_map<uint64_t, int> edgeUse;
+    auto edgeKey = [](unsigned int a, unsigned int b) {
+        return ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+    };
+    for (size_t t = 0; t < triCount; ++t)
+        if (triAlive[t])
+            for (int k = 0; k < 3; ++k) edgeUse[edgeKey(at((unsigned int)t, k), at((unsigned int)t, (k + 1) % 3))]++;
+    std::vector<char> locked(posCount, 0);
+    for (const auto& e : edgeUse) {
+        if (e.second == 2) continue;
+        locked[(unsigned int)(e.first >> 32)] = 1;
+        locked[(unsigned int)(e.first & 0xffffffffu)] = 1;
+    }
+
+    // Area-weighted plane quadrics of the adjacent triangles
+    std::vector<Quadric> quadrics(posCount);
+    std::vector<double> area(posCount, 0.0);
+    glm::dvec3 lo = positions[0], hi = positions[0];
+    for (const glm::dvec3& p : positions) { lo = glm::min(lo, p); hi = glm::max(hi, p); }
+    for (size_t t = 0; t < triCount; ++t) {
+        if (!triAlive[t]) continue;
+        glm::dvec3 a = positions[at((unsigned int)t, 0)], b = positions[at((unsigned int)t, 1)], c = positions[at((unsigned int)t, 2)];
+        glm::dvec3 n = glm::cross(b - a, c - a);
+        double len = glm::length(n);
+        if (len < 1e-12) continue;
+        n /= len;
+        for (int k = 0; k < 3; ++k) {
+            quadrics[at((unsigned int)t, k)].addPlane(n, -glm::dot(n, a), 0.5 * len);
+            area[at((unsigned int)t, k)] += 0.5 * len / 3.0;
+        }
+    }
+    const double diagonal = glm::length(hi - lo);
+    const double attributeWeight = kAttributeWeight * diagonal * diagonal;
+
+    auto attributeDistance = [&](unsigned int a, unsigned int b) {
+        double d = 0.0;
+        for (size_t k = 3; k < stride; ++k) {
+            double e = (double)vertices[a * stride + k] - (double)vertices[b * stride + k];
+            d += e * e;
+        }
+        return d;
+    };
+    // Where each split vertex at u goes when u collapses onto v: the vertex it shares a
+    // triangle of the edge with (its side of the seam), else v's closest split in normal / UV.
+    // Returns the attribute mismatch of the fallbacks; the pairs go to map.
+    std::vector<unsigned int> splitsU, splitsV;
+    std::vector<std::pair<unsigned int, unsigned int>> map;
+    auto mapSplits = [&](unsigned int u, unsigned int v) {
+        splitsU.clear();
+        splitsV.clear();
+        map.clear();
+        for (unsigned int t : posTris[u]) {
+            if (!triAlive[t]) continue;
+            unsigned int su = 0, sv = 0;
+            bool shared = false;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int w = tris[t * 3 + k];
+                if (posId[w] == u) su = w;
+                else if (posId[w] == v) { sv = w; shared = true; }
+            }
+            splitsU.push_back(su);
+            if (shared) map.push_back({ su, sv });
+        }
+        for (unsigned int t : posTris[v]) {
+            if (!triAlive[t]) continue;
+            for (int k = 0; k < 3; ++k)
+                if (posId[tris[t * 3 + k]] == v) splitsV.push_back(tris[t * 3 + k]);
+        }
+        std::sort(splitsU.begin(), splitsU.end());
+        splitsU.erase(std::unique(splitsU.begin(), splitsU.end()), splitsU.end());
+        std::sort(splitsV.begin(), splitsV.end());
+        splitsV.erase(std::unique(splitsV.begin(), splitsV.end()), splitsV.end());
+        double mismatch = 0.0;
+        for (unsigned int su : splitsU) {
+            bool paired = false;
+            for (const auto& m : map) if (m.first == su) { paired = true; break; }
+            if (paired || splitsV.empty()) continue;
+            unsigned int best = splitsV[0];
+            double bestD = attributeDistance(su, best);
+            for (unsigned int sv : splitsV) {
+                double d = attributeDistance(su, sv);
+                if (d < bestD) { bestD = d; best = sv; }
+            }
+            map.push_back({ su, best });
+            mismatch += bestD;
+        }
+        return mismatch;
+    };
+    auto mapped = [&](unsigned int su) {
+        for (const auto& m : map) if (m.first == su) return m.second;
+        return su;
+    };
+
+    std::vector<unsigned int> stamp(posCount, 0);
+    std::vector<char> removed(posCount, 0);
+    std::priority_queue<Collapse> heap;
+    auto push = [&](unsigned int from, unsigned int to) {
+        if (locked[from]) return;
+        Quadric q = quadrics[from];
+        q.add(quadrics[to]);
+        double cost = q.error(positions[to]) + attributeWeight * area[from] * mapSplits(from, to);
+        heap.push(Collapse{ cost, from, to, stamp[from] });
+    };
+    // Every collapse out of p, toward each of its neighbours
+    std::vector<unsigned int> around;
+    auto neighbours = [&](unsigned int p, std::vector<unsigned int>& out) {
+        out.clear();
+        for (unsigned int t : posTris[p]) {
+            if (!triAlive[t]) continue;
+            for (int k = 0; k < 3; ++k) if (at(t, k) != p) out.push_back(at(t, k));
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    };
+    auto pushFrom = [&](unsigned int p) {
+        neighbours(p, around);
+        for (unsigned int w : around) push(p, w);
+    };
+    for (unsigned int p = 0; p < posCount; ++p) pushFrom(p);
+
+    std::vector<unsigned int> ring, nu, nv;
+    while (liveTris * 3 > targetIndexCount && !heap.empty()) {
+        Collapse c = heap.top();
+        heap.pop();
+        unsigned int u = c.from, v = c.to;
+        if (removed[u] || removed[v] || stamp[u] != c.stamp) continue;
+
+        // Still an edge, its two ends share no neighbour but the edge's own triangles (else the
+        // collapse pinches the surface), and no surviving triangle turns over when u moves onto v
+        size_t sharedTris = 0;
+        bool flips = false;
+        for (unsigned int t : posTris[u]) {
+            if (!triAlive[t]) continue;
+            if (hasPos(t, v)) { sharedTris++; continue; }
+            glm::dvec3 p[3], q[3];
+            for (int k = 0; k < 3; ++k) { p[k] = positions[at(t, k)]; q[k] = at(t, k) == u ? positions[v] : p[k]; }
+            glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::dvec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            if (glm::dot(before, after) <= 0.0) { flips = true; break; }
+        }
+        if (sharedTris == 0 || flips) continue;
+        neighbours(u, nu);
+        neighbours(v, nv);
+        size_t common = 0;
+        for (size_t i = 0, j = 0; i < nu.size() && j < nv.size();) {
+            if (nu[i] < nv[j]) ++i;
+            else if (nv[j] < nu[i]) ++j;
+            else { common++; ++i; ++j; }
+        }
+        if (common != sharedTris) continue;
+
+        // u's corners move onto v's split vertices, keeping each side of a seam with its own
+        mapSplits(u, v);
+        ring.clear();
+        for (unsigned int t : posTris[u]) {
+            if (!triAlive[t]) continue;
+            if (hasPos(t, v)) {
+                triAlive[t] = 0;
+                liveTris--;
+                continue;
+            }
+            unsigned int* tri = &tris[t * 3];
+            for (int k = 0; k < 3; ++k) {
+                if (posId[tri[k]] == u) tri[k] = mapped(tri[k]);
+                else ring.push_back(posId[tri[k]]);
+            }
+            posTris[v].push_back(t);
+        }
+        removed[u] = 1;
+        posTris[u].clear();
+        quadrics[v].add(quadrics[u]);
+        area[v] += area[u];
+
+        // Costs out of v's neighbourhood changed: requeue it with fresh stamps
+        neighbours(v, around);
+        ring.insert(ring.end(), around.begin(), around.end());
+        ring.push_back(v);
+        std::sort(ring.begin(), ring.end());
+        ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+        for (unsigned int w : ring) stamp[w]++;
+        for (unsigned int w : ring) pushFrom(w);
+    }
+
+    std::vector<unsigned int> out;
+    out.reserve(liveTris * 3);
+    for (size_t t = 0; t < triCount; ++t)
+        if (triAlive[t]) out.insert(out.end(), tris.begin() + t * 3, tris.begin() + t * 3 + 3);
+    return out;
+}
+
+std::vector<size_t> appendSimplifiedLevels(const std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                           size_t stride, const float* ratios, int ratioCount) {
+    std::vector<size_t> counts(1, indices.size());
+    const size_t baseCount = indices.size();
+    std::vector<unsigned int> previous(indices);
+    for (int i = 0; i < ratioCount; ++i) {
+        size_t target = (size_t)(baseCount * ratios[i]) / 3 * 3;
+        std::vector<unsigned int> level = simplifyMesh(vertices, previous, stride, target);
+        if (level.empty() || level.size() > previous.size() * 9 / 10) break;
+        optimizeVertexCache(level, vertices.size() / stride);
+        counts.push_back(level.size());
+        indices.insert(indices.end(), level.begin(), level.end());
+        previous.swap(level);
+    }
+    return counts;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// ---------------- Mesh optimisation ----------------
+// Post-transform vertex cache optimisation (Forsyth, "Linear-Speed Vertex Cache Optimisation").
+// Reorders triangles in place; the triangle set itself is unchanged.
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+// Renumbers vertices in first-use order of the (already cache-optimised) index buffer so vertex
+// fetch walks memory linearly. Unreferenced vertices are dropped. stride is in floats.
+void optimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices, size_t stride);
+
+// Quadric error metric simplification (Garland & Heckbert, "Surface Simplification Using Quadric
+// Error Metrics") by half-edge collapses onto existing vertices, so every level indexes the source
+// vertex buffer and only a new index buffer is returned. Vertices the OBJ split at one position
+// (UV/normal seams) are welded first, so collapses run on the real surface and seams stay closed:
+// each split vertex moves onto the target's split on its own side of the seam, or the target's
+// closest one in normal/UV, the mismatch of which is added to the collapse cost. Only open and
+// non-manifold edges are locked; collapses that would flip a triangle or pinch the surface are
+// rejected. Stops at targetIndexCount or when nothing else can collapse. stride is in floats
+// (position first, then the attributes compared across seams).
+std::vector<unsigned int> simplifyMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+                                       size_t stride, size_t targetIndexCount);
+
+// Appends levels at ratios[i] of the triangles in indices (each simplified from the one before,
+// then cache-optimised) and returns the index count of every level, the original first. Stops
+// early once simplification stalls (a level less than 10% smaller than the previous one).
+std::vector<size_t> appendSimplifiedLevels(const std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                                           size_t stride, const float* ratios, int ratioCount);
+
+// Average cache miss ratio (vertex transforms per triangle) for a FIFO cache of the given size.
+// 3.0 means no reuse at all; ~0.6-0.7 is typical for a well-optimised closed mesh.
+float averageCacheMissRatio(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = 32);
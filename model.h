@@ -4,6 +4,8 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "mesh_cache.h"
+#include "texture_loader.h"
 
 
 // ---------------- Mesh ----------------
@@ -12,7 +14,9 @@ struct Mesh {
     GLuint VBO;
     GLuint EBO;
     GLuint textureID;
-    GLsizei indexCount;
+    GLsizei indexCount;           // LOD 0
+    int lodCount;                 // simplified levels share VBO/EBO; see lods
+    MeshLod lods[kMaxMeshLods];   // index ranges in EBO, LOD 0 = full detail
 };
 
 // ---------------- Model ----------------
@@ -27,6 +31,10 @@ struct Model {
 };
 
 // ---------------- Functions ----------------
+// translate(position) * rotateX/Y/Z(rotation) * scale(scale)
+glm::mat4 modelMatrix(const Model& model);
+// Creates new GL objects on every call; shared loads go through acquireModel (asset_registry.h)
+// Also builds up to kMaxMeshLods - 1 simplified levels per mesh (kept in the mesh cache)
 Model loadModel(const char* path, const char* texturePath);
-void drawModel(const Model& model, const glm::mat4& view, const glm::mat4& projection);
-GLuint loadTexture(const char* path);
+// lod is clamped to each mesh's lodCount
+void drawModel(const Model& model, int lod = 0);
@@ -0,0 +1,445 @@
+#include "obj_parser.h"
+#include "mesh_cache.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+// ---------------- Shared helpers ----------------
+static void finishBounds(ObjMeshData& out, float maxRadiusXZ, float minY, float maxY) {
+    out.radiusXZ = (maxRadiusXZ > 0.0f ? maxRadiusXZ : 1.0f);
+    out.minY = std::isfinite(minY) ? minY : 0.0f;
+    out.maxY = std::isfinite(maxY) ? maxY : 0.0f;
+}
+
+namespace {
+// Resolved corner key (0-based, -1 when the component is absent)
+struct CornerKey { int v, vt, vn; };
+struct CornerHash {
+    size_t operator()(const CornerKey& k) const noexcept {
+        uint64_t h = (uint64_t)(uint32_t)k.v * 0x9E3779B97F4A7C15ull;
+        h ^= (uint64_t)(uint32_t)k.vt * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= (uint64_t)(uint32_t)k.vn * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return (size_t)h;
+    }
+};
+struct CornerEq { bool operator()(const CornerKey& a, const CornerKey& b) const noexcept { return a.v==b.v && a.vt==b.vt && a.vn==b.vn; } };
+
+// ---------------- Tokenizer ----------------
+// All helpers take [p, end) and never allocate; a token stops at whitespace, '/', '\r' or '\n'.
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* lineEnd(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', (size_t)(end - p));
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+inline bool parseInt(const char*& p, const char* end, int& v) {
+    if (p < end && *p == '+') ++p;
+    auto r = std::from_chars(p, end, v);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+inline bool parseFloat(const char*& p, const char* end, float& v) {
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') ++p;
+#if defined(__cpp_lib_to_chars)
+    auto r = std::from_chars(p, end, v);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+#else
+    // Toolchains without floating-point from_chars (libstdc++ < 11): plain decimal/exponent parser
+    const char* s = p;
+    bool neg = false;
+    if (s < end && *s == '-') { neg = true; ++s; }
+    double mant = 0.0; int exp10 = 0; bool any = false;
+    while (s < end && *s >= '0' && *s <= '9') { mant = mant*10.0 + (*s - '0'); ++s; any = true; }
+    if (s < end && *s == '.') {
+        ++s;
+        while (s < end && *s >= '0' && *s <= '9') { mant = mant*10.0 + (*s - '0'); --exp10; ++s; any = true; }
+    }
+    if (!any) return false;
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        int ev = 0;
+        if (e < end && *e == '+') ++e;
+        auto r = std::from_chars(e, end, ev);
+        if (r.ec == std::errc()) { exp10 += ev; s = r.ptr; }
+    }
+    v = (float)((neg ? -mant : mant) * std::pow(10.0, exp10));
+    p = s;
+    return true;
+#endif
+}
+
+// ---------------- Chunk parse ----------------
+const int kNoIndex = INT_MIN;
+
+// One face corner as written in the chunk. Positive OBJ indices are stored absolute (0-based);
+// negative ones are relative to the chunk's own attribute counts and get the chunk base added
+// at merge time (bit k of rel set => component k is chunk-relative).
+struct RawCorner { int v, vt, vn; unsigned char rel; };
+
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::vector<float> positions, normals, texcoords; // flat xyz / xyz / uv
+    std::vector<RawCorner> corners;
+    std::vector<unsigned int> faceSizes;
+    float maxRadiusXZ = 0.0f;
+    float minY = std::numeric_limits<float>::infinity();
+    float maxY = -std::numeric_limits<float>::infinity();
+};
+
+inline int encodeIndex(int raw, size_t localCount, unsigned char& rel, unsigned char bit) {
+    if (raw > 0) return raw - 1;
+    if (raw < 0) { rel |= bit; return (int)localCount + raw; }
+    return kNoIndex;
+}
+
+void parseChunk(ObjChunk& c) {
+    const char* p = c.begin;
+    const char* end = c.end;
+    while (p < end) {
+        const char* eol = lineEnd(p, end);
+        const char* q = skipBlanks(p, eol);
+        if (q < eol) {
+            if (q[0] == 'v' && q + 1 < eol && (q[1] == ' ' || q[1] == '\t')) {
+                float x = 0, y = 0, z = 0;
+                q += 1;
+                parseFloat(q, eol, x); parseFloat(q, eol, y); parseFloat(q, eol, z);
+                c.positions.insert(c.positions.end(), {x, y, z});
+                float rXZ = std::sqrt(x*x + z*z);
+                if (rXZ > c.maxRadiusXZ) c.maxRadiusXZ = rXZ;
+                if (y < c.minY) c.minY = y;
+                if (y > c.maxY) c.maxY = y;
+            } else if (q[0] == 'v' && q + 1 < eol && q[1] == 'n') {
+                float x = 0, y = 0, z = 0;
+                q += 2;
+                parseFloat(q, eol, x); parseFloat(q, eol, y); parseFloat(q, eol, z);
+                c.normals.insert(c.normals.end(), {x, y, z});
+            } else if (q[0] == 'v' && q + 1 < eol && q[1] == 't') {
+                float u = 0, v = 0;
+                q += 2;
+                parseFloat(q, eol, u); parseFloat(q, eol, v);
+                c.texcoords.insert(c.texcoords.end(), {u, v});
+            } else if (q[0] == 'f' && q + 1 < eol && (q[1] == ' ' || q[1] == '\t')) {
+                // Corners: v | v/vt | v//vn | v/vt/vn; each token is parsed exactly once
+                q += 1;
+                unsigned int count = 0;
+                while (true) {
+                    q = skipBlanks(q, eol);
+                    if (q >= eol || *q == '\r') break;
+                    int v = 0, vt = 0, vn = 0;
+                    if (!parseInt(q, eol, v)) break;
+                    if (q < eol && *q == '/') {
+                        ++q;
+                        if (q < eol && *q != '/') parseInt(q, eol, vt);
+                        if (q < eol && *q == '/') { ++q; parseInt(q, eol, vn); }
+                    }
+                    RawCorner rc;
+                    rc.rel = 0;
+                    rc.v  = encodeIndex(v,  c.positions.size() / 3, rc.rel, 1);
+                    rc.vt = encodeIndex(vt, c.texcoords.size() / 2, rc.rel, 2);
+                    rc.vn = encodeIndex(vn, c.normals.size() / 3,   rc.rel, 4);
+                    c.corners.push_back(rc);
+                    count++;
+                    // skip any trailing junk up to the next blank
+                    while (q < eol && *q != ' ' && *q != '\t' && *q != '\r') ++q;
+                }
+                if (count >= 3) c.faceSizes.push_back(count);
+                else c.corners.resize(c.corners.size() - count);
+            }
+        }
+        p = eol + 1;
+    }
+}
+} // namespace
+
+// ---------------- Fast parser ----------------
+bool parseObjBuffer(const char* data, size_t size, ObjMeshData& out, unsigned threadCount) {
+    out.vertices.clear();
+    out.indices.clear();
+    if (!data || size == 0) return false;
+
+    // Line-aligned chunks; small files stay single-threaded since thread start-up would dominate
+    const size_t kMinChunkBytes = 256 * 1024;
+    unsigned workers = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>((size_t)workers * 4, size / kMinChunkBytes));
+    std::vector<ObjChunk> chunks(chunkCount);
+    const char* end = data + size;
+    const char* cursor = data;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const char* stop = (i + 1 == chunkCount) ? end : data + (size * (i + 1)) / chunkCount;
+        if (stop < cursor) stop = cursor;
+        if (stop < end) stop = lineEnd(stop, end);                 // move to the next '\n'
+        if (stop < end) ++stop;                                    // chunk owns its newline
+        chunks[i].begin = cursor;
+        chunks[i].end = stop;
+        cursor = stop;
+    }
+
+    workers = (unsigned)std::min<size_t>(workers, chunkCount);
+    if (workers <= 1) {
+        for (auto& c : chunks) parseChunk(c);
+    } else {
+        std::atomic<size_t> next(0);
+        auto worker = [&](){
+            for (size_t i = next++; i < chunkCount; i = next++) parseChunk(chunks[i]);
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (unsigned t = 1; t < workers; ++t) pool.emplace_back(worker);
+        worker(); // the calling thread takes chunks too
+        for (auto& t : pool) t.join();
+    }
+
+    // Merge: concatenate attributes, remembering each chunk's base for relative indices
+    size_t totalP = 0, totalN = 0, totalT = 0, totalCorners = 0;
+    std::vector<size_t> baseP(chunkCount), baseN(chunkCount), baseT(chunkCount);
+    float maxRadiusXZ = 0.0f;
+    float minY = std::numeric_limits<float>::infinity();
+    float maxY = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < chunkCount; ++i) {
+        baseP[i] = totalP; baseN[i] = totalN; baseT[i] = totalT;
+        totalP += chunks[i].positions.size() / 3;
+        totalN += chunks[i].normals.size() / 3;
+        totalT += chunks[i].texcoords.size() / 2;
+        totalCorners += chunks[i].corners.size();
+        maxRadiusXZ = std::max(maxRadiusXZ, chunks[i].maxRadiusXZ);
+        minY = std::min(minY, chunks[i].minY);
+        maxY = std::max(maxY, chunks[i].maxY);
+    }
+    std::vector<float> positions, normals, texcoords;
+    positions.reserve(totalP * 3); normals.reserve(totalN * 3); texcoords.reserve(totalT * 2);
+    for (auto& c : chunks) {
+        positions.insert(positions.end(), c.positions.begin(), c.positions.end());
+        normals.insert(normals.end(), c.normals.begin(), c.normals.end());
+        texcoords.insert(texcoords.end(), c.texcoords.begin(), c.texcoords.end());
+        std::vector<float>().swap(c.positions);
+        std::vector<float>().swap(c.normals);
+        std::vector<float>().swap(c.texcoords);
+    }
+
+    std::vector<float>& vertices = out.vertices;
+    std::vector<unsigned int>& indices = out.indices;
+    vertices.reserve(totalCorners * 8);
+    indices.reserve(totalCorners * 3);
+    std::unordered_map<CornerKey, unsigned int, CornerHash, CornerEq> cornerToVertex;
+    cornerToVertex.reserve(totalCorners);
+
+    auto resolve = [](int idx, bool relative, size_t base, size_t count)->int{
+        if (idx == kNoIndex) return -1;
+        long long g = relative ? (long long)base + idx : (long long)idx;
+        return (g >= 0 && g < (long long)count) ? (int)g : -1;
+    };
+    auto emit = [&](const CornerKey& k, const glm::vec3& faceNormal)->unsigned int{
+        // Corners without an explicit normal take the per-face normal, so they cannot be shared
+        if (k.vn >= 0) {
+            auto found = cornerToVertex.find(k);
+            if (found != cornerToVertex.end()) return found->second;
+        }
+        unsigned int id = (unsigned int)(vertices.size() / 8);
+        const float* pp = k.v  >= 0 ? &positions[(size_t)k.v * 3]  : nullptr;
+        const float* nn = k.vn >= 0 ? &normals[(size_t)k.vn * 3]   : nullptr;
+        const float* tt = k.vt >= 0 ? &texcoords[(size_t)k.vt * 2] : nullptr;
+        vertices.insert(vertices.end(), {
+            pp ? pp[0] : 0.0f, pp ? pp[1] : 0.0f, pp ? pp[2] : 0.0f,
+            nn ? nn[0] : faceNormal.x, nn ? nn[1] : faceNormal.y, nn ? nn[2] : faceNormal.z,
+            tt ? tt[0] : 0.0f, tt ? tt[1] : 0.0f });
+        if (k.vn >= 0) cornerToVertex.emplace(k, id);
+        return id;
+    };
+    auto posOf = [&](int v){ return v >= 0 ? glm::vec3(positions[(size_t)v*3], positions[(size_t)v*3+1], positions[(size_t)v*3+2]) : glm::vec3(0); };
+
+    std::vector<CornerKey> face;
+    for (size_t ci = 0; ci < chunkCount; ++ci) {
+        const ObjChunk& c = chunks[ci];
+        size_t k = 0;
+        for (unsigned int n : c.faceSizes) {
+            face.clear();
+            for (unsigned int j = 0; j < n; ++j, ++k) {
+                const RawCorner& rc = c.corners[k];
+                face.push_back(CornerKey{
+                    resolve(rc.v,  (rc.rel & 1) != 0, baseP[ci], totalP),
+                    resolve(rc.vt, (rc.rel & 2) != 0, baseT[ci], totalT),
+                    resolve(rc.vn, (rc.rel & 4) != 0, baseN[ci], totalN) });
+            }
+            // Triangulate fan: (0, i-1, i)
+            for (size_t i = 2; i < face.size(); ++i) {
+                const CornerKey& a = face[0];
+                const CornerKey& b = face[i-1];
+                const CornerKey& d = face[i];
+                glm::vec3 fn(0,1,0);
+                if (a.vn < 0 || b.vn < 0 || d.vn < 0) {
+                    glm::vec3 p0 = posOf(a.v), p1 = posOf(b.v), p2 = posOf(d.v);
+                    fn = glm::normalize(glm::cross(p1 - p0, p2 - p0));
+                    if (!std::isfinite(fn.x) || !std::isfinite(fn.y) || !std::isfinite(fn.z)) fn = glm::vec3(0,1,0);
+                }
+                indices.push_back(emit(a, fn));
+                indices.push_back(emit(b, fn));
+                indices.push_back(emit(d, fn));
+            }
+        }
+    }
+
+    finishBounds(out, maxRadiusXZ, minY, maxY);
+    return !indices.empty();
+}
+
+bool parseObjFile(const std::string& path, ObjMeshData& out, unsigned threadCount) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    return parseObjBuffer(reinterpret_cast<const char*>(file.data), file.size, out, threadCount);
+}
+
+// ---------------- Reference parser ----------------
+// The original line-by-line loader (getline + istringstream + substr/stoi per corner). Only used
+// by tools/obj_bench.cpp to time and cross-check the fast path.
+bool parseObjFileReference(const std::string& path, ObjMeshData& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::vector<float>& vertices = out.vertices;
+    std::vector<unsigned int>& indices = out.indices;
+    vertices.clear(); indices.clear();
+    float maxRadiusXZ = 0.0f;
+    float minY = std::numeric_limits<float>::infinity();
+    float maxY = -std::numeric_limits<float>::infinity();
+
+    std::vector<glm::vec3> temp_positions;
+    std::vector<glm::vec3> temp_normals;
+    std::vector<glm::vec2> temp_texcoords;
+
+    // Shared-vertex dedup: one output vertex per distinct resolved v/vt/vn triple (1-based here)
+    std::unordered_map<CornerKey, unsigned int, CornerHash, CornerEq> cornerToVertex;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream ss(line);
+        std::string prefix;
+        ss >> prefix;
+        if (prefix == "v") {
+            glm::vec3 pos; ss >> pos.x >> pos.y >> pos.z;
+            temp_positions.push_back(pos);
+            float rXZ = std::sqrt(pos.x*pos.x + pos.z*pos.z);
+            if (rXZ > maxRadiusXZ) maxRadiusXZ = rXZ;
+            if (pos.y < minY) minY = pos.y;
+            if (pos.y > maxY) maxY = pos.y;
+        } else if (prefix == "vn") {
+            glm::vec3 norm; ss >> norm.x >> norm.y >> norm.z;
+            temp_normals.push_back(norm);
+        } else if (prefix == "vt") {
+            glm::vec2 uv; ss >> uv.x >> uv.y;
+            temp_texcoords.push_back(uv);
+        } else if (prefix == "f") {
+            // Collect face tokens, handle v/vt/vn | v//vn | v/vt
+            std::vector<std::string> tokens;
+            std::string tok;
+            while (ss >> tok) tokens.push_back(tok);
+            if (tokens.size() < 3) continue;
+
+            auto parseIdx = [&](const std::string& t, int& v, int& vt, int& vn){
+                v = vt = vn = -1;
+                size_t first = t.find('/');
+                if (first == std::string::npos) {
+                    v = std::stoi(t);
+                    return;
+                }
+                size_t second = t.find('/', first+1);
+                std::string sv = t.substr(0, first);
+                std::string svt = (second==std::string::npos)? t.substr(first+1) : t.substr(first+1, second-first-1);
+                std::string svn = (second==std::string::npos)? std::string("") : t.substr(second+1);
+                if (!sv.empty()) v = std::stoi(sv);
+                if (!svt.empty()) vt = std::stoi(svt);
+                if (!svn.empty()) vn = std::stoi(svn);
+            };
+
+            auto resolveIndex = [](int idx, int size)->int{
+                if (idx > 0) return idx;          // 1-based positive
+                if (idx < 0) return size + idx + 1; // -1 means last
+                return 0;
+            };
+
+            auto addVertex = [&](int vIdx, int tIdx, int nIdx, const glm::vec3& overrideNormal){
+                glm::vec3 pos(0);
+                glm::vec3 norm(0,1,0);
+                glm::vec2 uv(0);
+                vIdx = resolveIndex(vIdx, (int)temp_positions.size());
+                tIdx = resolveIndex(tIdx, (int)temp_texcoords.size());
+                nIdx = resolveIndex(nIdx, (int)temp_normals.size());
+
+                bool hasNormal = nIdx>0 && nIdx <= (int)temp_normals.size();
+                // Corners without an explicit normal take the per-face normal, so they cannot be shared
+                if (hasNormal) {
+                    auto found = cornerToVertex.find(CornerKey{vIdx, tIdx, nIdx});
+                    if (found != cornerToVertex.end()) { indices.push_back(found->second); return; }
+                }
+
+                if (vIdx>0 && vIdx <= (int)temp_positions.size()) pos = temp_positions[vIdx-1];
+                if (hasNormal) norm = temp_normals[nIdx-1];
+                else if (overrideNormal != glm::vec3(0)) norm = overrideNormal;
+                if (tIdx>0 && tIdx <= (int)temp_texcoords.size()) uv = temp_texcoords[tIdx-1];
+
+                vertices.push_back(pos.x);
+                vertices.push_back(pos.y);
+                vertices.push_back(pos.z);
+
+                vertices.push_back(norm.x);
+                vertices.push_back(norm.y);
+                vertices.push_back(norm.z);
+
+                vertices.push_back(uv.x);
+                vertices.push_back(uv.y);
+
+                unsigned int newIndex = (unsigned int)(vertices.size()/8 - 1);
+                if (hasNormal) cornerToVertex.emplace(CornerKey{vIdx, tIdx, nIdx}, newIndex);
+                indices.push_back(newIndex);
+            };
+
+            // Triangulate fan: (0, i-1, i)
+            auto getPos = [&](int idx){ return (idx>0 && idx <= (int)temp_positions.size()) ? temp_positions[idx-1] : glm::vec3(0); };
+
+            for (size_t i = 2; i < tokens.size(); ++i) {
+                int v0=-1, vt0=-1, vn0=-1;
+                int v1=-1, vt1=-1, vn1=-1;
+                int v2=-1, vt2=-1, vn2=-1;
+                parseIdx(tokens[0], v0, vt0, vn0);
+                parseIdx(tokens[i-1], v1, vt1, vn1);
+                parseIdx(tokens[i], v2, vt2, vn2);
+
+                // Compute face normal if needed
+                glm::vec3 n(0);
+                if (vn0<0 || vn1<0 || vn2<0) {
+                    glm::vec3 p0 = getPos(v0), p1 = getPos(v1), p2 = getPos(v2);
+                    glm::vec3 e1 = p1 - p0;
+                    glm::vec3 e2 = p2 - p0;
+                    n = glm::normalize(glm::cross(e1, e2));
+                    if (!std::isfinite(n.x) || !std::isfinite(n.y) || !std::isfinite(n.z)) n = glm::vec3(0,1,0);
+                }
+
+                addVertex(v0, vt0, vn0, n);
+                addVertex(v1, vt1, vn1, n);
+                addVertex(v2, vt2, vn2, n);
+            }
+        }
+    }
+
+    finishBounds(out, maxRadiusXZ, minY, maxY);
+    return !indices.empty();
+}
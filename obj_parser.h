@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ---------------- OBJ parsing ----------------
+// CPU-side result of parsing an OBJ: interleaved pos(3), normal(3), uv(2) vertices with one
+// shared vertex per distinct v/vt/vn triple, a fan-triangulated index buffer, and the bounds
+// that Model keeps for footprint scaling. No GL calls happen here.
+struct ObjMeshData {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    float radiusXZ = 1.0f; // bounding radius in XZ
+    float minY = 0.0f;     // lowest vertex Y
+    float maxY = 0.0f;     // highest vertex Y
+};
+
+// Zero-copy parser over an in-memory buffer (typically a mapped file). Large buffers are split
+// into line-aligned chunks parsed on worker threads; threadCount 0 picks hardware_concurrency.
+bool parseObjBuffer(const char* data, size_t size, ObjMeshData& out, unsigned threadCount = 0);
+// Maps the file and runs parseObjBuffer on it.
+bool parseObjFile(const std::string& path, ObjMeshData& out, unsigned threadCount = 0);
+
+// Original getline/istringstream parser, kept as the reference for benchmarks and validation.
+bool parseObjFileReference(const std::string& path, ObjMeshData& out);
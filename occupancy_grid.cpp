@@ -0,0 +1,93 @@
+#include "occupancy_grid.h"
+#include "bresenham.h"
+#include <algorithm>
+#include <cmath>
+
+// ---------------- Occupancy grid ----------------
+// Sample index i covers design cell i / sub; its centre is ((i + 0.5) / sub - 0.5) cells from
+// that cell's world position. sampleCoord is the inverse (continuous, in samples).
+static inline float sampleCoord(float world, float half, float cellWorld, int sub) {
+    return ((world + half) / cellWorld + 0.5f) * (float)sub;
+}
+
+void OccupancyGrid::reset(int designW, int designH, int subdivisions, float half) {
+    gridW = std::max(1, designW);
+    gridH = std::max(1, designH);
+    sub = std::max(1, subdivisions);
+    worldHalf = half;
+    cellWorld = (2.0f * half) / (float)gridW;
+    w = (gridW + 1) * sub;
+    h = (gridH + 1) * sub;
+    bits.assign((size_t)w * h, 0);
+}
+
+glm::vec2 OccupancyGrid::sampleWorld(int i, int j) const {
+    float cellZ = (2.0f * worldHalf) / (float)gridH;
+    return glm::vec2(((i + 0.5f) / sub - 0.5f) * cellWorld - worldHalf,
+                     ((j + 0.5f) / sub - 0.5f) * cellZ - worldHalf);
+}
+
+void OccupancyGrid::fillDisk(const glm::vec2& center, float radius, uint8_t b) {
+    if (radius <= 0.0f || bits.empty()) return;
+    float cellZ = (2.0f * worldHalf) / (float)gridH;
+    int i0 = std::max(0, (int)std::floor(sampleCoord(center.x - radius, worldHalf, cellWorld, sub)));
+    int i1 = std::min(w - 1, (int)std::ceil(sampleCoord(center.x + radius, worldHalf, cellWorld, sub)));
+    int j0 = std::max(0, (int)std::floor(sampleCoord(center.y - radius, worldHalf, cellZ, sub)));
+    int j1 = std::min(h - 1, (int)std::ceil(sampleCoord(center.y + radius, worldHalf, cellZ, sub)));
+    float r2 = radius * radius;
+    for (int j = j0; j <= j1; ++j) {
+        for (int i = i0; i <= i1; ++i) {
+            glm::vec2 d = sampleWorld(i, j) - center;
+            if (d.x*d.x + d.y*d.y <= r2) bits[(size_t)j * w + i] |= b;
+        }
+    }
+}
+
+void OccupancyGrid::fillTriangle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, uint8_t bit) {
+    if (bits.empty()) return;
+    float cellZ = (2.0f * worldHalf) / (float)gridH;
+    float minX = std::min({a.x, b.x, c.x}), maxX = std::max({a.x, b.x, c.x});
+    float minZ = std::min({a.y, b.y, c.y}), maxZ = std::max({a.y, b.y, c.y});
+    int i0 = std::max(0, (int)std::floor(sampleCoord(minX, worldHalf, cellWorld, sub)));
+    int i1 = std::min(w - 1, (int)std::ceil(sampleCoord(maxX, worldHalf, cellWorld, sub)));
+    int j0 = std::max(0, (int)std::floor(sampleCoord(minZ, worldHalf, cellZ, sub)));
+    int j1 = std::min(h - 1, (int)std::ceil(sampleCoord(maxZ, worldHalf, cellZ, sub)));
+    // Same edge-sign test the per-query pointInTri2 lambdas used (edges count as inside)
+    auto sign = [](const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3) {
+        return (p1.x - p3.x)*(p2.y - p3.y) - (p2.x - p3.x)*(p1.y - p3.y);
+    };
+    for (int j = j0; j <= j1; ++j) {
+        for (int i = i0; i <= i1; ++i) {
+            glm::vec2 p = sampleWorld(i, j);
+            float d1 = sign(p, a, b), d2 = sign(p, b, c), d3 = sign(p, c, a);
+            bool hasNeg = (d1<0) || (d2<0) || (d3<0);
+            bool hasPos = (d1>0) || (d2>0) || (d3>0);
+            if (!(hasNeg && hasPos)) bits[(size_t)j * w + i] |= bit;
+        }
+    }
+}
+
+void OccupancyGrid::markCell(int gx, int gy, uint8_t b) {
+    if (gx < 0 || gy < 0 || gx > gridW || gy > gridH) return;
+    for (int j = gy * sub; j < (gy + 1) * sub; ++j)
+        for (int i = gx * sub; i < (gx + 1) * sub; ++i)
+            bits[(size_t)j * w + i] |= b;
+}
+
+void OccupancyGrid::markLine(const glm::ivec2& a, const glm::ivec2& b, uint8_t bit) {
+    rasterLine(a.x, a.y, b.x, b.y, [&](int x, int y) { markCell(x, y, bit); });
+}
+
+uint8_t OccupancyGrid::atWorld(float wx, float wz) const {
+    if (bits.empty()) return 0;
+    float cellZ = (2.0f * worldHalf) / (float)gridH;
+    int i = (int)std::floor(sampleCoord(wx, worldHalf, cellWorld, sub));
+    int j = (int)std::floor(sampleCoord(wz, worldHalf, cellZ, sub));
+    if (i < 0 || j < 0 || i >= w || j >= h) return 0;
+    return bits[(size_t)j * w + i];
+}
+
+uint8_t OccupancyGrid::atCell(int gx, int gy) const {
+    if (bits.empty() || gx < 0 || gy < 0 || gx > gridW || gy > gridH) return 0;
+    return bits[(size_t)(gy * sub + sub / 2) * w + (gx * sub + sub / 2)];
+}
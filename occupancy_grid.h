@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ---------------- Occupancy grid ----------------
+// What a sample lies in. Layers are independent; a sample can carry several bits.
+enum OccupancyBits : uint8_t {
+    OCC_HEDGE_DISK    = 1 << 0, // inside the (scaled) outer hedge disk
+    OCC_HEDGE_WEDGE   = 1 << 1, // inside a hedge wedge triangle footprint
+    OCC_FOUNTAIN_DISK = 1 << 2, // inside the fountain radius (2D overlay radius mapped to world)
+    OCC_PATH          = 1 << 3  // on a Bresenham layout path cell
+};
+// Where trees may not be planted or placed
+static const uint8_t OCC_FORBIDDEN = OCC_HEDGE_DISK | OCC_HEDGE_WEDGE;
+
+// Point-sampled rasterization of the design grid over the world square [-worldHalf, worldHalf]^2.
+// Each design cell (gridW x gridH, plus the closing row/column at +worldHalf) holds sub x sub
+// samples. Design cell (gx, gy) is centred on the world position gridToWorld(gx, gy); with an odd
+// `sub` its centre sample sits exactly there, so per-cell queries reproduce the point tests
+// they replace. All queries are a single lookup; positions outside the grid report 0.
+struct OccupancyGrid {
+    int gridW = 0, gridH = 0;   // design grid cells
+    int sub = 1;                // samples per design cell along each axis
+    int w = 0, h = 0;           // samples along X / Z
+    float worldHalf = 10.0f;
+    float cellWorld = 0.0f;     // world size of one design cell
+    std::vector<uint8_t> bits;  // w*h samples, row-major in Z
+
+    // Resize and clear every layer
+    void reset(int designW, int designH, int subdivisions, float half = 10.0f);
+
+    // Rasterizers: set `b` on every sample whose centre lies inside the shape
+    void fillDisk(const glm::vec2& center, float radius, uint8_t b);
+    void fillTriangle(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c, uint8_t bit);
+    void markCell(int gx, int gy, uint8_t b);                        // every sample of one design cell
+    void markLine(const glm::ivec2& a, const glm::ivec2& b, uint8_t bit); // design-grid Bresenham line
+
+    uint8_t atWorld(float wx, float wz) const;
+    uint8_t atCell(int gx, int gy) const; // centre sample of design cell (gx, gy)
+
+    // World position of sample (i, j)
+    glm::vec2 sampleWorld(int i, int j) const;
+};
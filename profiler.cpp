@@ -0,0 +1,158 @@
+#include "profiler.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+int profileDrawCalls = 0;
+int profileUniformUploads = 0;
+int profileStateChanges = 0;
+
+namespace {
+typedef std::chrono::steady_clock Clock;
+
+// Two query sets: frame N records into set N % 2 and reads it back when frame N + 2 reuses it.
+// A set whose results are still not available by then is dropped instead of waited on.
+const int kQuerySets = 2;
+const size_t kProfileHistory = 600; // ~10 s at 60 fps
+
+const char* kScopeNames[PROF_SCOPE_COUNT] = {
+    "ground", "paths", "fountain", "trees", "hedges", "ring", "fireflies", "overlay", "static_batch",
+    "depth_prepass", "opaque", "alpha_test", "background", "chunk_stream", "chunks",
+    "shadow_cascade0", "shadow_cascade1", "shadow_cascade2"
+};
+
+struct PendingFrame {
+    ProfileFrame frame;
+    bool pending = false; // recorded, GPU times not read back yet
+};
+
+bool timerQueries = false;
+GLuint queries[kQuerySets][PROF_SCOPE_COUNT];
+PendingFrame sets[kQuerySets];
+int currentSet = 0;
+unsigned long long frameCounter = 0;
+Clock::time_point frameStart;
+Clock::time_point scopeStart[PROF_SCOPE_COUNT];
+int scopeDrawsAtBegin[PROF_SCOPE_COUNT];
+int scopeUniformsAtBegin[PROF_SCOPE_COUNT];
+int scopeStatesAtBegin[PROF_SCOPE_COUNT];
+
+ProfileFrame latest;
+std::vector<ProfileFrame> history; // ring buffer once full; historyHead is the oldest entry
+size_t historyHead = 0;
+
+double msSince(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+void pushHistory(const ProfileFrame& f) {
+    latest = f;
+    if (history.size() < kProfileHistory) {
+        history.push_back(f);
+    } else {
+        history[historyHead] = f;
+        historyHead = (historyHead + 1) % kProfileHistory;
+    }
+}
+
+// Reads the set's GPU times into its frame and retires it; false if a result is not in yet
+bool resolveSet(int set) {
+    PendingFrame& p = sets[set];
+    if (!p.pending) return true;
+    if (timerQueries) {
+        for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+            if (!p.frame.scopes[s].ran) continue;
+            GLint available = 0;
+            glGetQueryObjectiv(queries[set][s], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) return false;
+        }
+        for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+            if (!p.frame.scopes[s].ran) continue;
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[set][s], GL_QUERY_RESULT, &ns);
+            p.frame.scopes[s].gpuMs = (double)ns / 1.0e6;
+        }
+    }
+    pushHistory(p.frame);
+    p.pending = false;
+    return true;
+}
+} // namespace
+
+const char* profileScopeName(ProfileScope s) {
+    return (s >= 0 && s < PROF_SCOPE_COUNT) ? kScopeNames[s] : "?";
+}
+
+void profilerInit() {
+    timerQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (timerQueries) glGenQueries(kQuerySets * PROF_SCOPE_COUNT, &queries[0][0]);
+    std::cout << "[Info] Profiler: GPU timer queries " << (timerQueries ? "enabled" : "unavailable, CPU times only") << "\n";
+}
+
+void profilerShutdown() {
+    if (timerQueries) glDeleteQueries(kQuerySets * PROF_SCOPE_COUNT, &queries[0][0]);
+    timerQueries = false;
+}
+
+void profilerBeginFrame() {
+    currentSet = (int)(frameCounter % kQuerySets);
+    PendingFrame& p = sets[currentSet];
+    if (!resolveSet(currentSet)) p.pending = false; // GPU is more than a frame behind: drop it
+    p.frame = ProfileFrame();
+    p.frame.index = frameCounter;
+    p.pending = true;
+    frameStart = Clock::now();
+}
+
+void profilerEndFrame() {
+    sets[currentSet].frame.frameCpuMs = msSince(frameStart);
+    frameCounter++;
+}
+
+// Each scope is expected at most once per frame (its query object is reused otherwise)
+void profilerBegin(ProfileScope s) {
+    scopeStart[s] = Clock::now();
+    scopeDrawsAtBegin[s] = profileDrawCalls;
+    scopeUniformsAtBegin[s] = profileUniformUploads;
+    scopeStatesAtBegin[s] = profileStateChanges;
+    if (timerQueries) glBeginQuery(GL_TIME_ELAPSED, queries[currentSet][s]);
+}
+
+void profilerEnd(ProfileScope s) {
+    if (timerQueries) glEndQuery(GL_TIME_ELAPSED);
+    ProfileSample& out = sets[currentSet].frame.scopes[s];
+    out.cpuMs += msSince(scopeStart[s]);
+    out.drawCalls += profileDrawCalls - scopeDrawsAtBegin[s];
+    out.uniformUploads += profileUniformUploads - scopeUniformsAtBegin[s];
+    out.stateChanges += profileStateChanges - scopeStatesAtBegin[s];
+    out.ran = true;
+}
+
+const ProfileFrame& profilerLatestFrame() {
+    return latest;
+}
+
+int profilerHistorySize() {
+    return (int)history.size();
+}
+
+bool profilerDumpCSV(const char* path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "frame,frame_cpu_ms";
+    for (int s = 0; s < PROF_SCOPE_COUNT; ++s) {
+        const char* n = kScopeNames[s];
+        out << ',' << n << "_cpu_ms," << n << "_gpu_ms," << n << "_draws," << n << "_uniforms," << n << "_states";
+    }
+    out << '\n';
+    for (size_t i = 0; i < history.size(); ++i) {
+        const ProfileFrame& f = history[(historyHead + i) % history.size()];
+        out << f.index << ',' << f.frameCpuMs;
+        for (const ProfileSample& sm : f.scopes) {
+            out << ',' << sm.cpuMs << ',' << sm.gpuMs << ',' << sm.drawCalls << ',' << sm.uniformUploads << ',' << sm.stateChanges;
+        }
+        out << '\n';
+    }
+    return (bool)out;
+}
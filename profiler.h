@@ -0,0 +1,67 @@
+#pragma once
+#include <GL/glew.h>
+
+// ---------------- Frame profiler ----------------
+// Fixed set of named scopes around the main render loop. Each scope records CPU time
+// (steady_clock), GPU time (GL_TIME_ELAPSED) and the draw calls / uniform uploads / GL state changes
+// issued inside it.
+// Scopes must not nest: only one GL_TIME_ELAPSED query can be active at a time.
+enum ProfileScope {
+    PROF_GROUND, PROF_PATHS, PROF_FOUNTAIN, PROF_TREES, PROF_HEDGES, PROF_RING, PROF_FIREFLIES,
+    PROF_OVERLAY,
+    PROF_STATIC_BATCH, // ground, paths, fountain OBJ, hedges and ring when batched (scene_batch.h)
+    // Render queue passes (render_queue.h); replace the per-object 3D scopes when sorted
+    PROF_DEPTH_PREPASS, PROF_OPAQUE, PROF_ALPHA_TEST, PROF_BACKGROUND,
+    // Chunked world (world_chunks.h): generation/upload/eviction, and the chunk draws when unsorted
+    PROF_CHUNK_STREAM, PROF_CHUNKS,
+    // Shadow map cascades (shadow_map.h), near to far; throttled cascades only run on some frames
+    PROF_SHADOW_CASCADE0, PROF_SHADOW_CASCADE1, PROF_SHADOW_CASCADE2,
+    PROF_SCOPE_COUNT
+};
+const char* profileScopeName(ProfileScope s);
+
+struct ProfileSample {
+    double cpuMs = 0.0;
+    double gpuMs = 0.0;     // 0 when the scope did not run or timer queries are unavailable
+    int drawCalls = 0;
+    int uniformUploads = 0;
+    int stateChanges = 0;   // binds and enables that got past the state cache (gl_state.h)
+    bool ran = false;
+};
+struct ProfileFrame {
+    unsigned long long index = 0;
+    double frameCpuMs = 0.0; // profilerBeginFrame to profilerEndFrame
+    ProfileSample scopes[PROF_SCOPE_COUNT];
+};
+
+// Counters bumped at draw sites, by ShaderProgram's setters (uploads the shadow copy let through)
+// and by the uniform block writes / material binds (uniform_blocks.h)
+extern int profileDrawCalls;
+extern int profileUniformUploads;
+extern int profileStateChanges;
+inline void profileCountDraw() { profileDrawCalls++; }
+
+// Needs a current GL context. Timer queries are skipped (GPU times stay 0) without GL 3.3 /
+// ARB_timer_query.
+void profilerInit();
+void profilerShutdown();
+void profilerBeginFrame();
+void profilerEndFrame();
+void profilerBegin(ProfileScope s);
+void profilerEnd(ProfileScope s);
+
+// Newest frame whose GPU results have been read back (a couple of frames behind the CPU: query
+// sets are double-buffered and only read once available, so readback never stalls)
+const ProfileFrame& profilerLatestFrame();
+// Writes the retained history (last kProfileHistory resolved frames), one row per frame
+bool profilerDumpCSV(const char* path);
+int profilerHistorySize();
+
+// RAII helper for a scope that ends with its C++ block
+struct ProfileScopeGuard {
+    ProfileScope scope;
+    explicit ProfileScopeGuard(ProfileScope s) : scope(s) { profilerBegin(s); }
+    ~ProfileScopeGuard() { profilerEnd(scope); }
+    ProfileScopeGuard(const ProfileScopeGuard&) = delete;
+    ProfileScopeGuard& operator=(const ProfileScopeGuard&) = delete;
+};
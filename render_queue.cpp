@@ -0,0 +1,55 @@
+#include "render_queue.h"
+#include "gl_state.h"
+#include <algorithm>
+#include <GL/glew.h>
+
+namespace {
+const ProfileScope kBucketScopes[] = { PROF_OPAQUE, PROF_ALPHA_TEST, PROF_BACKGROUND };
+} // namespace
+
+void RenderQueue::add(RenderFn draw, RenderBucket bucket, ProfileScope scope, const glm::vec3& center,
+                      int index, const glm::mat4& model) {
+    glm::vec3 d = center - camera;
+    items.push_back(RenderItem{ draw, bucket, scope, glm::dot(d, d), index, model });
+}
+
+void RenderQueue::execute() {
+    if (items.empty()) return;
+    if (frontToBack) {
+        std::stable_sort(items.begin(), items.end(), [](const RenderItem& a, const RenderItem& b) {
+            if (a.bucket != b.bucket) return a.bucket < b.bucket;
+            return a.distance2 < b.distance2;
+        });
+    }
+
+    if (depthPrepass) {
+        profilerBegin(PROF_DEPTH_PREPASS);
+        setColorWrite(false);
+        for (const RenderItem& item : items) item.draw(item);
+        setColorWrite(true);
+        setDepthWrite(false);
+        setDepthFunc(GL_LEQUAL);
+        profilerEnd(PROF_DEPTH_PREPASS);
+    }
+
+    // One profiler scope per run of items sharing a scope; runs never repeat a scope because
+    // buckets are contiguous when sorted and each object is submitted in one piece otherwise
+    bool open = false;
+    ProfileScope current = PROF_SCOPE_COUNT;
+    for (const RenderItem& item : items) {
+        ProfileScope scope = frontToBack ? kBucketScopes[item.bucket] : item.scope;
+        if (!open || scope != current) {
+            if (open) profilerEnd(current);
+            profilerBegin(scope);
+            current = scope;
+            open = true;
+        }
+        item.draw(item);
+    }
+    if (open) profilerEnd(current);
+
+    if (depthPrepass) {
+        setDepthWrite(true);
+        setDepthFunc(GL_LESS);
+    }
+}
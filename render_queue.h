@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "profiler.h"
+
+// ---------------- Render queue ----------------
+// The opaque part of the 3D pass records one item per draw (or per instanced / batched group)
+// instead of drawing as it goes; execute() then orders the items so early-Z rejects hidden
+// fragments before they are shaded:
+//   1. BUCKET_OPAQUE      front-to-back by camera distance; these programs have no discard
+//   2. BUCKET_ALPHA_TEST  front-to-back; fragment_shader.glsl +ALPHA_TEST (leaves), which gives up
+//                         early depth writes, so it goes after the occluders
+//   3. BUCKET_BACKGROUND  ground, paths and ring: they lie under everything else, so drawing them
+//                         last lets the depth test skip every pixel the scene already covers
+// With frontToBack off, items run in submission order (ground first, as the pass used to draw).
+// With depthPrepass on, every item is drawn once with colour writes off, then again with
+// GL_LEQUAL and depth writes off, so each visible pixel is shaded exactly once. Both passes use
+// the same programs, so depth values match without `invariant`.
+// Culling, buffer updates and uniforms that do not change between the passes belong in the
+// recording code: item callbacks must only bind and draw.
+enum RenderBucket { BUCKET_OPAQUE, BUCKET_ALPHA_TEST, BUCKET_BACKGROUND };
+
+struct RenderItem;
+typedef void (*RenderFn)(const RenderItem& item);
+
+struct RenderItem {
+    RenderFn draw;
+    RenderBucket bucket;
+    ProfileScope scope;  // per-object scope, used when running in submission order
+    float distance2;     // squared camera distance to the item's centre
+    int index;           // callback-specific (e.g. tree index)
+    glm::mat4 model;     // callback-specific
+};
+
+struct RenderQueue {
+    bool frontToBack = true;
+    bool depthPrepass = false;
+    std::vector<RenderItem> items;
+
+    void begin(const glm::vec3& cameraPos) { items.clear(); camera = cameraPos; }
+    void add(RenderFn draw, RenderBucket bucket, ProfileScope scope, const glm::vec3& center,
+             int index = 0, const glm::mat4& model = glm::mat4(1.0f));
+    // Sorts (frontToBack) and draws everything recorded since begin(). Profiled per bucket when
+    // sorted (objects interleave, and a profiler scope runs at most once per frame), per item
+    // scope otherwise.
+    void execute();
+
+private:
+    glm::vec3 camera = glm::vec3(0.0f);
+};
@@ -0,0 +1,49 @@
+#version 330 core
+
+// Fountain ring (annulus). The mesh is a unit-radius topology: aPos.xz is the sample direction
+// and aTexCoord.x selects the inner (0) or outer (1) edge, so radius changes are uniform updates.
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
+// Bound per material (uniform_blocks.h MaterialUniforms)
+layout(std140) uniform MaterialBlock {
+    vec3 objectColor;
+    int solidMode;    // 0 = textured, 1 = solid objectColor
+    int textureLayer; // scene texture array layer, -1 = texture_diffuse1
+};
+
+uniform vec3 ringParams; // inner radius, outer radius, UV tiles per world unit
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+flat out int MaterialLayer;
+
+void main()
+{
+    float r = mix(ringParams.x, ringParams.y, aTexCoord.x);
+    FragPos = vec3(aPos.x * r, aPos.y, aPos.z * r);
+    Normal = aNormal;
+    // World-aligned tiling: one path.png tile per design-grid cell
+    TexCoord = (FragPos.xz + 10.0) * ringParams.z;
+
+    MaterialLayer = textureLayer;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,183 @@
+#include "scene_batch.h"
+#include "gl_state.h"
+#include "profiler.h"
+#include "uniform_blocks.h"
+#include "vertex_format.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+
+namespace {
+
+// Orphan and refill a per-frame buffer; storage grows by 1.5x when the data no longer fits
+void uploadStream(GLenum target, GLuint buffer, GLsizeiptr& cap, const void* data, GLsizeiptr bytes) {
+    glBindBuffer(target, buffer);
+    if (bytes > cap) cap = std::max(bytes, cap + cap / 2);
+    glBufferData(target, cap, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, bytes, data);
+}
+
+void growArena(GLuint buffer, GLsizeiptr& cap, GLsizeiptr bytes) {
+    if (bytes <= cap) return;
+    cap = std::max(bytes, cap + cap / 2);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, cap, nullptr, GL_STATIC_DRAW);
+}
+} // namespace
+
+bool multiDrawIndirectSupported() {
+    bool caps = GLEW_VERSION_4_3 ||
+                (GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_base_instance);
+    if (!caps) return false;
+    // GL 4.3 only guarantees SSBOs in compute/fragment shaders; scene_batch.vert reads one
+    GLint vertexBlocks = 0;
+    glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexBlocks);
+    return vertexBlocks > 0;
+}
+
+void SceneBatch::init(GLuint multiDrawProgram) {
+    GLint linked = 0;
+    if (multiDrawProgram) glGetProgramiv(multiDrawProgram, GL_LINK_STATUS, &linked);
+    multiDraw = multiDrawProgram && linked && multiDrawIndirectSupported();
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    bindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    applyVertexFormat(); // sources are all uploaded in meshVertexFormat
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    if (multiDraw) {
+        glGenBuffers(1, &indirectBuffer);
+        glGenBuffers(1, &drawDataBuffer);
+        glGenBuffers(1, &drawIdVBO);
+        // aDrawId: one instance per command, fetched at baseInstance = draw index
+        glBindBuffer(GL_ARRAY_BUFFER, drawIdVBO);
+        glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+        glEnableVertexAttribArray(4);
+        glVertexAttribDivisor(4, 1);
+    }
+    bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    std::cout << "[Info] Static scene batch: "
+              << (multiDraw ? "glMultiDrawElementsIndirect (one call)" : "glDrawElementsBaseVertex loop (no GL 4.3 multi-draw indirect)")
+              << "\n";
+}
+
+void SceneBatch::destroy() {
+    GLuint buffers[5] = { vbo, ebo, indirectBuffer, drawDataBuffer, drawIdVBO };
+    glDeleteBuffers(5, buffers);
+    if (vao) deleteVertexArrays(1, &vao);
+    vao = vbo = ebo = indirectBuffer = drawDataBuffer = drawIdVBO = 0;
+    vboCap = eboCap = indirectCap = drawDataCap = 0;
+    drawIdCount = 0;
+    slots.clear();
+    clearDraws();
+}
+
+void SceneBatch::pack(const std::vector<BatchSource>& sources) {
+    const GLsizei kVertexStride = meshVertexFormat.stride();
+    // Sizes first, so each arena buffer is (re)allocated at most once
+    std::vector<GLsizeiptr> vertexBytes(sources.size(), 0);
+    GLsizeiptr totalVertexBytes = 0, totalIndexBytes = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const BatchSource& src = sources[i];
+        if (!src.vbo || !src.ebo || src.indexCount <= 0) continue;
+        totalIndexBytes += (GLsizeiptr)src.indexCount * sizeof(GLuint);
+        if (src.vertexSlot >= 0) continue;
+        GLint size = 0;
+        glBindBuffer(GL_COPY_READ_BUFFER, src.vbo);
+        glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+        vertexBytes[i] = size - size % kVertexStride;
+        totalVertexBytes += vertexBytes[i];
+    }
+    growArena(vbo, vboCap, totalVertexBytes);
+    growArena(ebo, eboCap, totalIndexBytes);
+
+    slots.assign(sources.size(), Slot{ 0, 0, 0 });
+    GLsizeiptr vertexOffset = 0, indexOffset = 0;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const BatchSource& src = sources[i];
+        bool shared = src.vertexSlot >= 0 && src.vertexSlot < (int)i && slots[src.vertexSlot].indexCount > 0;
+        if (vertexBytes[i] == 0 && !shared) continue;
+        GLint baseVertex = shared ? slots[src.vertexSlot].baseVertex : (GLint)(vertexOffset / kVertexStride);
+        if (!shared) {
+            glBindBuffer(GL_COPY_READ_BUFFER, src.vbo);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, vertexOffset, vertexBytes[i]);
+            vertexOffset += vertexBytes[i];
+        }
+        GLsizeiptr indexBytes = (GLsizeiptr)src.indexCount * sizeof(GLuint);
+        glBindBuffer(GL_COPY_READ_BUFFER, src.ebo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)src.firstIndex * sizeof(GLuint),
+                            indexOffset, indexBytes);
+        // Source indices stay local to their mesh; baseVertex rebases them
+        slots[i] = Slot{ baseVertex, (GLuint)(indexOffset / sizeof(GLuint)), src.indexCount };
+        indexOffset += indexBytes;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void SceneBatch::addDraw(int slot, const glm::mat4& model, int textureLayer) {
+    if (slot < 0 || slot >= (int)slots.size() || slots[slot].indexCount <= 0) return;
+    const Slot& s = slots[slot];
+    commands.push_back(DrawElementsIndirectCommand{ (GLuint)s.indexCount, 1, s.firstIndex, s.baseVertex, (GLuint)commands.size() });
+    draws.push_back(BatchDrawData{ model, glm::vec4((float)textureLayer, 0.0f, 0.0f, 0.0f) });
+}
+
+void SceneBatch::addRingDraw(int slot, float innerR, float outerR, float uvTiles, int textureLayer) {
+    if (slot < 0 || slot >= (int)slots.size() || slots[slot].indexCount <= 0) return;
+    addDraw(slot, glm::mat4(1.0f), textureLayer);
+    draws.back().material = glm::vec4((float)textureLayer, innerR, outerR, uvTiles);
+}
+
+void SceneBatch::submit(ShaderProgram& multiDrawShader, ShaderProgram& meshShader, ShaderProgram& ringShader) {
+    if (commands.empty()) return;
+    GLsizei count = (GLsizei)commands.size();
+
+    if (multiDraw) {
+        if (count > drawIdCount) {
+            drawIdCount = std::max(count, drawIdCount * 2);
+            std::vector<GLuint> ids((size_t)drawIdCount);
+            std::iota(ids.begin(), ids.end(), 0u);
+            glBindBuffer(GL_ARRAY_BUFFER, drawIdVBO);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(ids.size() * sizeof(GLuint)), ids.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        if (uploaded) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        } else {
+            uploadStream(GL_DRAW_INDIRECT_BUFFER, indirectBuffer, indirectCap, commands.data(),
+                         (GLsizeiptr)(commands.size() * sizeof(DrawElementsIndirectCommand)));
+            uploadStream(GL_SHADER_STORAGE_BUFFER, drawDataBuffer, drawDataCap, draws.data(),
+                         (GLsizeiptr)(draws.size() * sizeof(BatchDrawData)));
+            uploaded = true;
+        }
+        multiDrawShader.use();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, drawDataBuffer);
+        bindVertexArray(vao);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, count, 0); profileCountDraw();
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return;
+    }
+
+    // Fallback: same commands, one draw each; no VAO switches since every mesh lives in the arena,
+    // and the state cache drops the repeated program binds
+    bindVertexArray(vao);
+    for (GLsizei i = 0; i < count; ++i) {
+        const DrawElementsIndirectCommand& c = commands[i];
+        const BatchDrawData& d = draws[i];
+        bool ring = d.material.w > 0.0f;
+        ShaderProgram& shader = ring ? ringShader : meshShader;
+        shader.use();
+        bindMaterial(textureMaterial((int)d.material.x));
+        if (ring) shader.setVec3(UNIFORM_RING_PARAMS, d.material.y, d.material.z, d.material.w);
+        else shader.setModel(d.model);
+        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)c.count, GL_UNSIGNED_INT,
+                                 (void*)(uintptr_t)(c.firstIndex * sizeof(GLuint)), c.baseVertex); profileCountDraw();
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "shader_utils.h"
+
+// ---------------- Static scene batch ----------------
+// The static meshes (ground, paths, ring, hedge wedge templates, fountain OBJ) share one vertex
+// layout (meshVertexFormat). pack() copies them GPU-side (glCopyBufferSubData) into one shared VBO/EBO
+// arena; each frame records one indirect command plus per-draw data (model matrix, material) per
+// visible object and submits them together:
+// - GL 4.3 (or ARB_multi_draw_indirect + shader storage + base instance): one
+//   glMultiDrawElementsIndirect with scene_batch.vert reading the per-draw data from an SSBO.
+// - Otherwise: a glDrawElementsBaseVertex loop over the same commands with forest.vert
+//   (+UNIFORM_SCALE) / ring.vert and per-draw uniforms.
+
+// GL 4.3-class multi-draw indirect with SSBO access from vertex shaders. Check before compiling
+// scene_batch.vert (#version 430) so GL 3.3 drivers never see it.
+bool multiDrawIndirectSupported();
+
+// glMultiDrawElementsIndirect command layout
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance; // = draw index; scene_batch.vert reads it back through aDrawId
+};
+
+// std430 element of the per-draw SSBO (80 bytes)
+struct BatchDrawData {
+    glm::mat4 model;
+    glm::vec4 material; // x: texture layer (-1 = texture_diffuse1); ring draws: y/z/w = inner, outer, UV tiles
+};
+
+// Source mesh for pack(): an existing VBO/EBO pair in meshVertexFormat. indexCount indices are
+// copied from firstIndex; vertexSlot >= 0 reuses an earlier slot's vertices instead of copying
+// vbo again (LOD levels of one mesh share its vertex buffer).
+struct BatchSource {
+    GLuint vbo, ebo;
+    GLsizei indexCount;
+    GLuint firstIndex = 0;
+    int vertexSlot = -1;
+};
+
+struct SceneBatch {
+    // Arena: every packed mesh, addressed by slot (index into pack()'s source list)
+    struct Slot { GLint baseVertex; GLuint firstIndex; GLsizei indexCount; };
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    GLsizeiptr vboCap = 0, eboCap = 0;
+    std::vector<Slot> slots;
+
+    // This frame's draws
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<BatchDrawData> draws;
+    bool uploaded = false; // commands/draws are in the GPU buffers (submit may run twice a frame)
+
+    bool multiDraw = false; // GL 4.3 path available (init)
+    GLuint indirectBuffer = 0, drawDataBuffer = 0, drawIdVBO = 0;
+    GLsizeiptr indirectCap = 0, drawDataCap = 0;
+    GLsizei drawIdCount = 0;
+
+    // Needs a current GL context; multiDrawProgram is scene_batch.vert + fragment_shader.glsl
+    // (0 or unlinked -> fallback loop)
+    void init(GLuint multiDrawProgram);
+    void destroy();
+
+    // Rebuild the arena from sources; empty sources (indexCount 0) get empty slots. Vertex data is
+    // copied up to each source VBO's size (rebuildable meshes keep some growth headroom).
+    void pack(const std::vector<BatchSource>& sources);
+
+    void clearDraws() { commands.clear(); draws.clear(); uploaded = false; }
+    // model may only rotate, translate and scale uniformly: both paths transform normals by its 3x3
+    // (scene_batch.vert directly, the fallback through forest.vert +UNIFORM_SCALE)
+    void addDraw(int slot, const glm::mat4& model, int textureLayer);
+    // ring.vert topology (unit directions + edge selector); radii and tiling applied in the shader
+    void addRingDraw(int slot, float innerR, float outerR, float uvTiles, int textureLayer);
+
+    // Draws everything recorded since clearDraws(). meshShader/ringShader are used by the fallback
+    // loop, multiDrawShader by the indirect path; common uniforms must already be set on each.
+    // Buffers are uploaded by the first submit after clearDraws(), so a depth pre-pass can submit
+    // the same draws again for free.
+    void submit(ShaderProgram& multiDrawShader, ShaderProgram& meshShader, ShaderProgram& ringShader);
+};
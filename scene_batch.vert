@@ -0,0 +1,59 @@
+#version 430 core
+
+// Static scene batch (scene_batch.h): one glMultiDrawElementsIndirect over the shared arena.
+// Each command draws one instance with baseInstance = its draw index, which reaches the shader
+// as aDrawId (divisor 1) and selects the per-draw model matrix and material from the SSBO.
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoord;
+layout(location = 4) in uint aDrawId;
+
+struct DrawData {
+    mat4 model;
+    vec4 material; // x: texture layer; ring draws: y/z/w = inner radius, outer radius, UV tiles
+};
+layout(std430, binding = 0) readonly buffer DrawBuffer {
+    DrawData draws[];
+};
+
+// Per-frame state, one buffer for every program (uniform_blocks.h FrameUniforms)
+layout(std140) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    float time;
+    vec3 lightDir;
+    float fogDensity;
+    vec3 lightColor;
+    vec3 fogColor;
+    vec2 lodFade; // impostor crossfade start and 1 / length, in camera distance per unit of size base
+    mat4 shadowMatrix[3]; // world -> shadow cascade layer, [0, 1]^3 (shadow_map.h)
+    vec4 shadowParams;    // cascades in use (0 = off), fade start, shadow distance, 1 / map size
+    vec4 shadowOffsets;   // per cascade: receiver normal offset in world units
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+flat out int MaterialLayer;
+
+void main()
+{
+    DrawData d = draws[aDrawId];
+    if (d.material.w > 0.0) {
+        // Fountain ring, as in ring.vert
+        float r = mix(d.material.y, d.material.z, aTexCoord.x);
+        FragPos = vec3(aPos.x * r, aPos.y, aPos.z * r);
+        Normal = aNormal;
+        TexCoord = (FragPos.xz + 10.0) * d.material.w;
+    } else {
+        // As in forest.vert +UNIFORM_SCALE: batched models are rigid with uniform scale, so the
+        // 3x3 transforms normals (fragment_shader.glsl renormalizes)
+        FragPos = vec3(d.model * vec4(aPos, 1.0));
+        Normal = mat3(d.model) * aNormal;
+        TexCoord = aTexCoord;
+    }
+    MaterialLayer = int(d.material.x);
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,124 @@
+#include "scene_snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static_assert(sizeof(SceneSettings) == 18 * 4, "SceneSettings has no padding");
+static_assert(sizeof(SnapshotTree) == 20 && sizeof(SnapshotPath) == 20 && sizeof(SnapshotTri) == 24,
+              "snapshot records have no padding");
+
+namespace {
+uint32_t alignUp16(uint32_t v) { return (v + 15u) & ~15u; }
+
+bool hostIsLittleEndian() {
+    uint16_t one = 1;
+    unsigned char low = 0;
+    std::memcpy(&low, &one, 1);
+    return low == 1;
+}
+
+// Block of count records at offset: 4-byte aligned (the records are) and inside the file
+bool blockFits(uint32_t offset, uint32_t count, size_t recordSize, size_t fileSize) {
+    return (offset % 4) == 0 && (uint64_t)offset + (uint64_t)count * recordSize <= fileSize;
+}
+} // namespace
+
+bool writeSceneSnapshot(const std::string& path, const SceneSnapshot& scene) {
+    if (!hostIsLittleEndian()) return false;
+    SceneSnapshotHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "EFSS", 4);
+    h.version = SCENE_SNAPSHOT_VERSION;
+    h.settings = scene.settings;
+    h.treeCount = (uint32_t)scene.trees.size();
+    h.pathCount = (uint32_t)scene.paths.size();
+    h.triCount = (uint32_t)scene.tris.size();
+    h.treeOffset = alignUp16((uint32_t)sizeof(SceneSnapshotHeader));
+    h.pathOffset = alignUp16(h.treeOffset + h.treeCount * (uint32_t)sizeof(SnapshotTree));
+    h.triOffset = alignUp16(h.pathOffset + h.pathCount * (uint32_t)sizeof(SnapshotPath));
+
+    // Temp file first, as for the mesh cache: an interrupted save never leaves half a scene
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        static const char zeros[16] = {0};
+        uint32_t written = 0;
+        auto block = [&](uint32_t offset, const void* data, size_t bytes) {
+            out.write(zeros, offset - written);
+            out.write(static_cast<const char*>(data), (std::streamsize)bytes);
+            written = offset + (uint32_t)bytes;
+        };
+        block(0, &h, sizeof(h));
+        block(h.treeOffset, scene.trees.data(), scene.trees.size() * sizeof(SnapshotTree));
+        block(h.pathOffset, scene.paths.data(), scene.paths.size() * sizeof(SnapshotPath));
+        block(h.triOffset, scene.tris.data(), scene.tris.size() * sizeof(SnapshotTri));
+        if (!out.good()) { out.close(); std::remove(tmpPath.c_str()); return false; }
+    }
+    std::remove(path.c_str()); // rename() does not overwrite on Windows
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool writeSceneSnapshotJson(const std::string& path, const SceneSnapshot& scene) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.precision(9); // round-trips a float
+    const SceneSettings& s = scene.settings;
+    out << "{\n  \"version\": " << SCENE_SNAPSHOT_VERSION << ",\n  \"settings\": {\n"
+        << "    \"layoutSeed\": " << s.layoutSeed << ", \"fireflySeed\": " << s.fireflySeed << ",\n"
+        << "    \"fountainRadius\": " << s.fountainRadius << ", \"pathStyle\": " << s.pathStyle
+        << ", \"groundTexture\": " << s.groundTexture << ",\n"
+        << "    \"treeScale\": " << s.treeScale << ", \"treeYawDeg\": " << s.treeYawDeg << ",\n"
+        << "    \"fountainScale\": " << s.fountainScale << ", \"fountainYawDeg\": " << s.fountainYawDeg
+        << ", \"hedgeScale\": " << s.hedgeScale << ",\n"
+        << "    \"wedgeInner1\": " << s.wedgeInner1 << ", \"wedgeOuter1\": " << s.wedgeOuter1
+        << ", \"wedgeHalfAngle1\": " << s.wedgeHalfAngle1 << ",\n"
+        << "    \"wedgeInner2\": " << s.wedgeInner2 << ", \"wedgeOuter2\": " << s.wedgeOuter2
+        << ", \"wedgeHalfAngle2\": " << s.wedgeHalfAngle2 << ",\n"
+        << "    \"hedgeInnerCount\": " << s.hedgeInnerCount << ", \"hedgeOuterCount\": " << s.hedgeOuterCount << "\n  },\n";
+    // One record per line so a diff shows which tree / path / triangle changed
+    out << "  \"trees\": [";
+    for (size_t i = 0; i < scene.trees.size(); ++i) {
+        const SnapshotTree& t = scene.trees[i];
+        out << (i ? ",\n" : "\n") << "    {\"x\": " << t.x << ", \"z\": " << t.z << ", \"size\": " << t.size
+            << ", \"outerMargin\": " << t.outerMargin << ", \"fountainGap\": " << t.fountainGap << "}";
+    }
+    out << (scene.trees.empty() ? "],\n" : "\n  ],\n") << "  \"paths\": [";
+    for (size_t i = 0; i < scene.paths.size(); ++i) {
+        const SnapshotPath& p = scene.paths[i];
+        out << (i ? ",\n" : "\n") << "    {\"a\": [" << p.ax << ", " << p.ay << "], \"b\": [" << p.bx << ", " << p.by
+            << "], \"clear\": " << (p.clear ? "true" : "false") << "}";
+    }
+    out << (scene.paths.empty() ? "],\n" : "\n  ],\n") << "  \"hedgeTris\": [";
+    for (size_t i = 0; i < scene.tris.size(); ++i) {
+        const SnapshotTri& t = scene.tris[i];
+        out << (i ? ",\n" : "\n") << "    [" << t.ax << ", " << t.az << ", " << t.bx << ", " << t.bz
+            << ", " << t.cx << ", " << t.cz << "]";
+    }
+    out << (scene.tris.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    return out.good();
+}
+
+bool openSceneSnapshot(const std::string& path, MappedFile& file, SceneSnapshotView& view) {
+    if (!hostIsLittleEndian()) return false;
+    if (!file.open(path)) return false;
+    if (file.size < sizeof(SceneSnapshotHeader)) { file.close(); return false; }
+
+    SceneSnapshotHeader h;
+    std::memcpy(&h, file.data, sizeof(h));
+    bool valid = std::memcmp(h.magic, "EFSS", 4) == 0
+              && h.version == SCENE_SNAPSHOT_VERSION
+              && blockFits(h.treeOffset, h.treeCount, sizeof(SnapshotTree), file.size)
+              && blockFits(h.pathOffset, h.pathCount, sizeof(SnapshotPath), file.size)
+              && blockFits(h.triOffset, h.triCount, sizeof(SnapshotTri), file.size);
+    if (!valid) { file.close(); return false; }
+
+    view.settings  = h.settings;
+    view.trees     = reinterpret_cast<const SnapshotTree*>(file.data + h.treeOffset);
+    view.treeCount = h.treeCount;
+    view.paths     = reinterpret_cast<const SnapshotPath*>(file.data + h.pathOffset);
+    view.pathCount = h.pathCount;
+    view.tris      = reinterpret_cast<const SnapshotTri*>(file.data + h.triOffset);
+    view.triCount  = h.triCount;
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mesh_cache.h"
+
+// ---------------- Scene snapshot ----------------
+// A generated scene saved to disk (F5) and loaded with --scene PATH in place of the console
+// prompts and the layout generation, so a heavy scene can be profiled again exactly.
+// Layout: SceneSnapshotHeader, then the tree, path and hedge-triangle blocks, each on a 16-byte
+// boundary. Everything is little-endian and fixed-width, so a load maps the file and reads the
+// blocks in place; big-endian hosts refuse both directions.
+// writeSceneSnapshotJson writes the same content as JSON, for diffing two scenes.
+static const uint32_t SCENE_SNAPSHOT_VERSION = 1;
+
+// Scalar scene state: generation inputs and the user-tweakable model controls
+struct SceneSettings {
+    int32_t  layoutSeed;       // the layout engine's seed (paths, tree sites)
+    uint32_t fireflySeed;      // srand() seed for initFireflies
+    int32_t  fountainRadius;   // px
+    int32_t  pathStyle;
+    int32_t  groundTexture;
+    float    treeScale, treeYawDeg;
+    float    fountainScale, fountainYawDeg;
+    float    hedgeScale;
+    float    wedgeInner1, wedgeOuter1, wedgeHalfAngle1; // inner hedge ring (radians)
+    float    wedgeInner2, wedgeOuter2, wedgeHalfAngle2; // outer hedge ring
+    int32_t  hedgeInnerCount, hedgeOuterCount;
+};
+
+struct SnapshotTree {
+    float    x, z;
+    uint32_t size;             // TreeSize
+    float    outerMargin;      // treeOuterMargin
+    float    fountainGap;      // treeFountainGap
+};
+
+struct SnapshotPath {
+    int32_t  ax, ay, bx, by;   // design grid cells
+    uint32_t clear;
+};
+
+struct SnapshotTri {
+    float ax, az, bx, bz, cx, cz; // hedge footprint, world XZ
+};
+
+struct SceneSnapshotHeader {
+    char          magic[4];    // "EFSS"
+    uint32_t      version;     // SCENE_SNAPSHOT_VERSION
+    SceneSettings settings;
+    uint32_t      treeCount, treeOffset;
+    uint32_t      pathCount, pathOffset;
+    uint32_t      triCount, triOffset;
+};
+
+// A scene to write
+struct SceneSnapshot {
+    SceneSettings settings;
+    std::vector<SnapshotTree> trees;
+    std::vector<SnapshotPath> paths;
+    std::vector<SnapshotTri> tris;
+};
+
+// Pointers into a mapped snapshot; valid while the MappedFile stays open
+struct SceneSnapshotView {
+    SceneSettings settings = {};
+    const SnapshotTree* trees = nullptr;
+    uint32_t treeCount = 0;
+    const SnapshotPath* paths = nullptr;
+    uint32_t pathCount = 0;
+    const SnapshotTri* tris = nullptr;
+    uint32_t triCount = 0;
+};
+
+bool writeSceneSnapshot(const std::string& path, const SceneSnapshot& scene);
+bool writeSceneSnapshotJson(const std::string& path, const SceneSnapshot& scene);
+// Maps path and validates magic, version and block bounds; false (file closed) otherwise
+bool openSceneSnapshot(const std::string& path, MappedFile& file, SceneSnapshotView& view);
@@ -1,7 +1,10 @@
 #include "shader_utils.h"
+#include "profiler.h"
+#include "uniform_blocks.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
 
 std::string readFile(const char* filePath) {
     std::ifstream file(filePath);
@@ -10,9 +13,28 @@ std::string readFile(const char* filePath) {
     return ss.str();
 }
 
-GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode = readFile(vertexPath);
-    std::string fragmentCode = readFile(fragmentPath);
+// Insert "#define ..." lines after the #version line (GLSL requires #version to come first)
+static std::string injectDefines(const std::string& source, const std::vector<std::string>& defines) {
+    if (defines.empty()) return source;
+    std::string block;
+    for (const std::string& d : defines) block += "#define " + d + "\n";
+    size_t version = source.find("#version");
+    if (version == std::string::npos) return block + source;
+    size_t lineEnd = source.find('\n', version);
+    if (lineEnd == std::string::npos) return source + "\n" + block;
+    // #line keeps compiler messages pointing at the file's own line numbers
+    return source.substr(0, lineEnd + 1) + block + "#line 2\n" + source.substr(lineEnd + 1);
+}
+
+static std::string permutationName(const char* path, const std::vector<std::string>& defines) {
+    std::string name = path;
+    for (const std::string& d : defines) name += " +" + d;
+    return name;
+}
+
+GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines) {
+    std::string vertexCode = injectDefines(readFile(vertexPath), defines);
+    std::string fragmentCode = injectDefines(readFile(fragmentPath), defines);
     const char* vSrc = vertexCode.c_str();
     const char* fSrc = fragmentCode.c_str();
 
@@ -24,7 +46,7 @@ GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath) {
         if (!success) {
             GLint len = 0; glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &len);
             std::string log(len, '\0'); glGetShaderInfoLog(vertexShader, len, NULL, &log[0]);
-            std::cerr << "Vertex shader compile error (" << vertexPath << "):\n" << log << std::endl;
+            std::cerr << "Vertex shader compile error (" << permutationName(vertexPath, defines) << "):\n" << log << std::endl;
         }
     }
 
@@ -36,7 +58,7 @@ GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath) {
         if (!success) {
             GLint len = 0; glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &len);
             std::string log(len, '\0'); glGetShaderInfoLog(fragmentShader, len, NULL, &log[0]);
-            std::cerr << "Fragment shader compile error (" << fragmentPath << "):\n" << log << std::endl;
+            std::cerr << "Fragment shader compile error (" << permutationName(fragmentPath, defines) << "):\n" << log << std::endl;
         }
     }
 
@@ -49,7 +71,9 @@ GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath) {
         if (!success) {
             GLint len = 0; glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &len);
             std::string log(len, '\0'); glGetProgramInfoLog(shaderProgram, len, NULL, &log[0]);
-            std::cerr << "Shader link error (" << vertexPath << ", " << fragmentPath << "):\n" << log << std::endl;
+            std::cerr << "Shader link error (" << permutationName(vertexPath, defines) << ", " << fragmentPath << "):\n" << log << std::endl;
+            glDeleteProgram(shaderProgram);
+            shaderProgram = 0;
         }
     }
 
@@ -58,3 +82,94 @@ GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath) {
 
     return shaderProgram;
 }
+
+// ---------------- Shader program wrapper ----------------
+static const char* kUniformNames[UNIFORM_COUNT] = {
+    "model", "normalMatrix",
+    "texture_diffuse1", "texture_layers",
+    "partScale", "partLift", "treeYaw",
+    "ringParams",
+    "impostorSize", "impostor_normals",
+    "shadow_map"
+};
+
+const char* uniformName(UniformId u) { return kUniformNames[u]; }
+
+void ShaderProgram::resolveLocations() {
+    for (int u = 0; u < UNIFORM_COUNT; ++u) {
+        location[u] = id ? glGetUniformLocation(id, kUniformNames[u]) : -1;
+    }
+    invalidateShadow();
+}
+
+void ShaderProgram::invalidateShadow() {
+    for (int u = 0; u < UNIFORM_COUNT; ++u) shadowValid[u] = false;
+}
+
+// Returns true when the value differs from the shadow copy (and records it)
+static bool updateShadow(float* shadow, bool& valid, const float* v, int count) {
+    if (valid && std::memcmp(shadow, v, count * sizeof(float)) == 0) return false;
+    std::memcpy(shadow, v, count * sizeof(float));
+    valid = true;
+    return true;
+}
+
+void ShaderProgram::setMat4(UniformId u, const glm::mat4& m) {
+    if (location[u] < 0) return;
+    if (!updateShadow(shadow[u], shadowValid[u], &m[0][0], 16)) return;
+    profileUniformUploads++;
+    glUniformMatrix4fv(location[u], 1, GL_FALSE, &m[0][0]);
+}
+
+void ShaderProgram::setMat3(UniformId u, const glm::mat3& m) {
+    if (location[u] < 0) return;
+    if (!updateShadow(shadow[u], shadowValid[u], &m[0][0], 9)) return;
+    profileUniformUploads++;
+    glUniformMatrix3fv(location[u], 1, GL_FALSE, &m[0][0]);
+}
+
+void ShaderProgram::setModel(const glm::mat4& m) {
+    if (location[UNIFORM_MODEL] < 0) return;
+    if (!updateShadow(shadow[UNIFORM_MODEL], shadowValid[UNIFORM_MODEL], &m[0][0], 16)) return;
+    profileUniformUploads++;
+    glUniformMatrix4fv(location[UNIFORM_MODEL], 1, GL_FALSE, &m[0][0]);
+    if (has(UNIFORM_NORMAL_MATRIX)) setMat3(UNIFORM_NORMAL_MATRIX, glm::transpose(glm::inverse(glm::mat3(m))));
+}
+
+void ShaderProgram::setVec2(UniformId u, const glm::vec2& v) {
+    if (location[u] < 0) return;
+    if (!updateShadow(shadow[u], shadowValid[u], &v[0], 2)) return;
+    profileUniformUploads++;
+    glUniform2f(location[u], v.x, v.y);
+}
+
+void ShaderProgram::setVec3(UniformId u, const glm::vec3& v) {
+    if (location[u] < 0) return;
+    if (!updateShadow(shadow[u], shadowValid[u], &v[0], 3)) return;
+    profileUniformUploads++;
+    glUniform3f(location[u], v.x, v.y, v.z);
+}
+
+void ShaderProgram::setFloat(UniformId u, float v) {
+    if (location[u] < 0) return;
+    if (!updateShadow(shadow[u], shadowValid[u], &v, 1)) return;
+    profileUniformUploads++;
+    glUniform1f(location[u], v);
+}
+
+void ShaderProgram::setInt(UniformId u, int v) {
+    if (location[u] < 0) return;
+    float asFloat;
+    std::memcpy(&asFloat, &v, sizeof(v)); // shadow stores raw bits
+    if (!updateShadow(shadow[u], shadowValid[u], &asFloat, 1)) return;
+    profileUniformUploads++;
+    glUniform1i(location[u], v);
+}
+
+ShaderProgram createShaderProgram(const char* vertexPath, const char* fragmentPath, const std::vector<std::string>& defines) {
+    ShaderProgram p;
+    p.id = compileShaderFromFile(vertexPath, fragmentPath, defines);
+    p.resolveLocations();
+    bindUniformBlocks(p.id);
+    return p;
+}
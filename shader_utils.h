@@ -1,6 +1,58 @@
 #pragma once
 #include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "gl_state.h"
 #include <string>
+#include <vector>
 
 std::string readFile(const char* filePath);
-GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath);
+// defines: shader permutation, one "NAME" or "NAME VALUE" per entry, injected into both stages
+// as #define lines right after the #version line. Returns 0 if the program does not link (a
+// missing file or a compile error ends there too), so callers can test the id and fall back.
+GLuint compileShaderFromFile(const char* vertexPath, const char* fragmentPath,
+                             const std::vector<std::string>& defines = {});
+
+// ---------------- Shader program wrapper ----------------
+// Every per-program uniform the forest shaders use. Locations are resolved once at link time; a
+// uniform the linked program does not use keeps location -1 and its setters become no-ops. Camera,
+// light, fog and material state are uniform blocks instead (uniform_blocks.h).
+enum UniformId {
+    UNIFORM_MODEL, UNIFORM_NORMAL_MATRIX,
+    UNIFORM_TEXTURE_DIFFUSE1, UNIFORM_TEXTURE_LAYERS,
+    UNIFORM_PART_SCALE, UNIFORM_PART_LIFT, UNIFORM_TREE_YAW, // forest.vert, INSTANCED
+    UNIFORM_RING_PARAMS,                                   // ring.vert
+    UNIFORM_IMPOSTOR_SIZE, UNIFORM_IMPOSTOR_NORMALS,       // impostor.vert
+    UNIFORM_SHADOW_MAP,                                    // fragment_shader.glsl (shadow_map.h)
+    UNIFORM_COUNT
+};
+const char* uniformName(UniformId u);
+
+// Linked program plus cached uniform locations and a shadow copy of the last uploaded values.
+// GL keeps uniform values per program, so a setter whose value matches the shadow copy skips the
+// glUniform* call entirely. Setters assume the program is bound (use()), as glUniform* does.
+struct ShaderProgram {
+    GLuint id = 0;
+    GLint location[UNIFORM_COUNT];
+    float shadow[UNIFORM_COUNT][16];
+    bool  shadowValid[UNIFORM_COUNT];
+
+    void use() const { useProgram(id); } // through the state cache (gl_state.h)
+    bool has(UniformId u) const { return location[u] >= 0; }
+    void resolveLocations();          // (re)query every UniformId; drops the shadow copies
+    void invalidateShadow();          // forget shadow copies (e.g. after raw glUniform* calls)
+
+    void setMat4(UniformId u, const glm::mat4& m);
+    void setMat3(UniformId u, const glm::mat3& m);
+    // model matrix plus, for programs that declare normalMatrix, its inverse-transpose 3x3. The
+    // inverse is only computed when the model actually changes.
+    void setModel(const glm::mat4& m);
+    void setVec2(UniformId u, const glm::vec2& v);
+    void setVec3(UniformId u, const glm::vec3& v);
+    void setVec3(UniformId u, float x, float y, float z) { setVec3(u, glm::vec3(x, y, z)); }
+    void setFloat(UniformId u, float v);
+    void setInt(UniformId u, int v);
+};
+
+// Compiles, links, resolves the uniform locations and binds the uniform blocks
+ShaderProgram createShaderProgram(const char* vertexPath, const char* fragmentPath,
+                                  const std::vector<std::string>& defines = {});
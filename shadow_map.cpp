@@ -0,0 +1,159 @@
+#include "shadow_map.h"
+#include "gl_state.h"
+#include "uniform_blocks.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+
+static_assert(kShadowCascades == 3, "FrameBlock (uniform_blocks.h and the shaders) declares three cascades");
+
+namespace {
+// View depth of split i of count between near and far
+float splitDistance(int i, int count, float nearD, float farD, float lambda) {
+    float t = (float)i / (float)count;
+    float logSplit = nearD * std::pow(farD / nearD, t);
+    float uniformSplit = nearD + (farD - nearD) * t;
+    return lambda * logSplit + (1.0f - lambda) * uniformSplit;
+}
+} // namespace
+
+bool ShadowMaps::init(int texels) {
+    destroy();
+    size = texels;
+    GLint prev = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev);
+
+    glGenTextures(1, &depthArray);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthArray);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, size, size, kShadowCascades, 0,
+                 GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    // Linear + compare mode: each lookup is a hardware 2x2 PCF tap (sampler2DArrayShadow)
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // Depth only: no colour attachment, so the caster programs' colour output goes nowhere
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prev);
+    if (!complete) {
+        std::cout << "[Guard] Shadow map framebuffer incomplete; shadows disabled\n";
+        destroy();
+        return false;
+    }
+    std::cout << "[Info] Shadow maps: " << kShadowCascades << " cascades of " << size << "x" << size << " ("
+              << (double)size * size * 4 * kShadowCascades / (1024.0 * 1024.0) << " MB), refreshed every";
+    for (int c = 0; c < kShadowCascades; ++c) std::cout << (c ? "/" : " ") << kShadowIntervals[c];
+    std::cout << " frames\n";
+    return true;
+}
+
+void ShadowMaps::destroy() {
+    if (fbo) glDeleteFramebuffers(1, &fbo);
+    if (depthArray) glDeleteTextures(1, &depthArray);
+    fbo = depthArray = 0;
+    invalidate();
+}
+
+void ShadowMaps::invalidate() {
+    for (ShadowCascade& c : cascades) c.valid = false;
+}
+
+bool ShadowMaps::due(int c) const {
+    if (!cascades[c].valid || !throttle || kShadowIntervals[c] <= 1) return true;
+    return frame % (unsigned long long)kShadowIntervals[c] == (unsigned long long)kShadowPhases[c];
+}
+
+void ShadowMaps::fit(int c, const glm::mat4& cameraView, const glm::mat4& cameraProjection, const glm::vec3& lightDir) {
+    // glm::perspective (GL clip space): P[2][2] = -(f + n) / (f - n), P[3][2] = -2fn / (f - n)
+    float nearD = cameraProjection[3][2] / (cameraProjection[2][2] - 1.0f);
+    float farD = cameraProjection[3][2] / (cameraProjection[2][2] + 1.0f);
+    float endD = std::min(distance, farD);
+    float d0 = splitDistance(c, kShadowCascades, nearD, endD, splitLambda);
+    float d1 = splitDistance(c + 1, kShadowCascades, nearD, endD, splitLambda);
+
+    // Slice corners: view depth is linear along each frustum edge from the near to the far plane
+    glm::mat4 invViewProj = glm::inverse(cameraProjection * cameraView);
+    glm::vec3 corners[8];
+    glm::vec3 center(0.0f);
+    for (int i = 0; i < 4; ++i) {
+        glm::vec4 a = invViewProj * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, -1.0f, 1.0f);
+        glm::vec4 b = invViewProj * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, 1.0f, 1.0f);
+        glm::vec3 nearCorner = glm::vec3(a) / a.w, farCorner = glm::vec3(b) / b.w;
+        corners[i] = glm::mix(nearCorner, farCorner, (d0 - nearD) / (farD - nearD));
+        corners[i + 4] = glm::mix(nearCorner, farCorner, (d1 - nearD) / (farD - nearD));
+        center += corners[i] + corners[i + 4];
+    }
+    center /= 8.0f;
+    float radius = 0.0f;
+    for (const glm::vec3& p : corners) radius = std::max(radius, glm::length(p - center));
+    // Quantized, so float noise in the fit never changes the texel size
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    // Fixed light orientation: the texel grid only translates, by whole texels
+    glm::vec3 L = glm::normalize(lightDir);
+    glm::vec3 up = std::fabs(L.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), L, up);
+    float texel = 2.0f * radius / (float)size;
+    glm::vec3 ls = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+    ls.x = std::floor(ls.x / texel) * texel;
+    ls.y = std::floor(ls.y / texel) * texel;
+    center = glm::vec3(glm::transpose(lightRotation) * glm::vec4(ls, 0.0f));
+
+    ShadowCascade& sc = cascades[c];
+    float depthRange = 2.0f * radius + casterReach;
+    sc.view = glm::lookAt(center - L * (radius + casterReach), center, up);
+    sc.projection = glm::ortho(-radius, radius, -radius, radius, 0.0f, depthRange);
+    sc.texelWorld = texel;
+    // Clip space to [0, 1]^3, then a constant bias of one texel's world size in depth
+    glm::mat4 toTexture = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.5f, 0.5f - texel / depthRange));
+    toTexture = glm::scale(toTexture, glm::vec3(0.5f));
+    sc.shadowMatrix = toTexture * sc.projection * sc.view;
+}
+
+void ShadowMaps::beginCascade(int c) {
+    if (!rendering) {
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFBO);
+        glGetIntegerv(GL_VIEWPORT, prevViewport);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, size, size);
+        rendering = true;
+    }
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthArray, 0, c);
+    // The clear honours the depth mask
+    setDepthWrite(true);
+    const GLfloat depthClear = 1.0f;
+    glClearBufferfv(GL_DEPTH, 0, &depthClear);
+    cascades[c].valid = true;
+}
+
+void ShadowMaps::endFrame() {
+    if (rendering) {
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFBO);
+        glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+        rendering = false;
+    }
+    frame++;
+}
+
+void ShadowMaps::writeFrameUniforms(FrameUniforms& f, bool enabled) const {
+    bool all = true;
+    for (int c = 0; c < kShadowCascades; ++c) {
+        f.shadowMatrix[c] = cascades[c].shadowMatrix;
+        // Receivers sample about a texel and a half out along their normal (less acne on slopes)
+        f.shadowOffsets[c] = 1.5f * cascades[c].texelWorld;
+        all = all && cascades[c].valid;
+    }
+    enabled = enabled && ready() && all;
+    f.shadowParams = glm::vec4(enabled ? (float)kShadowCascades : 0.0f, 0.85f * distance, distance, 1.0f / (float)size);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+struct FrameUniforms;
+
+// ---------------- Cascaded shadow maps ----------------
+// Directional-light shadows for the 3D pass. The camera frustum out to `distance` is split into
+// kShadowCascades slices (a blend of logarithmic and uniform spacing, splitLambda); each slice gets
+// an orthographic light view around its bounding sphere and one layer of a depth texture array.
+// The sphere keeps a cascade's extent fixed under camera rotation and its centre is snapped to
+// whole shadow texels, so shadow edges do not crawl while the camera moves.
+// Cascade c is re-rendered every kShadowIntervals[c] frames, phase-shifted so no two throttled
+// cascades fall on the same frame. In between, receivers keep the matrix the layer was rendered
+// with: a stale cascade is a few frames late, never misaligned, and fragment_shader.glsl falls
+// through to the next cascade where a late one no longer covers the fragment.
+const int kShadowCascades = 3;
+const int kShadowIntervals[kShadowCascades] = { 1, 2, 4 };
+const int kShadowPhases[kShadowCascades] = { 0, 1, 2 };
+
+struct ShadowCascade {
+    glm::mat4 view = glm::mat4(1.0f);       // light view and projection the layer was rendered with
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 shadowMatrix = glm::mat4(1.0f); // world -> layer texture space, depth bias included
+    float texelWorld = 0.0f;                // world size of one shadow texel
+    bool valid = false;                     // rendered since init / invalidate
+};
+
+struct ShadowMaps {
+    int size = 1024;            // texels per side of each layer
+    float distance = 40.0f;     // camera distance the cascades cover; unshadowed past it
+    float casterReach = 20.0f;  // how far toward the light casters are kept ahead of a slice
+    float splitLambda = 0.6f;   // 0: uniform splits, 1: logarithmic
+    bool throttle = true;       // false: every cascade every frame
+    GLuint depthArray = 0, fbo = 0;
+    ShadowCascade cascades[kShadowCascades];
+    unsigned long long frame = 0;
+
+    // Needs a current GL context. Restores the framebuffer bound before; false (and no shadows)
+    // if the depth-only FBO is incomplete.
+    bool init(int texels);
+    void destroy();
+    bool ready() const { return fbo != 0; }
+
+    // Every cascade is due on the next frame (casters moved or shadows were off)
+    void invalidate();
+    bool due(int c) const;
+    // Light view / projection of cascade c around the camera's slice; the caller renders the layer
+    // with them (beginCascade) before the frame's receivers read shadowMatrix
+    void fit(int c, const glm::mat4& cameraView, const glm::mat4& cameraProjection, const glm::vec3& lightDir);
+    // First beginCascade of a frame saves the bound framebuffer and viewport; endFrame restores them
+    void beginCascade(int c);
+    void endFrame();
+    // Receiver side of the frame block (shadowMatrix / shadowParams / shadowOffsets); enabled
+    // false writes zero cascades
+    void writeFrameUniforms(FrameUniforms& frame, bool enabled) const;
+
+private:
+    bool rendering = false;
+    GLint prevFBO = 0, prevViewport[4] = { 0, 0, 0, 0 };
+};
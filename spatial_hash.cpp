@@ -0,0 +1,82 @@
+#include "spatial_hash.h"
+#include <cmath>
+
+// ---------------- Spatial hash ----------------
+void SpatialHash2D::reset(float newCellSize) {
+    cellSize = newCellSize > 0.0f ? newCellSize : 1.0f;
+    points.clear();
+    cells.clear();
+}
+
+int64_t SpatialHash2D::keyFor(const glm::vec2& p) const {
+    return packKey((int)std::floor(p.x / cellSize), (int)std::floor(p.y / cellSize));
+}
+
+int SpatialHash2D::insert(const glm::vec2& p) {
+    int id = (int)points.size();
+    points.push_back(p);
+    cells[keyFor(p)].push_back(id);
+    return id;
+}
+
+bool SpatialHash2D::anyWithin(const glm::vec2& p, float radius) const {
+    int cx = (int)std::floor(p.x / cellSize), cy = (int)std::floor(p.y / cellSize);
+    float r2 = radius * radius;
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            auto it = cells.find(packKey(cx + dx, cy + dy));
+            if (it == cells.end()) continue;
+            for (int id : it->second) {
+                glm::vec2 d = points[id] - p;
+                if (d.x*d.x + d.y*d.y < r2) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ---------------- Poisson-disk sampling ----------------
+std::vector<glm::vec2> poissonDiskSample(const glm::vec2& lo, const glm::vec2& hi, float radius,
+                                         const std::function<bool(const glm::vec2&)>& allowed,
+                                         std::mt19937& rng, int k, int maxSeeds) {
+    std::vector<glm::vec2> out;
+    if (radius <= 0.0f || hi.x <= lo.x || hi.y <= lo.y) return out;
+    SpatialHash2D hash;
+    hash.reset(radius);
+    std::uniform_real_distribution<float> ux(lo.x, hi.x), uy(lo.y, hi.y), unit(0.0f, 1.0f);
+    auto inBounds = [&](const glm::vec2& p){ return p.x >= lo.x && p.x <= hi.x && p.y >= lo.y && p.y <= hi.y; };
+    auto accept = [&](const glm::vec2& p){ return inBounds(p) && allowed(p) && !hash.anyWithin(p, radius); };
+
+    std::vector<int> active;
+    int failedSeeds = 0;
+    while (failedSeeds < maxSeeds) {
+        if (active.empty()) {
+            // (Re)seed anywhere valid; a run of failures means the region is saturated
+            glm::vec2 s(ux(rng), uy(rng));
+            if (!accept(s)) { failedSeeds++; continue; }
+            active.push_back(hash.insert(s));
+            out.push_back(s);
+            continue;
+        }
+        std::uniform_int_distribution<size_t> pick(0, active.size() - 1);
+        size_t slot = pick(rng);
+        glm::vec2 base = hash.points[active[slot]];
+        bool found = false;
+        for (int i = 0; i < k && !found; ++i) {
+            // Uniform by area over the annulus [r, 2r]
+            float ang = unit(rng) * 6.2831853f;
+            float rr = radius * std::sqrt(1.0f + 3.0f * unit(rng));
+            glm::vec2 c = base + rr * glm::vec2(std::cos(ang), std::sin(ang));
+            if (accept(c)) {
+                active.push_back(hash.insert(c));
+                out.push_back(c);
+                found = true;
+            }
+        }
+        if (!found) {
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+    return out;
+}
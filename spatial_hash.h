@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ---------------- Spatial hash ----------------
+// Uniform 2D hash of points (world XZ). With cellSize >= the query radius, a neighbourhood query
+// only visits the 3x3 cells around the query point, so spacing checks cost O(1) per query
+// instead of a scan over every point.
+struct SpatialHash2D {
+    float cellSize = 1.0f;
+    std::vector<glm::vec2> points;                      // inserted points, indexed by insertion order
+    std::unordered_map<int64_t, std::vector<int>> cells; // cell key -> point indices
+
+    void reset(float newCellSize);
+    int insert(const glm::vec2& p); // returns the point index
+    // True if any inserted point lies strictly closer than radius (radius <= cellSize)
+    bool anyWithin(const glm::vec2& p, float radius) const;
+
+private:
+    int64_t keyFor(const glm::vec2& p) const;
+    static int64_t packKey(int cx, int cy) { return ((int64_t)cx << 32) ^ (int64_t)(uint32_t)cy; }
+};
+
+// ---------------- Poisson-disk sampling ----------------
+// Bridson's algorithm over the rectangle [lo, hi]: every accepted point is at least `radius` from
+// every other and satisfies allowed(p). Grows from a random allowed seed, trying k candidates in
+// the annulus [r, 2r] around each active point; when the active list empties it reseeds (up to
+// maxSeeds failed attempts), so allowed regions split by forbidden areas are all covered. The
+// output order follows the growth front. Deterministic for a given rng state.
+std::vector<glm::vec2> poissonDiskSample(const glm::vec2& lo, const glm::vec2& hi, float radius,
+                                         const std::function<bool(const glm::vec2&)>& allowed,
+                                         std::mt19937& rng, int k = 30, int maxSeeds = 200);
@@ -0,0 +1,407 @@
+#include "texture_loader.h"
+#include "asset_registry.h"
+#include "mesh_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Minimal texture loader: If stb_image is available it will be used.
+// Otherwise, we create a 1x1 fallback texture.
+#ifdef __has_include
+#  if __has_include("stb_image.h")
+#    define HAS_STB 1
+#    define STB_IMAGE_IMPLEMENTATION
+#    include "stb_image.h"
+#  else
+#    define HAS_STB 0
+#  endif
+#else
+#  define HAS_STB 0
+#endif
+
+// ---------------- Compressed containers ----------------
+namespace {
+uint32_t readU32(const unsigned char* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+uint64_t readU64(const unsigned char* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+size_t levelBytes(GLenum fmt, int w, int h) {
+    return (size_t)std::max(1, (w + 3) / 4) * (size_t)std::max(1, (h + 3) / 4) * compressedBlockBytes(fmt);
+}
+
+const char* formatNameFor(GLenum fmt) {
+    switch (fmt) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: return "BC1";
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return "BC3";
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:    return "BC7";
+        default: return "?";
+    }
+}
+
+// Fills out.levels from a tightly packed chain starting at dataOffset; false if it overruns
+bool fillPackedLevels(CompressedTexture& out, int levelCount, size_t dataOffset, size_t fileSize) {
+    int w = out.width, h = out.height;
+    size_t offset = dataOffset;
+    for (int i = 0; i < levelCount; ++i) {
+        size_t bytes = levelBytes(out.internalFormat, w, h);
+        if (offset + bytes > fileSize) return false;
+        out.levels.push_back(CompressedMip{ w, h, offset, bytes });
+        offset += bytes;
+        if (w == 1 && h == 1) break;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return !out.levels.empty();
+}
+} // namespace
+
+size_t compressedBlockBytes(GLenum internalFormat) {
+    return (internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
+}
+
+bool parseDDS(const unsigned char* data, size_t size, CompressedTexture& out) {
+    // "DDS " + 124-byte DDS_HEADER (pixel format at 76), optional 20-byte DX10 header
+    if (size < 128 || std::memcmp(data, "DDS ", 4) != 0 || readU32(data + 4) != 124) return false;
+    const uint32_t kMipMapCountFlag = 0x20000, kAlphaPixels = 0x1, kFourCC = 0x4;
+    uint32_t flags = readU32(data + 8);
+    out.height = (int)readU32(data + 12);
+    out.width = (int)readU32(data + 16);
+    int mipCount = (flags & kMipMapCountFlag) ? std::max(1, (int)readU32(data + 28)) : 1;
+    uint32_t pfFlags = readU32(data + 80);
+    if (!(pfFlags & kFourCC)) return false;
+    const unsigned char* fourCC = data + 84;
+    size_t dataOffset = 128;
+    if (std::memcmp(fourCC, "DXT1", 4) == 0) {
+        out.internalFormat = (pfFlags & kAlphaPixels) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    } else if (std::memcmp(fourCC, "DXT5", 4) == 0) {
+        out.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    } else if (std::memcmp(fourCC, "DX10", 4) == 0) {
+        if (size < 148) return false;
+        uint32_t dxgi = readU32(data + 128);
+        uint32_t arraySize = readU32(data + 140);
+        if (arraySize > 1) return false;
+        if (dxgi == 71 || dxgi == 72)      out.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; // BC1 (sRGB read as UNORM)
+        else if (dxgi == 77 || dxgi == 78) out.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; // BC3
+        else if (dxgi == 98 || dxgi == 99) out.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;    // BC7
+        else return false;
+        dataOffset = 148;
+    } else {
+        return false;
+    }
+    if (out.width <= 0 || out.height <= 0) return false;
+    out.formatName = formatNameFor(out.internalFormat);
+    return fillPackedLevels(out, mipCount, dataOffset, size);
+}
+
+bool parseKTX2(const unsigned char* data, size_t size, CompressedTexture& out) {
+    static const unsigned char kIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    if (size < 80 || std::memcmp(data, kIdentifier, 12) != 0) return false;
+    uint32_t vkFormat = readU32(data + 12);
+    out.width = (int)readU32(data + 20);
+    out.height = (int)readU32(data + 24);
+    uint32_t depth = readU32(data + 28), layers = readU32(data + 32), faces = readU32(data + 36);
+    uint32_t levelCount = std::max(1u, readU32(data + 40));
+    uint32_t supercompression = readU32(data + 44);
+    // Plain 2D textures only; Basis/zstd supercompressed files need a transcoder
+    if (depth > 1 || layers > 1 || faces != 1 || supercompression != 0) return false;
+    switch (vkFormat) {
+        case 131: case 132: out.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;  // BC1_RGB
+        case 133: case 134: out.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break; // BC1_RGBA
+        case 137: case 138: out.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break; // BC3
+        case 145: case 146: out.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break;    // BC7
+        default: return false;
+    }
+    if (out.width <= 0 || out.height <= 0 || size < 80 + (size_t)levelCount * 24) return false;
+    out.formatName = formatNameFor(out.internalFormat);
+    // Level index: {byteOffset, byteLength, uncompressedByteLength} per level, level 0 first
+    int w = out.width, h = out.height;
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const unsigned char* entry = data + 80 + i * 24;
+        uint64_t offset = readU64(entry), length = readU64(entry + 8);
+        if (offset + length > size || length < levelBytes(out.internalFormat, w, h)) return false;
+        out.levels.push_back(CompressedMip{ w, h, (size_t)offset, (size_t)levelBytes(out.internalFormat, w, h) });
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    return true;
+}
+
+// ---------------- Load Texture ----------------
+namespace {
+// layer >= 0: one layer of a texture array, decoded as RGBA and resampled to layerSize x layerSize
+struct DecodeJob { GLuint texture; std::string path; int layer = -1; int layerSize = 0; };
+struct DecodeResult {
+    GLuint texture; std::string path; unsigned char* pixels; int width, height, channels;
+    int layer; std::vector<unsigned char> layerPixels;
+};
+
+std::mutex queueMutex;
+std::condition_variable queueCv;   // workers wait for jobs
+std::condition_variable resultCv;  // finishTextureUploads waits for results
+std::deque<DecodeJob> jobs;
+std::deque<DecodeResult> results;
+std::vector<std::thread> workers;
+int outstanding = 0; // queued or decoding, not yet uploaded
+bool stopping = false;
+
+void setTextureParams(int levelCount, GLenum target = GL_TEXTURE_2D) {
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+}
+
+int mipLevelCount(int width, int height) {
+    return 1 + (int)std::floor(std::log2((double)std::max(width, height)));
+}
+
+// Bilinear resample of RGBA pixels with wrap-around, sampling where GL_LINEAR + GL_REPEAT would,
+// so a 16x16 tile upscaled into a 64x64 layer looks like the magnified original
+void resampleWrapped(const unsigned char* src, int srcW, int srcH, int size, std::vector<unsigned char>& out) {
+    out.resize((size_t)size * size * 4);
+    auto wrap = [](int i, int n){ return ((i % n) + n) % n; };
+    for (int y = 0; y < size; ++y) {
+        float fy = (y + 0.5f) * srcH / size - 0.5f;
+        int y0 = (int)std::floor(fy);
+        float ty = fy - y0;
+        const unsigned char* r0 = src + (size_t)wrap(y0, srcH) * srcW * 4;
+        const unsigned char* r1 = src + (size_t)wrap(y0 + 1, srcH) * srcW * 4;
+        for (int x = 0; x < size; ++x) {
+            float fx = (x + 0.5f) * srcW / size - 0.5f;
+            int x0 = (int)std::floor(fx);
+            float tx = fx - x0;
+            int c0 = wrap(x0, srcW) * 4, c1 = wrap(x0 + 1, srcW) * 4;
+            for (int c = 0; c < 4; ++c) {
+                float top = r0[c0 + c] + (r0[c1 + c] - r0[c0 + c]) * tx;
+                float bottom = r1[c0 + c] + (r1[c1 + c] - r1[c0 + c]) * tx;
+                out[((size_t)y * size + x) * 4 + c] = (unsigned char)std::lround(top + (bottom - top) * ty);
+            }
+        }
+    }
+}
+
+void uploadPlaceholder() {
+    unsigned char white[4] = {255, 255, 255, 255};
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    setTextureParams(1);
+}
+
+bool formatSupported(GLenum fmt) {
+    if (fmt == GL_COMPRESSED_RGBA_BPTC_UNORM) return GLEW_ARB_texture_compression_bptc;
+    return GLEW_EXT_texture_compression_s3tc;
+}
+
+// <name>.ktx2 / <name>.dds next to the PNG, uploaded with its full mip chain
+bool tryCompressedSibling(GLuint texture, const std::string& pngPath) {
+    size_t dot = pngPath.find_last_of('.');
+    std::string stem = pngPath.substr(0, dot);
+    const char* exts[2] = { ".ktx2", ".dds" };
+    for (const char* ext : exts) {
+        const std::string& p = resolveAssetPath(stem + ext);
+        MappedFile file;
+        if (p.empty() || !file.open(p)) continue;
+        CompressedTexture ct;
+        bool parsed = (ext[1] == 'k') ? parseKTX2(file.data, file.size, ct) : parseDDS(file.data, file.size, ct);
+        if (!parsed) { std::cout << "[Guard] Unsupported compressed texture " << p << ", trying the PNG\n"; continue; }
+        if (!formatSupported(ct.internalFormat)) {
+            std::cout << "[Guard] " << ct.formatName << " not supported by this GL driver (" << p << "), trying the PNG\n";
+            return false;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        for (size_t i = 0; i < ct.levels.size(); ++i) {
+            const CompressedMip& m = ct.levels[i];
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, ct.internalFormat, m.width, m.height, 0,
+                                   (GLsizei)m.size, file.data + m.offset);
+        }
+        setTextureParams((int)ct.levels.size());
+        return true;
+    }
+    return false;
+}
+
+void decodeWorker() {
+    for (;;) {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCv.wait(lock, []{ return stopping || !jobs.empty(); });
+            if (stopping) return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        DecodeResult r{ job.texture, job.path, nullptr, 0, 0, 0, job.layer, {} };
+#if HAS_STB
+        // job.path is already resolved on the main thread; workers never probe
+        if (job.layer >= 0) {
+            unsigned char* rgba = stbi_load(job.path.c_str(), &r.width, &r.height, &r.channels, 4);
+            if (rgba) {
+                resampleWrapped(rgba, r.width, r.height, job.layerSize, r.layerPixels);
+                stbi_image_free(rgba);
+                r.width = r.height = job.layerSize;
+            }
+        } else {
+            r.pixels = stbi_load(job.path.c_str(), &r.width, &r.height, &r.channels, 0);
+        }
+#endif
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            results.push_back(r);
+        }
+        resultCv.notify_all();
+    }
+}
+
+void startWorkers() {
+    if (!workers.empty()) return;
+#if HAS_STB
+    // Set once before any worker runs; stb reads the flag on every load
+    stbi_set_flip_vertically_on_load(true);
+#endif
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned count = std::max(1u, std::min(4u, hw > 1 ? hw - 1 : 1u));
+    for (unsigned i = 0; i < count; ++i) workers.emplace_back(decodeWorker);
+}
+
+void uploadDecoded(DecodeResult& r) {
+    if (r.layer >= 0) {
+        if (r.layerPixels.empty()) {
+            std::cout << "Failed to load texture: " << r.path << ". Using fallback.\n";
+            return;
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, r.texture);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, r.layer, r.width, r.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, r.layerPixels.data());
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY); // all layers; they are small
+        return;
+    }
+    if (r.pixels && r.width > 0 && r.height > 0) {
+        glBindTexture(GL_TEXTURE_2D, r.texture);
+        GLenum format = (r.channels == 4) ? GL_RGBA : GL_RGB;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // RGB rows are not 4-byte aligned in general
+        glTexImage2D(GL_TEXTURE_2D, 0, format, r.width, r.height, 0, format, GL_UNSIGNED_BYTE, r.pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        setTextureParams(mipLevelCount(r.width, r.height));
+    } else {
+        // Keeps the 1x1 white placeholder
+        std::cout << "Failed to load texture: " << r.path << ". Using fallback.\n";
+    }
+#if HAS_STB
+    if (r.pixels) stbi_image_free(r.pixels);
+#endif
+}
+} // namespace
+
+GLuint loadTexture(const char* filePath) {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+
+    if (tryCompressedSibling(texID, filePath)) return texID;
+
+    uploadPlaceholder();
+#if HAS_STB
+    const std::string& resolved = resolveAssetPath(filePath);
+    if (resolved.empty()) {
+        std::cout << "Failed to load texture: " << filePath << ". Using fallback.\n";
+        return texID;
+    }
+    startWorkers();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        jobs.push_back(DecodeJob{ texID, resolved });
+        outstanding++;
+    }
+    queueCv.notify_one();
+#else
+    std::cout << "Failed to load texture: " << filePath << ". Using fallback.\n";
+#endif
+    return texID;
+}
+
+GLuint loadTextureArray(const std::vector<std::string>& layerPaths, int layerSize) {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texID);
+    // White layers until the decodes land, like loadTexture's 1x1 placeholder
+    GLsizei layers = (GLsizei)layerPaths.size();
+    std::vector<unsigned char> white((size_t)layerSize * layerSize * layers * 4, 255);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerSize, layerSize, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, white.data());
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    setTextureParams(mipLevelCount(layerSize, layerSize), GL_TEXTURE_2D_ARRAY);
+
+    for (size_t i = 0; i < layerPaths.size(); ++i) {
+#if HAS_STB
+        const std::string& resolved = resolveAssetPath(layerPaths[i]);
+        if (resolved.empty()) {
+            std::cout << "Failed to load texture: " << layerPaths[i] << ". Using fallback.\n";
+            continue;
+        }
+        startWorkers();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            jobs.push_back(DecodeJob{ texID, resolved, (int)i, layerSize });
+            outstanding++;
+        }
+        queueCv.notify_one();
+#else
+        std::cout << "Failed to load texture: " << layerPaths[i] << ". Using fallback.\n";
+#endif
+    }
+    return texID;
+}
+
+int pumpTextureUploads() {
+    std::deque<DecodeResult> ready;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (results.empty()) return 0;
+        ready.swap(results);
+        outstanding -= (int)ready.size();
+    }
+    GLint prevTexture = 0, prevArray = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D_ARRAY, &prevArray);
+    for (DecodeResult& r : ready) uploadDecoded(r);
+    glBindTexture(GL_TEXTURE_2D, (GLuint)prevTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, (GLuint)prevArray);
+    return (int)ready.size();
+}
+
+int pendingTextureUploads() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return outstanding;
+}
+
+void finishTextureUploads() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (outstanding == 0) return;
+            resultCv.wait(lock, []{ return !results.empty(); });
+        }
+        pumpTextureUploads();
+    }
+}
+
+void shutdownTextureLoader() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    queueCv.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+#if HAS_STB
+    for (DecodeResult& r : results) if (r.pixels) stbi_image_free(r.pixels);
+#endif
+    results.clear();
+    outstanding = 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+// ---------------- Texture loading ----------------
+// loadTexture returns a texture name at once. A precompressed sibling of the PNG
+// (<name>.ktx2, then <name>.dds) holding BC1/BC3/BC7 with its mip chain is uploaded directly when
+// the driver supports the format. Otherwise the PNG is decoded on a worker thread and the texture
+// shows the 1x1 white fallback until pumpTextureUploads() uploads it on the main thread.
+GLuint loadTexture(const char* filePath);
+
+// GL_TEXTURE_2D_ARRAY with one layer per path, every layer resampled to layerSize x layerSize
+// RGBA8 with a shared mip chain. Layers decode on the workers like loadTexture's PNGs and stay
+// white until uploaded. Compressed siblings are not used here (all layers must share a format).
+GLuint loadTextureArray(const std::vector<std::string>& layerPaths, int layerSize);
+
+// Main thread, once per frame: uploads the PNGs that finished decoding. Returns how many.
+int pumpTextureUploads();
+// PNGs queued but not uploaded yet (0: every texture so far is resident)
+int pendingTextureUploads();
+// Blocks until every queued PNG is decoded and uploaded (bench runs, so they never time streaming)
+void finishTextureUploads();
+// Joins the decode workers; pending results are dropped
+void shutdownTextureLoader();
+
+// ---------------- Compressed containers ----------------
+// Parsed view of a DDS or KTX2 file; level data points into the caller's buffer. The offline
+// converter (tools/texture_compress.cpp) stores rows bottom-up, matching stb's flipped PNG loads.
+struct CompressedMip {
+    int width, height;
+    size_t offset; // from the start of the file
+    size_t size;
+};
+struct CompressedTexture {
+    GLenum internalFormat = 0; // GL_COMPRESSED_*_S3TC_DXT*_EXT or GL_COMPRESSED_RGBA_BPTC_UNORM
+    const char* formatName = "";
+    int width = 0, height = 0;
+    std::vector<CompressedMip> levels; // level 0 first
+};
+
+size_t compressedBlockBytes(GLenum internalFormat); // 8 (BC1) or 16 (BC3/BC7)
+bool parseDDS(const unsigned char* data, size_t size, CompressedTexture& out);
+bool parseKTX2(const unsigned char* data, size_t size, CompressedTexture& out);
@@ -0,0 +1,50 @@
+// Mesh LOD benchmark: builds the simplified levels loadModel bakes into the mesh cache (same
+// vertex cache / fetch passes, same ratios) for an OBJ, times them and checks that every level
+// exists and lands near its share of the triangles.
+//
+// Build (from the project root, no GL libraries needed):
+//   g++ -std=c++17 -O2 -I. tools/lod_bench.cpp obj_parser.cpp mesh_cache.cpp mesh_optimize.cpp -o lod_bench -pthread
+// Run:
+//   ./lod_bench [Models/Fountain.obj]
+
+#include "mesh_cache.h"
+#include "mesh_optimize.h"
+#include "obj_parser.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "Models/Fountain.obj";
+    ObjMeshData mesh;
+    if (!parseObjFile(path, mesh) || mesh.indices.empty()) {
+        std::cout << "Failed to parse " << path << "\n";
+        return 1;
+    }
+    std::vector<float>& vertices = mesh.vertices;
+    std::vector<unsigned int>& indices = mesh.indices;
+    optimizeVertexCache(indices, vertices.size() / 8);
+    optimizeVertexFetch(vertices, indices, 8);
+    const size_t baseTris = indices.size() / 3;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<size_t> counts = appendSimplifiedLevels(vertices, indices, 8, kMeshLodRatios, kMaxMeshLods - 1);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::cout << "[Bench] " << path << ": " << vertices.size() / 8 << " vertices, " << baseTris << " triangles\n";
+    std::cout << "[Bench] " << counts.size() - 1 << " simplified level(s) in "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    // Within 10% of the target triangle count (a level stops at the first collapse below it)
+    bool ok = counts.size() == (size_t)kMaxMeshLods;
+    for (size_t i = 1; i < counts.size(); ++i) {
+        size_t target = (size_t)(baseTris * kMeshLodRatios[i - 1]);
+        size_t tris = counts[i] / 3;
+        bool near = std::fabs((double)tris - (double)target) <= 0.1 * (double)target;
+        ok = ok && near;
+        std::cout << "[Bench] LOD " << i << ": " << tris << " triangles (target " << target << ", "
+                  << 100.0 * tris / baseTris << "%)" << (near ? "" : " MISSED") << "\n";
+    }
+    std::cout << "[Bench] levels " << (ok ? "reach their targets" : "DO NOT reach their targets") << "\n";
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,56 @@
+// OBJ parser benchmark: times the reference getline/istringstream loader against the mapped,
+// chunked tokenizer in obj_parser.cpp and checks that both produce identical meshes.
+//
+// Build (from the project root, no GL libraries needed):
+//   g++ -std=c++17 -O2 -I. tools/obj_bench.cpp obj_parser.cpp mesh_cache.cpp -o obj_bench -pthread
+// Run:
+//   ./obj_bench [Models/Fountain.obj] [runs] [threads]
+
+#include "obj_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+template <typename F>
+static double bestOfMs(int runs, F&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+static bool sameMesh(const ObjMeshData& a, const ObjMeshData& b) {
+    return a.vertices == b.vertices && a.indices == b.indices
+        && a.radiusXZ == b.radiusXZ && a.minY == b.minY && a.maxY == b.maxY;
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "Models/Fountain.obj";
+    int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    unsigned threads = argc > 3 ? (unsigned)std::max(0, std::atoi(argv[3])) : 0;
+
+    ObjMeshData ref, fast, single;
+    if (!parseObjFileReference(path, ref)) {
+        std::cout << "Failed to parse " << path << "\n";
+        return 1;
+    }
+    double refMs    = bestOfMs(runs, [&]{ parseObjFileReference(path, ref); });
+    double singleMs = bestOfMs(runs, [&]{ parseObjFile(path, single, 1); });
+    double fastMs   = bestOfMs(runs, [&]{ parseObjFile(path, fast, threads); });
+    unsigned used = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "[Bench] " << path << ": " << ref.vertices.size()/8 << " vertices, " << ref.indices.size()/3 << " triangles\n";
+    std::cout << "[Bench] reference (getline/istringstream): " << refMs << " ms\n";
+    std::cout << "[Bench] mapped tokenizer, 1 thread       : " << singleMs << " ms (" << refMs/singleMs << "x)\n";
+    std::cout << "[Bench] mapped tokenizer, " << used << " threads      : " << fastMs << " ms (" << refMs/fastMs << "x)\n";
+    bool ok = sameMesh(ref, fast) && sameMesh(ref, single);
+    std::cout << "[Bench] outputs " << (ok ? "identical" : "DIFFER") << "\n";
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,195 @@
+// Offline PNG -> DDS converter for loadTexture's precompressed path.
+//
+// Writes BC1 (opaque) or BC3 (with alpha) with a full box-filtered mip chain, rows stored
+// bottom-up like stb's flipped PNG loads, so UVs match the PNG path. Place the output next to the
+// PNG with the same name (Models/fountain.png -> Models/fountain.dds) and loadTexture uses it.
+// BC7 is read by the loader too (DDS DX10 or KTX2); produce it with an external encoder and a
+// vertical flip (e.g. texconv -f BC7_UNORM -vflip).
+//
+// Build (needs stb_image.h on the include path, no GL libraries):
+//   g++ -std=c++17 -O2 -I. tools/texture_compress.cpp -o texture_compress
+// Usage:
+//   ./texture_compress input.png output.dds [--bc1|--bc3]
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__has_include) && __has_include("stb_image.h")
+#  define STB_IMAGE_IMPLEMENTATION
+#  include "stb_image.h"
+#else
+#  error "texture_compress needs stb_image.h on the include path"
+#endif
+
+namespace {
+struct Image { int width = 0, height = 0; std::vector<unsigned char> rgba; };
+
+// 2x2 box filter; odd edges reuse the last row/column
+Image downsample(const Image& src) {
+    Image dst;
+    dst.width = std::max(1, src.width / 2);
+    dst.height = std::max(1, src.height / 2);
+    dst.rgba.resize((size_t)dst.width * dst.height * 4);
+    for (int y = 0; y < dst.height; ++y) {
+        for (int x = 0; x < dst.width; ++x) {
+            int x0 = std::min(src.width - 1, x * 2), x1 = std::min(src.width - 1, x * 2 + 1);
+            int y0 = std::min(src.height - 1, y * 2), y1 = std::min(src.height - 1, y * 2 + 1);
+            for (int c = 0; c < 4; ++c) {
+                int sum = src.rgba[((size_t)y0 * src.width + x0) * 4 + c] + src.rgba[((size_t)y0 * src.width + x1) * 4 + c]
+                        + src.rgba[((size_t)y1 * src.width + x0) * 4 + c] + src.rgba[((size_t)y1 * src.width + x1) * 4 + c];
+                dst.rgba[((size_t)y * dst.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+uint16_t to565(const int c[3]) {
+    return (uint16_t)(((c[0] * 31 + 127) / 255) << 11 | ((c[1] * 63 + 127) / 255) << 5 | ((c[2] * 31 + 127) / 255));
+}
+
+void from565(uint16_t v, int out[3]) {
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 colour block: bounding-box endpoints inset by 1/16 of the range, nearest of four colours
+void encodeColorBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    int lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c) { lo[c] = std::min(lo[c], (int)block[i][c]); hi[c] = std::max(hi[c], (int)block[i][c]); }
+    for (int c = 0; c < 3; ++c) {
+        int inset = (hi[c] - lo[c]) / 16;
+        lo[c] += inset;
+        hi[c] -= inset;
+    }
+    uint16_t c0 = to565(hi), c1 = to565(lo);
+    uint32_t indices = 0;
+    if (c0 < c1) std::swap(c0, c1);
+    if (c0 != c1) {
+        // Four-colour mode (c0 > c1): c2 = (2*c0 + c1) / 3, c3 = (c0 + 2*c1) / 3
+        int pal[4][3];
+        from565(c0, pal[0]);
+        from565(c1, pal[1]);
+        for (int c = 0; c < 3; ++c) {
+            pal[2][c] = (2 * pal[0][c] + pal[1][c]) / 3;
+            pal[3][c] = (pal[0][c] + 2 * pal[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int k = 0; k < 4; ++k) {
+                int d = 0;
+                for (int c = 0; c < 3; ++c) { int e = block[i][c] - pal[k][c]; d += e * e; }
+                if (d < bestDist) { bestDist = d; best = k; }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+    }
+    out[0] = (unsigned char)(c0 & 0xFF); out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF); out[3] = (unsigned char)(c1 >> 8);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// BC3 alpha block: a0 = max, a1 = min (eight-value mode), 3-bit nearest indices
+void encodeAlphaBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) { a0 = std::max(a0, (int)block[i][3]); a1 = std::min(a1, (int)block[i][3]); }
+    uint64_t bits = 0;
+    if (a0 != a1) {
+        int pal[8] = { a0, a1 };
+        for (int k = 1; k < 7; ++k) pal[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int k = 0; k < 8; ++k) {
+                int d = std::abs(block[i][3] - pal[k]);
+                if (d < bestDist) { bestDist = d; best = k; }
+            }
+            bits |= (uint64_t)best << (3 * i);
+        }
+    }
+    out[0] = (unsigned char)a0;
+    out[1] = (unsigned char)a1;
+    for (int b = 0; b < 6; ++b) out[2 + b] = (unsigned char)(bits >> (8 * b));
+}
+
+void compressLevel(const Image& img, bool withAlpha, std::vector<unsigned char>& out) {
+    for (int by = 0; by < img.height; by += 4) {
+        for (int bx = 0; bx < img.width; bx += 4) {
+            unsigned char block[16][4];
+            for (int i = 0; i < 16; ++i) {
+                int x = std::min(img.width - 1, bx + (i & 3)), y = std::min(img.height - 1, by + (i >> 2));
+                std::memcpy(block[i], &img.rgba[((size_t)y * img.width + x) * 4], 4);
+            }
+            unsigned char bytes[16];
+            if (withAlpha) {
+                encodeAlphaBlock(block, bytes);
+                encodeColorBlock(block, bytes + 8);
+                out.insert(out.end(), bytes, bytes + 16);
+            } else {
+                encodeColorBlock(block, bytes);
+                out.insert(out.end(), bytes, bytes + 8);
+            }
+        }
+    }
+}
+
+void putU32(std::vector<unsigned char>& v, size_t at, uint32_t x) { std::memcpy(&v[at], &x, 4); }
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Usage: texture_compress input.png output.dds [--bc1|--bc3]\n";
+        return 1;
+    }
+    std::string mode = argc > 3 ? argv[3] : "";
+
+    Image img;
+    int channels = 0;
+    stbi_set_flip_vertically_on_load(true); // same row order as loadTexture's PNG path
+    unsigned char* pixels = stbi_load(argv[1], &img.width, &img.height, &channels, 4);
+    if (!pixels) {
+        std::cout << "Could not load " << argv[1] << "\n";
+        return 1;
+    }
+    img.rgba.assign(pixels, pixels + (size_t)img.width * img.height * 4);
+    stbi_image_free(pixels);
+
+    bool hasAlpha = false;
+    for (size_t i = 3; i < img.rgba.size(); i += 4) if (img.rgba[i] != 255) { hasAlpha = true; break; }
+    bool bc3 = (mode == "--bc3") || (mode != "--bc1" && hasAlpha);
+
+    std::vector<unsigned char> file(128, 0);
+    std::memcpy(&file[0], "DDS ", 4);
+    int levels = 0;
+    for (Image level = img;; level = downsample(level)) {
+        compressLevel(level, bc3, file);
+        levels++;
+        if (level.width == 1 && level.height == 1) break;
+    }
+    // DDS_HEADER: caps | height | width | pixel format | mipmap count | linear size
+    putU32(file, 4, 124);
+    putU32(file, 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000);
+    putU32(file, 12, (uint32_t)img.height);
+    putU32(file, 16, (uint32_t)img.width);
+    putU32(file, 20, (uint32_t)(std::max(1, (img.width + 3) / 4) * std::max(1, (img.height + 3) / 4) * (bc3 ? 16 : 8)));
+    putU32(file, 28, (uint32_t)levels);
+    putU32(file, 76, 32);
+    putU32(file, 80, 0x4); // DDPF_FOURCC
+    std::memcpy(&file[84], bc3 ? "DXT5" : "DXT1", 4);
+    putU32(file, 108, 0x1000 | 0x8 | 0x400000); // texture | complex | mipmap
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out.write((const char*)file.data(), (std::streamsize)file.size())) {
+        std::cout << "Could not write " << argv[2] << "\n";
+        return 1;
+    }
+    std::cout << argv[1] << " (" << img.width << "x" << img.height << ") -> " << argv[2] << ": " << (bc3 ? "BC3" : "BC1")
+              << ", " << levels << " mips, " << file.size() << " bytes\n";
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Tree constraint benchmark: times the per-tree glm loop the main loop used to run against the
+// structure-of-arrays SSE kernel in tree_store.cpp (one thread and split across threads) on a
+// synthetic forest, and checks that both move the trees to the same place.
+//
+// Build (from the project root, no GL libraries needed):
+//   g++ -std=c++17 -O2 -I. tools/tree_bench.cpp tree_store.cpp -o tree_bench -pthread
+// Run:
+//   ./tree_bench [trees] [runs] [threads]
+
+#include "tree_store.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+template <typename F>
+static double bestOfMs(int runs, F&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+// Trees scattered over a disc well past the hedges, with margins as the layout stores them
+static TreeStore makeForest(size_t n, float hedgeOuter, float fountainFoot) {
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f), radius(0.5f, 60.0f);
+    TreeStore t;
+    t.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        float a = angle(rng), r = radius(rng);
+        t.add(r * std::cos(a), r * std::sin(a), (uint8_t)(i % 3),
+              std::max(0.0f, r - hedgeOuter), std::max(0.0f, r - fountainFoot));
+    }
+    return t;
+}
+
+static float maxDifference(const TreeStore& a, const TreeStore& b) {
+    float d = 0.0f;
+    for (size_t i = 0; i < a.count(); ++i)
+        d = std::max(d, std::max(std::fabs(a.x[i] - b.x[i]), std::fabs(a.z[i] - b.z[i])));
+    return d;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)std::max(1, std::atoi(argv[1])) : 100000;
+    int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+    unsigned threads = argc > 3 ? (unsigned)std::max(0, std::atoi(argv[3])) : 0;
+    unsigned used = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // K/L step: every tree keeps its fountain gap and hedge margin, so every tree moves
+    RadialConstraint scale;
+    scale.hedgeOuter = 3.8f * 0.8f * 1.01f;
+    scale.fountainFoot = 0.5f * 1.01f * 1.1f;
+    scale.minRadius = 1e-5f;
+    // Hedge guard at rest: a push-out scan in which no tree is inside the floor any more
+    RadialConstraint guard;
+    guard.floorR = 3.8f * 0.8f + 0.15f;
+    guard.hedgeOuter = 3.8f * 0.8f;
+    guard.onlyInsideFloor = true;
+
+    TreeStore base = makeForest(n, 3.8f * 0.8f, 0.5f * 1.1f);
+    TreeStore ref = base, single = base, par = base;
+    double refScale = bestOfMs(runs, [&]{ applyRadialConstraintReference(ref, scale); });
+    double singleScale = bestOfMs(runs, [&]{ applyRadialConstraint(single, scale, 1); });
+    double parScale = bestOfMs(runs, [&]{ applyRadialConstraint(par, scale, threads); });
+    float scaleDiff = std::max(maxDifference(ref, single), maxDifference(ref, par));
+
+    double refGuard = bestOfMs(runs, [&]{ applyRadialConstraintReference(ref, guard); });
+    double singleGuard = bestOfMs(runs, [&]{ applyRadialConstraint(single, guard, 1); });
+    double parGuard = bestOfMs(runs, [&]{ applyRadialConstraint(par, guard, threads); });
+    float guardDiff = std::max(maxDifference(ref, single), maxDifference(ref, par));
+
+    std::vector<unsigned int> all(n);
+    for (size_t i = 0; i < n; ++i) all[i] = (unsigned int)i;
+    std::vector<float> packed(n * 4);
+    const float sizeBase[3] = { 0.9f, 1.2f, 1.7f };
+    double packMs = bestOfMs(runs, [&]{ packTreeInstances(single, all.data(), n, sizeBase, packed.data()); });
+
+    std::cout << "[Bench] " << n << " trees, best of " << runs << " runs\n";
+    std::cout << "[Bench] scale step, reference (glm per tree): " << refScale << " ms\n";
+    std::cout << "[Bench] scale step, SoA SSE, 1 thread       : " << singleScale << " ms (" << refScale / singleScale << "x)\n";
+    std::cout << "[Bench] scale step, SoA SSE, " << used << " threads      : " << parScale << " ms (" << refScale / parScale << "x)\n";
+    std::cout << "[Bench] guard scan, reference (glm per tree): " << refGuard << " ms\n";
+    std::cout << "[Bench] guard scan, SoA SSE, 1 thread       : " << singleGuard << " ms (" << refGuard / singleGuard << "x)\n";
+    std::cout << "[Bench] guard scan, SoA SSE, " << used << " threads      : " << parGuard << " ms (" << refGuard / parGuard << "x)\n";
+    std::cout << "[Bench] instance pack (x, z, size base, 0)  : " << packMs << " ms\n";
+    // The kernel scales by target / r instead of normalising first: a few ulps apart, no more
+    bool ok = scaleDiff < 1e-4f && guardDiff < 1e-4f;
+    std::cout << "[Bench] positions " << (ok ? "match" : "DIFFER") << " (max difference " << std::max(scaleDiff, guardDiff) << ")\n";
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,112 @@
+#include "tree_store.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define TREE_STORE_SSE 1
+#  include <emmintrin.h>
+#endif
+
+void TreeStore::clear() {
+    x.clear(); z.clear(); size.clear(); outerMargin.clear(); fountainGap.clear();
+}
+
+void TreeStore::reserve(size_t n) {
+    x.reserve(n); z.reserve(n); size.reserve(n); outerMargin.reserve(n); fountainGap.reserve(n);
+}
+
+void TreeStore::add(float wx, float wz, uint8_t sz, float margin, float gap) {
+    x.push_back(wx); z.push_back(wz); size.push_back(sz);
+    outerMargin.push_back(margin); fountainGap.push_back(gap);
+}
+
+namespace {
+// Trees [begin, end); returns how many were moved
+size_t radialRange(TreeStore& t, const RadialConstraint& c, size_t begin, size_t end) {
+    float* xs = t.x.data();
+    float* zs = t.z.data();
+    const float* margin = t.outerMargin.data();
+    const float* gap = t.fountainGap.data();
+    size_t moved = 0;
+    size_t i = begin;
+#ifdef TREE_STORE_SSE
+    const __m128 floorR = _mm_set1_ps(c.floorR), hedge = _mm_set1_ps(c.hedgeOuter);
+    const __m128 foot = _mm_set1_ps(c.fountainFoot), minR = _mm_set1_ps(c.minRadius);
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i), z = _mm_loadu_ps(zs + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)));
+        __m128 mask = _mm_cmpgt_ps(r, minR);
+        if (c.onlyInsideFloor) mask = _mm_and_ps(mask, _mm_cmplt_ps(r, floorR));
+        int bits = _mm_movemask_ps(mask);
+        if (!bits) continue;
+        __m128 target = _mm_max_ps(floorR, _mm_max_ps(_mm_add_ps(hedge, _mm_loadu_ps(margin + i)),
+                                                      _mm_add_ps(foot, _mm_loadu_ps(gap + i))));
+        // Lanes at r ~ 0 divide by zero here; the mask keeps their old position
+        __m128 scale = _mm_div_ps(target, r);
+        _mm_storeu_ps(xs + i, _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(x, scale)), _mm_andnot_ps(mask, x)));
+        _mm_storeu_ps(zs + i, _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(z, scale)), _mm_andnot_ps(mask, z)));
+        moved += (size_t)((bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1));
+    }
+#endif
+    for (; i < end; ++i) {
+        float r = std::sqrt(xs[i] * xs[i] + zs[i] * zs[i]);
+        if (!(r > c.minRadius) || (c.onlyInsideFloor && !(r < c.floorR))) continue;
+        float target = std::max(c.floorR, std::max(c.hedgeOuter + margin[i], c.fountainFoot + gap[i]));
+        float scale = target / r;
+        xs[i] *= scale;
+        zs[i] *= scale;
+        moved++;
+    }
+    return moved;
+}
+} // namespace
+
+size_t applyRadialConstraint(TreeStore& trees, const RadialConstraint& c, unsigned threadCount) {
+    size_t n = trees.count();
+    unsigned workers = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    if (n < kParallelTrees || workers <= 1) return radialRange(trees, c, 0, n);
+
+    // Chunks of a multiple of 4 trees, so only the last one has a scalar tail
+    const size_t chunk = 16384;
+    size_t chunkCount = (n + chunk - 1) / chunk;
+    std::atomic<size_t> nextChunk{0}, moved{0};
+    auto worker = [&] {
+        for (size_t k; (k = nextChunk.fetch_add(1)) < chunkCount;)
+            moved += radialRange(trees, c, k * chunk, std::min(n, (k + 1) * chunk));
+    };
+    std::vector<std::thread> pool;
+    unsigned extra = (unsigned)std::min<size_t>(workers, chunkCount) - 1;
+    for (unsigned t = 0; t < extra; ++t) pool.emplace_back(worker);
+    worker(); // the calling thread takes chunks too
+    for (std::thread& t : pool) t.join();
+    return moved;
+}
+
+size_t applyRadialConstraintReference(TreeStore& trees, const RadialConstraint& c) {
+    size_t moved = 0;
+    for (size_t i = 0; i < trees.count(); ++i) {
+        glm::vec2 p = trees.pos(i);
+        float r = glm::length(p);
+        if (!(r > c.minRadius) || (c.onlyInsideFloor && !(r < c.floorR))) continue;
+        float desiredR = std::max(c.floorR, std::max(c.hedgeOuter + trees.outerMargin[i], c.fountainFoot + trees.fountainGap[i]));
+        glm::vec2 dir = p / r;
+        p = dir * desiredR;
+        trees.x[i] = p.x;
+        trees.z[i] = p.y;
+        moved++;
+    }
+    return moved;
+}
+
+void packTreeInstances(const TreeStore& trees, const unsigned int* indices, size_t count,
+                       const float sizeBase[3], float* dst) {
+    for (size_t k = 0; k < count; ++k, dst += 4) {
+        unsigned int i = indices[k];
+        dst[0] = trees.x[i];
+        dst[1] = trees.z[i];
+        dst[2] = sizeBase[std::min<uint8_t>(trees.size[i], 2)];
+        dst[3] = 0.0f;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+// ---------------- Tree store ----------------
+// The authored trees as a structure of arrays. Culling, LOD selection and the instance upload read
+// x/z/size only. The radial constraints below read and write x/z/outerMargin/fountainGap for
+// every tree while a scale key is held (and the hedge guard checks every tree each frame), four
+// trees per SSE register.
+struct TreeStore {
+    std::vector<float> x, z;          // world XZ
+    std::vector<uint8_t> size;        // TreeSize
+    std::vector<float> outerMargin;   // r - outer hedge radius, kept when the hedges scale
+    std::vector<float> fountainGap;   // r - fountain footprint, kept when the fountain scales
+
+    size_t count() const { return x.size(); }
+    glm::vec2 pos(size_t i) const { return glm::vec2(x[i], z[i]); }
+    void clear();
+    void reserve(size_t n);
+    void add(float wx, float wz, uint8_t sz, float margin, float gap);
+};
+
+// Moves trees along their direction from the fountain (the origin) to radius
+//   max(floorR, hedgeOuter + outerMargin[i], fountainFoot + fountainGap[i])
+// A bound at -infinity takes no part.
+struct RadialConstraint {
+    float floorR = 0.0f;
+    float hedgeOuter = -std::numeric_limits<float>::infinity();
+    float fountainFoot = -std::numeric_limits<float>::infinity();
+    bool onlyInsideFloor = false; // move only trees with r < floorR (push-out), else every tree
+    float minRadius = 1e-4f;      // closer to the centre there is no direction; such trees stay
+};
+
+// Stores at least this large are split across threads; below, thread start-up costs more than
+// the kernel (see tools/tree_bench.cpp)
+const size_t kParallelTrees = 65536;
+
+// Returns how many trees the constraint applied to. threadCount 0 picks hardware_concurrency.
+size_t applyRadialConstraint(TreeStore& trees, const RadialConstraint& c, unsigned threadCount = 0);
+// One tree at a time with glm, as the main loop used to; for tools/tree_bench.cpp
+size_t applyRadialConstraintReference(TreeStore& trees, const RadialConstraint& c);
+
+// Instanced tree records (x, z, size base, 0) for trees[indices[0..count)], written to dst
+void packTreeInstances(const TreeStore& trees, const unsigned int* indices, size_t count,
+                       const float sizeBase[3], float* dst);
@@ -0,0 +1,104 @@
+#include "uniform_blocks.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+GLuint frameUBO = 0, materialUBO = 0;
+std::vector<MaterialUniforms> materials;
+std::vector<int> layerMaterials;   // textureLayer + 1 -> material index (-1 = none)
+GLsizeiptr materialStride = 0;     // sizeof(MaterialUniforms) rounded up to the offset alignment
+GLsizeiptr frameStride = 0;        // sizeof(FrameUniforms), likewise
+int boundMaterial = -1;
+int boundFrameSlot = -1;
+
+// glBindBufferRange offsets must be multiples of the driver's alignment (often 256 bytes)
+GLsizeiptr alignedStride(size_t bytes) {
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    alignment = std::max(alignment, 1);
+    return ((GLsizeiptr)bytes + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+void initUniformBlocks() {
+    frameStride = alignedStride(sizeof(FrameUniforms));
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, frameStride * kFrameSlots, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    boundFrameSlot = -1;
+    bindFrameUniforms(0);
+    glGenBuffers(1, &materialUBO);
+}
+
+void destroyUniformBlocks() {
+    GLuint buffers[2] = { frameUBO, materialUBO };
+    glDeleteBuffers(2, buffers);
+    frameUBO = materialUBO = 0;
+    materials.clear();
+    layerMaterials.clear();
+    boundMaterial = -1;
+    boundFrameSlot = -1;
+}
+
+void bindUniformBlocks(GLuint program) {
+    if (!program) return;
+    GLuint frame = glGetUniformBlockIndex(program, "FrameBlock");
+    if (frame != GL_INVALID_INDEX) glUniformBlockBinding(program, frame, kFrameBlockBinding);
+    GLuint material = glGetUniformBlockIndex(program, "MaterialBlock");
+    if (material != GL_INVALID_INDEX) glUniformBlockBinding(program, material, kMaterialBlockBinding);
+}
+
+void updateFrameUniforms(const FrameUniforms& frame, int slot) {
+    if (slot < 0 || slot >= kFrameSlots) return;
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr)slot * frameStride, sizeof(FrameUniforms), &frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    profileUniformUploads++;
+}
+
+void bindFrameUniforms(int slot) {
+    if (slot < 0 || slot >= kFrameSlots || slot == boundFrameSlot) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, kFrameBlockBinding, frameUBO, (GLintptr)slot * frameStride, sizeof(FrameUniforms));
+    boundFrameSlot = slot;
+    profileUniformUploads++;
+}
+
+int addMaterial(const MaterialUniforms& material) {
+    int index = (int)materials.size();
+    materials.push_back(material);
+    if (!material.solidMode && material.textureLayer >= -1) {
+        size_t slot = (size_t)(material.textureLayer + 1);
+        if (layerMaterials.size() <= slot) layerMaterials.resize(slot + 1, -1);
+        if (layerMaterials[slot] < 0) layerMaterials[slot] = index;
+    }
+    return index;
+}
+
+int textureMaterial(int textureLayer) {
+    size_t slot = (size_t)(textureLayer + 1);
+    return textureLayer >= -1 && slot < layerMaterials.size() ? layerMaterials[slot] : -1;
+}
+
+void uploadMaterials() {
+    materialStride = alignedStride(sizeof(MaterialUniforms));
+    std::vector<unsigned char> bytes((size_t)materialStride * materials.size(), 0);
+    for (size_t i = 0; i < materials.size(); ++i)
+        std::memcpy(bytes.data() + i * (size_t)materialStride, &materials[i], sizeof(MaterialUniforms));
+    glBindBuffer(GL_UNIFORM_BUFFER, materialUBO);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)bytes.size(), bytes.empty() ? nullptr : bytes.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    boundMaterial = -1;
+    std::cout << "[Info] Material block: " << materials.size() << " materials, " << materialStride << " bytes apart\n";
+}
+
+void bindMaterial(int material) {
+    if (material < 0 || material >= (int)materials.size() || material == boundMaterial) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, kMaterialBlockBinding, materialUBO,
+                      (GLintptr)material * materialStride, sizeof(MaterialUniforms));
+    boundMaterial = material;
+    profileUniformUploads++;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// ---------------- Uniform blocks ----------------
+// State shared by every scene program lives in two std140 uniform buffers instead of per-program
+// uniforms (GL keeps those per program, so each one had to be re-sent to every program):
+// - FrameBlock (binding kFrameBlockBinding): camera, light, fog, impostor fade and the shadow
+//   cascades. Written once per frame with one glBufferSubData (updateFrameUniforms). The buffer has
+//   kFrameSlots copies at aligned offsets: slot 0 is the camera, the others extra views of the same
+//   frame (the shadow cascades' light views), and bindFrameUniforms() re-points the binding.
+// - MaterialBlock (binding kMaterialBlockBinding): solid colour / texture layer. Every material is
+//   written once at startup into one buffer; bindMaterial() switches by re-pointing the binding at
+//   that material's range, so textured <-> solid changes cost no uniform calls.
+// The GLSL declarations are repeated in each shader that reads them (forest.vert, ring.vert,
+// scene_batch.vert, impostor.vert, firefly.vert, fragment_shader.glsl) and must match the structs
+// below. createShaderProgram assigns the binding points (GLSL 3.30 has no layout(binding)).
+const GLuint kFrameBlockBinding = 0;
+const GLuint kMaterialBlockBinding = 1;
+const int kFrameSlots = 4; // camera + one per shadow cascade (shadow_map.h)
+
+// std140 FrameBlock; each vec3 is padded to 16 bytes by the float after it
+struct FrameUniforms {
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::vec3 viewPos = glm::vec3(0.0f);
+    float time = 0.0f;          // firefly animation clock
+    glm::vec3 lightDir = glm::vec3(0.0f, -1.0f, 0.0f);
+    float fogDensity = 0.0f;
+    glm::vec3 lightColor = glm::vec3(1.0f);
+    float pad0 = 0.0f;
+    glm::vec3 fogColor = glm::vec3(0.0f);
+    float pad1 = 0.0f;
+    glm::vec2 lodFade = glm::vec2(0.0f); // impostor crossfade start and 1 / length (+LOD_FADE)
+    float pad2[2] = { 0.0f, 0.0f };
+    glm::mat4 shadowMatrix[3] = { glm::mat4(1.0f), glm::mat4(1.0f), glm::mat4(1.0f) }; // world -> cascade layer
+    // x: cascades in use (0 = no shadows), y/z: fade start / shadow distance, w: 1 / map size
+    glm::vec4 shadowParams = glm::vec4(0.0f);
+    glm::vec4 shadowOffsets = glm::vec4(0.0f); // per cascade: receiver normal offset, world units
+};
+static_assert(offsetof(FrameUniforms, viewPos) == 128 && offsetof(FrameUniforms, lightColor) == 160 &&
+              offsetof(FrameUniforms, lodFade) == 192 && offsetof(FrameUniforms, shadowMatrix) == 208 &&
+              offsetof(FrameUniforms, shadowParams) == 400 && sizeof(FrameUniforms) == 432, "FrameBlock is std140");
+
+// std140 MaterialBlock
+struct MaterialUniforms {
+    glm::vec3 objectColor = glm::vec3(1.0f);
+    GLint solidMode = 0;        // 0 = textured, 1 = solid objectColor
+    GLint textureLayer = -1;    // scene texture array layer, -1 = texture_diffuse1
+    GLint pad[3] = { 0, 0, 0 };
+};
+static_assert(offsetof(MaterialUniforms, textureLayer) == 16 && sizeof(MaterialUniforms) == 32, "MaterialBlock is std140");
+
+// Needs a current GL context; creates both buffers and binds the frame block
+void initUniformBlocks();
+void destroyUniformBlocks();
+// Sets FrameBlock / MaterialBlock to their binding points in program (blocks it lacks are skipped)
+void bindUniformBlocks(GLuint program);
+
+// Writes one slot; the bound slot is unchanged (0 unless bindFrameUniforms moved it)
+void updateFrameUniforms(const FrameUniforms& frame, int slot = 0);
+// Points FrameBlock at slot; skipped when it is already bound
+void bindFrameUniforms(int slot);
+
+// Material table: add every material, then uploadMaterials() once. Returns the material's index.
+int addMaterial(const MaterialUniforms& material);
+// Textured material sampling textureLayer (-1 = texture_diffuse1); -1 if none was added
+int textureMaterial(int textureLayer);
+void uploadMaterials();
+// Binds one material's range; skipped when it is already bound
+void bindMaterial(int material);
@@ -0,0 +1,79 @@
+#include "vertex_format.h"
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+VertexFormat meshVertexFormat;
+
+GLsizei VertexFormat::stride() const {
+    return (GLsizei)(uvOffset() + (halfUVs ? 2 * sizeof(uint16_t) : 2 * sizeof(float)));
+}
+
+size_t VertexFormat::normalOffset() const {
+    return halfPositions ? 4 * sizeof(uint16_t) : 3 * sizeof(float);
+}
+
+size_t VertexFormat::uvOffset() const {
+    return normalOffset() + (packedNormals ? sizeof(uint32_t) : 3 * sizeof(float));
+}
+
+const char* VertexFormat::name() const {
+    if (!halfPositions && !packedNormals && !halfUVs) return "full";
+    if (!halfPositions && packedNormals && halfUVs) return "compact";
+    if (halfPositions && packedNormals && halfUVs) return "half";
+    return "custom";
+}
+
+bool parseVertexFormat(const std::string& name, VertexFormat& out) {
+    if (name == "full")    { out = VertexFormat{ false, false, false }; return true; }
+    if (name == "compact") { out = VertexFormat{ false, true, true };   return true; }
+    if (name == "half")    { out = VertexFormat{ true, true, true };    return true; }
+    return false;
+}
+
+std::vector<unsigned char> encodeVertices(const float* vertices, size_t vertexCount, const VertexFormat& fmt) {
+    size_t stride = (size_t)fmt.stride();
+    std::vector<unsigned char> out(vertexCount * stride);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* v = vertices + i * 8;
+        unsigned char* dst = out.data() + i * stride;
+        if (fmt.halfPositions) {
+            uint16_t p[4] = { glm::packHalf1x16(v[0]), glm::packHalf1x16(v[1]), glm::packHalf1x16(v[2]), glm::packHalf1x16(1.0f) };
+            std::memcpy(dst, p, sizeof(p));
+        } else {
+            std::memcpy(dst, v, 3 * sizeof(float));
+        }
+        if (fmt.packedNormals) {
+            uint32_t n = glm::packSnorm3x10_1x2(glm::vec4(v[3], v[4], v[5], 0.0f));
+            std::memcpy(dst + fmt.normalOffset(), &n, sizeof(n));
+        } else {
+            std::memcpy(dst + fmt.normalOffset(), v + 3, 3 * sizeof(float));
+        }
+        if (fmt.halfUVs) {
+            uint32_t uv = glm::packHalf2x16(glm::vec2(v[6], v[7]));
+            std::memcpy(dst + fmt.uvOffset(), &uv, sizeof(uv));
+        } else {
+            std::memcpy(dst + fmt.uvOffset(), v + 6, 2 * sizeof(float));
+        }
+    }
+    return out;
+}
+
+void applyVertexFormat(const VertexFormat& fmt) {
+    GLsizei stride = fmt.stride();
+    if (fmt.halfPositions) glVertexAttribPointer(0, 4, GL_HALF_FLOAT, GL_FALSE, stride, (void*)0);
+    else                   glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    if (fmt.packedNormals) glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)fmt.normalOffset());
+    else                   glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)fmt.normalOffset());
+    glEnableVertexAttribArray(1);
+    if (fmt.halfUVs) glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)fmt.uvOffset());
+    else             glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)fmt.uvOffset());
+    glEnableVertexAttribArray(2);
+}
+
+void uploadVertices(const float* vertices, size_t vertexCount, GLenum usage) {
+    std::vector<unsigned char> bytes = encodeVertices(vertices, vertexCount);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)bytes.size(), bytes.empty() ? nullptr : bytes.data(), usage);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+// ---------------- Vertex format ----------------
+// Meshes are still built as interleaved pos(3)/normal(3)/uv(2) floats; uploads convert them into
+// meshVertexFormat and set attributes 0-2 from the same descriptor, so every VAO (and the static
+// scene batch arena) agrees on one layout.
+//   full    : float3 pos, float3 normal, float2 uv               32 bytes
+//   compact : float3 pos, 2_10_10_10 normal, half2 uv            20 bytes
+//   half    : half4 pos (w = 1), 2_10_10_10 normal, half2 uv     16 bytes (default)
+// Half positions keep ~3 significant digits: ~0.004 units at the fountain's +-5.6 extent, ~0.016
+// at the ground's +-20 corners. Shaders are unchanged (normalized / half attributes read as float).
+struct VertexFormat {
+    bool halfPositions = true;  // 4 halves (padding keeps the normal 4-byte aligned)
+    bool packedNormals = true;  // GL_INT_2_10_10_10_REV, normalized
+    bool halfUVs = true;
+
+    GLsizei stride() const;
+    size_t normalOffset() const;
+    size_t uvOffset() const;
+    const char* name() const; // "full", "compact", "half" or "custom"
+};
+
+// Layout used by every mesh upload; choose before any mesh is created
+extern VertexFormat meshVertexFormat;
+bool parseVertexFormat(const std::string& name, VertexFormat& out);
+
+// Converts vertexCount interleaved 8-float vertices into fmt's layout (fmt.stride() bytes each)
+std::vector<unsigned char> encodeVertices(const float* vertices, size_t vertexCount, const VertexFormat& fmt = meshVertexFormat);
+// Attributes 0 (pos), 1 (normal), 2 (uv) for the bound VAO from the bound GL_ARRAY_BUFFER
+void applyVertexFormat(const VertexFormat& fmt = meshVertexFormat);
+// glBufferData of the encoded vertices into the bound GL_ARRAY_BUFFER
+void uploadVertices(const float* vertices, size_t vertexCount, GLenum usage);
@@ -0,0 +1,311 @@
+#include "world_chunks.h"
+#include "bresenham.h"
+#include "gl_state.h"
+#include "occupancy_grid.h"
+#include "vertex_format.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+// splitmix64 finaliser: hashes and the chunk RNG are plain integer arithmetic, so a chunk is
+// generated bit-identically on every platform (unlike <random> distributions)
+uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+enum : uint32_t { SALT_CHUNK = 1, SALT_EDGE_X = 2, SALT_EDGE_Z = 3 };
+
+uint64_t hashCoord(uint32_t seed, int x, int z, uint32_t salt) {
+    uint64_t h = mix64(((uint64_t)seed << 32) | salt);
+    h = mix64(h ^ (uint64_t)(uint32_t)x);
+    return mix64(h ^ ((uint64_t)(uint32_t)z << 32));
+}
+
+struct ChunkRng {
+    uint64_t state;
+    uint32_t next() { state = mix64(state); return (uint32_t)(state >> 32); }
+    float unit() { return (float)(next() >> 8) * (1.0f / 16777216.0f); } // [0, 1)
+    int range(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+};
+
+// Shifted unsigned: shifting a negative cx is undefined before C++20
+int64_t chunkKey(glm::ivec2 c) {
+    return (int64_t)(((uint64_t)(uint32_t)c.x << 32) | (uint32_t)c.y);
+}
+
+inline int cellIndex(int i, int j) { return j * kChunkCells + i; }
+
+// Entirely inside the authored design square: nothing to generate
+bool chunkEmpty(const ChunkedWorld& w, glm::ivec2 c) {
+    float W = w.chunkWorld(), h = w.authoredHalf;
+    return c.x * W >= -h && (c.x + 1) * W <= h && c.y * W >= -h && (c.y + 1) * W <= h;
+}
+
+// Cell offset of the path portal on one chunk edge, or -1. Edges are named by the chunk on their
+// +X / +Z side, so both neighbours hash the same (x, z, axis) and agree on the portal.
+int edgePortal(const ChunkedWorld& w, int x, int z, uint32_t axisSalt) {
+    uint64_t h = hashCoord(w.seed, x, z, axisSalt);
+    if ((h & 0xff) >= 140) return -1; // ~55% of edges carry a path
+    return 2 + (int)((h >> 8) % (uint64_t)(kChunkCells - 4));
+}
+
+// Nearest distance from p to chunk c's footprint (0 inside)
+float chunkDistance(const ChunkedWorld& w, glm::ivec2 c, const glm::vec2& p) {
+    float W = w.chunkWorld();
+    float dx = std::max({ c.x * W - p.x, 0.0f, p.x - (c.x + 1) * W });
+    float dz = std::max({ c.y * W - p.y, 0.0f, p.y - (c.y + 1) * W });
+    return std::sqrt(dx * dx + dz * dz);
+}
+} // namespace
+
+ChunkData generateChunk(const ChunkedWorld& w, glm::ivec2 coord) {
+    const int N = kChunkCells;
+    ChunkData d;
+    d.coord = coord;
+    d.occupancy.assign((size_t)N * N, 0);
+    if (chunkEmpty(w, coord)) return d;
+
+    float cell = w.cellWorld, W = w.chunkWorld();
+    glm::vec2 origin(coord.x * W, coord.y * W);
+    auto authored = [&](int i, int j) {
+        glm::vec2 c = origin + (glm::vec2((float)i, (float)j) + 0.5f) * cell;
+        return std::fabs(c.x) < w.authoredHalf && std::fabs(c.y) < w.authoredHalf;
+    };
+
+    // Paths: every portal runs to the hub. Diagonal Bresenham steps also mark one side cell so the
+    // ribbon stays edge-connected.
+    ChunkRng rng{ hashCoord(w.seed, coord.x, coord.y, SALT_CHUNK) };
+    glm::ivec2 hub(rng.range(5, N - 6), rng.range(5, N - 6));
+    glm::ivec2 portals[4];
+    int portalCount = 0;
+    int west = chunkEmpty(w, coord + glm::ivec2(-1, 0)) ? -1 : edgePortal(w, coord.x, coord.y, SALT_EDGE_X);
+    int east = chunkEmpty(w, coord + glm::ivec2(1, 0)) ? -1 : edgePortal(w, coord.x + 1, coord.y, SALT_EDGE_X);
+    int south = chunkEmpty(w, coord + glm::ivec2(0, -1)) ? -1 : edgePortal(w, coord.x, coord.y, SALT_EDGE_Z);
+    int north = chunkEmpty(w, coord + glm::ivec2(0, 1)) ? -1 : edgePortal(w, coord.x, coord.y + 1, SALT_EDGE_Z);
+    if (west >= 0)  portals[portalCount++] = glm::ivec2(0, west);
+    if (east >= 0)  portals[portalCount++] = glm::ivec2(N - 1, east);
+    if (south >= 0) portals[portalCount++] = glm::ivec2(south, 0);
+    if (north >= 0) portals[portalCount++] = glm::ivec2(north, N - 1);
+    auto markPath = [&](int i, int j) { if (!authored(i, j)) d.occupancy[cellIndex(i, j)] |= OCC_PATH; };
+    for (int p = 0; p < portalCount; ++p) {
+        glm::ivec2 prev = portals[p];
+        rasterLine(portals[p].x, portals[p].y, hub.x, hub.y, [&](int i, int j) {
+            if (i != prev.x && j != prev.y) markPath(prev.x, j);
+            markPath(i, j);
+            prev = glm::ivec2(i, j);
+        });
+    }
+
+    // One quad per path cell, lifted like the authored path ribbons to avoid z-fighting
+    for (int j = 0; j < N; ++j) {
+        for (int i = 0; i < N; ++i) {
+            if (!(d.occupancy[cellIndex(i, j)] & OCC_PATH)) continue;
+            float x0 = i * cell, x1 = x0 + cell, z0 = j * cell, z1 = z0 + cell, y = 0.002f;
+            unsigned int base = (unsigned int)(d.pathVertices.size() / 8);
+            d.pathVertices.insert(d.pathVertices.end(), {
+                x0, y, z0, 0,1,0, 0.0f, 0.0f,
+                x1, y, z0, 0,1,0, 1.0f, 0.0f,
+                x1, y, z1, 0,1,0, 1.0f, 1.0f,
+                x0, y, z1, 0,1,0, 0.0f, 1.0f });
+            d.pathIndices.insert(d.pathIndices.end(), { base, base+1, base+2, base+2, base+3, base });
+        }
+    }
+
+    // Trees: per-chunk density, none on or next to a path or in the clearing around the hub
+    float density = 0.04f + 0.06f * rng.unit();
+    for (int j = 0; j < N; ++j) {
+        for (int i = 0; i < N; ++i) {
+            if (authored(i, j)) continue;
+            if (std::abs(i - hub.x) <= 2 && std::abs(j - hub.y) <= 2) continue;
+            bool nearPath = false;
+            for (int dj = -1; dj <= 1 && !nearPath; ++dj)
+                for (int di = -1; di <= 1 && !nearPath; ++di) {
+                    int ni = i + di, nj = j + dj;
+                    nearPath = ni >= 0 && nj >= 0 && ni < N && nj < N && (d.occupancy[cellIndex(ni, nj)] & OCC_PATH);
+                }
+            if (nearPath || rng.unit() >= density) continue;
+            float jx = (rng.unit() - 0.5f) * 0.6f, jz = (rng.unit() - 0.5f) * 0.6f;
+            float s = rng.unit();
+            int size = s < 0.25f ? 0 : (s < 0.75f ? 1 : 2);
+            float yaw = rng.unit() * 6.2831853f;
+            d.treeInstances.insert(d.treeInstances.end(), {
+                origin.x + (i + 0.5f + jx) * cell, origin.y + (j + 0.5f + jz) * cell, w.sizeBase[size], yaw });
+        }
+    }
+    return d;
+}
+
+void ChunkedWorld::init(const ChunkTreeMeshes& treeMeshes, float uvPerChunk) {
+    trees = treeMeshes;
+    glGenVertexArrays(1, &groundVAO);
+    glGenBuffers(1, &groundVBO);
+    glGenBuffers(1, &groundEBO);
+    bindVertexArray(groundVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
+    glBufferData(GL_ARRAY_BUFFER, 4 * meshVertexFormat.stride(), nullptr, GL_STATIC_DRAW);
+    unsigned int indices[] = { 0,1,2, 2,3,0 };
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groundEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    applyVertexFormat();
+    bindVertexArray(0);
+    setGroundRepeat(uvPerChunk);
+}
+
+void ChunkedWorld::setGroundRepeat(float uvPerChunk) {
+    if (!groundVBO) return;
+    float W = chunkWorld(), r = uvPerChunk;
+    float vertices[] = {
+        0.0f, 0.0f, 0.0f,  0,1,0,  0.0f, 0.0f,
+        W,    0.0f, 0.0f,  0,1,0,  r,    0.0f,
+        W,    0.0f, W,     0,1,0,  r,    r,
+        0.0f, 0.0f, W,     0,1,0,  0.0f, r
+    };
+    std::vector<unsigned char> encoded = encodeVertices(vertices, 4);
+    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)encoded.size(), encoded.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunkedWorld::upload(ChunkData&& data) {
+    WorldChunk c;
+    c.coord = data.coord;
+    float W = chunkWorld(), gh = groundHalf;
+    c.origin = glm::vec3(data.coord.x * W, 0.0f, data.coord.y * W);
+    float x0 = c.origin.x, z0 = c.origin.z;
+    c.hasGround = !(x0 < gh && x0 + W > -gh && z0 < gh && z0 + W > -gh);
+
+    if (!data.pathIndices.empty()) {
+        glGenVertexArrays(1, &c.pathVAO);
+        glGenBuffers(1, &c.pathVBO);
+        glGenBuffers(1, &c.pathEBO);
+        bindVertexArray(c.pathVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, c.pathVBO);
+        size_t vertexCount = data.pathVertices.size() / 8;
+        uploadVertices(data.pathVertices.data(), vertexCount, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, c.pathEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(data.pathIndices.size() * sizeof(unsigned int)), data.pathIndices.data(), GL_STATIC_DRAW);
+        applyVertexFormat();
+        c.pathIndexCount = (GLsizei)data.pathIndices.size();
+        c.bytes += vertexCount * meshVertexFormat.stride() + data.pathIndices.size() * sizeof(unsigned int);
+    }
+
+    if (!data.treeInstances.empty()) {
+        glGenBuffers(1, &c.instanceVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, c.instanceVBO);
+        GLsizeiptr bytes = (GLsizeiptr)(data.treeInstances.size() * sizeof(float));
+        glBufferData(GL_ARRAY_BUFFER, bytes, data.treeInstances.data(), GL_STATIC_DRAW);
+        // Same attribute layout as createTreeInstanceBuffer: shared part mesh + vec4 per instance
+        GLuint meshVBO[2] = { trees.trunkVBO, trees.coneVBO }, meshEBO[2] = { trees.trunkEBO, trees.coneEBO };
+        GLuint* vaos[2] = { &c.trunkVAO, &c.coneVAO };
+        for (int part = 0; part < 2; ++part) {
+            glGenVertexArrays(1, vaos[part]);
+            bindVertexArray(*vaos[part]);
+            glBindBuffer(GL_ARRAY_BUFFER, meshVBO[part]);
+            applyVertexFormat();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshEBO[part]);
+            glBindBuffer(GL_ARRAY_BUFFER, c.instanceVBO);
+            glVertexAttribPointer(3,4,GL_FLOAT,GL_FALSE,4*sizeof(float),(void*)0); glEnableVertexAttribArray(3);
+            glVertexAttribDivisor(3, 1);
+        }
+        c.treeCount = (GLsizei)(data.treeInstances.size() / 4);
+        c.bytes += (size_t)bytes;
+    }
+    bindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    residentBytes += c.bytes;
+    index[chunkKey(c.coord)] = (int)chunks.size();
+    chunks.push_back(std::move(c));
+    generatedTotal++;
+    residencyRevision++;
+}
+
+void ChunkedWorld::evict(int slot) {
+    WorldChunk& c = chunks[slot];
+    GLuint buffers[3] = { c.pathVBO, c.pathEBO, c.instanceVBO };
+    glDeleteBuffers(3, buffers);
+    GLuint vaos[3] = { c.pathVAO, c.trunkVAO, c.coneVAO };
+    deleteVertexArrays(3, vaos);
+    residentBytes -= c.bytes;
+    index.erase(chunkKey(c.coord));
+    if (slot != (int)chunks.size() - 1) {
+        chunks[slot] = std::move(chunks.back());
+        index[chunkKey(chunks[slot].coord)] = slot;
+    }
+    chunks.pop_back();
+    evictedTotal++;
+    residencyRevision++;
+}
+
+void ChunkedWorld::update(const glm::vec3& cameraPos, float radius) {
+    if (radiusLimit >= 0.0f) radius = std::min(radius, radiusLimit);
+    float W = chunkWorld();
+    glm::vec2 cam(cameraPos.x, cameraPos.z);
+    int reach = (int)std::ceil(radius / W) + 1;
+    glm::ivec2 center((int)std::floor(cam.x / W), (int)std::floor(cam.y / W));
+
+    std::vector<std::pair<float, glm::ivec2>> missing;
+    for (int dz = -reach; dz <= reach; ++dz) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            glm::ivec2 c = center + glm::ivec2(dx, dz);
+            if (chunkEmpty(*this, c) || index.count(chunkKey(c))) continue;
+            float d = chunkDistance(*this, c, cam);
+            if (d <= radius) missing.push_back({ d, c });
+        }
+    }
+    std::sort(missing.begin(), missing.end(), [](const std::pair<float, glm::ivec2>& a, const std::pair<float, glm::ivec2>& b) {
+        return a.first < b.first;
+    });
+    int builds = std::min((int)missing.size(), maxGeneratePerFrame);
+    for (int i = 0; i < builds; ++i) upload(generateChunk(*this, missing[i].second));
+
+    // Over budget: evict farthest first. Chunks out of range go before any in range; needing to
+    // evict one in range means the radius itself does not fit the budget.
+    while (residentBytes > memoryBudget && !chunks.empty()) {
+        int farthest = 0;
+        float farthestDist = -1.0f;
+        for (int i = 0; i < (int)chunks.size(); ++i) {
+            float d = chunkDistance(*this, chunks[i].coord, cam);
+            if (d > farthestDist) { farthest = i; farthestDist = d; }
+        }
+        if (farthestDist <= radius) {
+            if (radiusLimit < 0.0f)
+                std::cout << "[Guard] World chunk budget (" << memoryBudget / 1024 << " KB) full: streaming radius reduced to "
+                          << farthestDist << "\n";
+            radiusLimit = radius = std::max(0.0f, farthestDist - 0.001f);
+        }
+        evict(farthest);
+    }
+}
+
+void ChunkedWorld::clear() {
+    while (!chunks.empty()) evict((int)chunks.size() - 1);
+    radiusLimit = -1.0f;
+}
+
+void ChunkedWorld::destroy() {
+    clear();
+    GLuint buffers[2] = { groundVBO, groundEBO };
+    glDeleteBuffers(2, buffers);
+    if (groundVAO) deleteVertexArrays(1, &groundVAO);
+    groundVAO = groundVBO = groundEBO = 0;
+}
+
+BoundingSphere ChunkedWorld::boundsOf(const WorldChunk& c, float treeHeight, float treeRadius) const {
+    float half = 0.5f * chunkWorld(), halfH = 0.5f * treeHeight;
+    return BoundingSphere{ c.origin + glm::vec3(half, halfH, half), std::sqrt(2.0f * half * half + halfH * halfH) + treeRadius };
+}
+
+void ChunkedWorld::logStats() const {
+    long long trees = 0;
+    for (const WorldChunk& c : chunks) trees += c.treeCount;
+    std::cout << "[Info] World chunks: " << chunks.size() << " resident (" << residentBytes / 1024 << " KB of "
+              << memoryBudget / 1024 << " KB budget), " << trees << " trees; " << generatedTotal << " generated, "
+              << evictedTotal << " evicted so far";
+    if (radiusLimit >= 0.0f) std::cout << "; radius limited to " << radiusLimit << " by the budget";
+    std::cout << "\n";
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "frustum.h"
+
+// ---------------- Chunked world ----------------
+// Procedural forest streamed around the authored design square ([-10,10]^2: fountain, hedges,
+// user paths and trees). The plane is cut into chunks of kChunkCells x kChunkCells design cells;
+// chunk (cx, cz) covers world [cx, cx + 1) x [cz, cz + 1) * chunkWorld(). Everything in a chunk
+// is derived from hashes of (seed, cx, cz) and of its four edges, so an evicted chunk comes back
+// identical and nothing has to be stored. Generation lays the paths out in an occupancy tile
+// (OccupancyBits per design cell; paths are OCC_PATH) and plants trees clear of them; the tile is
+// dropped once the chunk is built. Each chunk owns:
+// - a path ribbon, one quad per path cell. Paths enter through portals on the chunk edges, which
+//   both neighbours derive from the same edge hash, and meet at a hub, so they run on across
+//   chunk borders
+// - a tree instance buffer in the instanced tree layout (x, z, size base, yaw offset), with
+//   trunk/cone VAOs over the shared tree meshes
+// Meshes are chunk-local (drawn with a translation) so half-float positions stay exact far out.
+// Cells inside the authored square stay empty; chunks outside the authored ground quad also
+// draw the shared ground tile.
+const int kChunkCells = 25;
+
+// Deterministic CPU side of a chunk (generateChunk); independent of GL and of other chunks
+struct ChunkData {
+    glm::ivec2 coord;
+    std::vector<uint8_t> occupancy;     // kChunkCells^2, row-major in Z; generation only
+    std::vector<float> pathVertices;    // chunk-local pos(3)/normal(3)/uv(2)
+    std::vector<unsigned int> pathIndices;
+    std::vector<float> treeInstances;   // world x, world z, size base, yaw offset
+};
+
+struct WorldChunk {
+    glm::ivec2 coord;
+    GLuint pathVAO = 0, pathVBO = 0, pathEBO = 0;
+    GLsizei pathIndexCount = 0;
+    GLuint instanceVBO = 0, trunkVAO = 0, coneVAO = 0;
+    GLsizei treeCount = 0;
+    int treeLod = -1;          // tree part LOD for the whole chunk, chosen by the renderer (-1: none yet)
+    bool hasGround = false;    // does not overlap the authored ground quad
+    size_t bytes = 0;          // GPU buffers, counted against the budget
+    glm::vec3 origin;          // world position of local (0, 0, 0)
+};
+
+// Shared tree part meshes the per-chunk VAOs read
+struct ChunkTreeMeshes { GLuint trunkVBO, trunkEBO, coneVBO, coneEBO; };
+
+struct ChunkedWorld {
+    uint32_t seed = 1337;
+    float cellWorld = 0.4f;       // world size of one design cell (20 / designGridW)
+    float authoredHalf = 10.0f;   // design square; no generated content inside
+    float groundHalf = 20.0f;     // authored ground quad; chunks reaching outside it draw a ground tile
+    float sizeBase[3] = { 0.9f, 1.2f, 1.7f }; // treeSizeBase per TreeSize
+    size_t memoryBudget = 8u << 20;
+    int maxGeneratePerFrame = 4;  // chunk builds per update(), nearest first
+
+    std::vector<WorldChunk> chunks; // resident; indices are stable until the next update()
+    size_t residentBytes = 0;
+    int generatedTotal = 0, evictedTotal = 0;
+    unsigned int residencyRevision = 0; // bumped whenever a chunk is built or evicted
+    GLuint groundVAO = 0, groundVBO = 0, groundEBO = 0; // one chunk-sized ground quad
+
+    float chunkWorld() const { return kChunkCells * cellWorld; }
+
+    // Needs a current GL context and the tree meshes; uvPerChunk matches the authored ground tiling
+    void init(const ChunkTreeMeshes& treeMeshes, float uvPerChunk);
+    void setGroundRepeat(float uvPerChunk);
+    // Build missing chunks within radius of cameraPos (at most maxGeneratePerFrame, nearest
+    // first). Over the budget, the farthest chunks are evicted; if the chunks within radius alone
+    // do not fit, the streaming radius shrinks to what does (logged once).
+    void update(const glm::vec3& cameraPos, float radius);
+    void clear();   // evict everything (kept: init state)
+    void destroy();
+    // Ground, paths and trees up to treeHeight, crowns reaching treeRadius past the chunk edge
+    BoundingSphere boundsOf(const WorldChunk& c, float treeHeight, float treeRadius) const;
+    void logStats() const;
+
+private:
+    ChunkTreeMeshes trees{ 0, 0, 0, 0 };
+    std::unordered_map<int64_t, int> index; // chunk key -> chunks[] slot
+    float radiusLimit = -1.0f;              // < 0: no budget limit hit yet
+    void upload(ChunkData&& data);
+    void evict(int slot);
+};
+
+// Pure function of (world settings, coord): the same chunk every time
+ChunkData generateChunk(const ChunkedWorld& world, glm::ivec2 coord);